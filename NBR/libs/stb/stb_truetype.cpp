@@ -0,0 +1,2 @@
+#define STB_TRUETYPE_IMPLEMENTATION 
+#include <imgui/imstb_truetype.h>
@@ -0,0 +1,204 @@
+#include "nbr.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <imgui/imstb_truetype.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nbr { // Start of nbr
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The pixel height every glyph gets baked at.
+const nikola::f32 FONT_BASE_SIZE = 64.0f;
+
+/// The distance in pixels the distance field spreads out around each glyph. 
+/// Glyphs can be scaled up until this range gets thinner than a pixel.
+const nikola::i32 FONT_PADDING = 8;
+
+/// The range of codepoints baked into the atlas (printable ASCII).
+const nikola::i32 FONT_FIRST_CODEPOINT = 32;
+const nikola::i32 FONT_LAST_CODEPOINT  = 126;
+
+/// The width of the atlas, where the glyphs are packed row by row.
+const nikola::u32 FONT_ATLAS_WIDTH = 1024;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static bool check_valid_extension(const nikola::FilePath& ext) {
+  return ext == ".ttf" || ext == ".otf";
+}
+
+static nikola::u8* read_font_file(const nikola::FilePath& path) {
+  nikola::File file;
+  if(!nikola::file_open(&file, path, (nikola::i32)(nikola::FILE_OPEN_READ | nikola::FILE_OPEN_BINARY))) {
+    return nullptr;
+  }
+
+  nikola::sizei size = nikola::file_get_size(file);
+  nikola::u8* data   = (nikola::u8*)nikola::memory_allocate(size);
+  nikola::file_read_bytes(file, data, size);
+
+  nikola::file_close(file);
+  return data;
+}
+
+static nikola::u32 next_power_of_two(nikola::u32 value) {
+  nikola::u32 result = 1;
+  while(result < value) {
+    result <<= 1;
+  }
+
+  return result;
+}
+
+static void bake_kernings(nikola::NBRFont* font, const stbtt_fontinfo& info, const nikola::f32 scale) {
+  nikola::DynamicArray<nikola::NBRKerning> kernings;
+
+  for(nikola::i32 left = FONT_FIRST_CODEPOINT; left <= FONT_LAST_CODEPOINT; left++) {
+    for(nikola::i32 right = FONT_FIRST_CODEPOINT; right <= FONT_LAST_CODEPOINT; right++) {
+      nikola::i32 amount = stbtt_GetCodepointKernAdvance(&info, left, right);
+      if(amount == 0) {
+        continue;
+      }
+
+      kernings.push_back(nikola::NBRKerning{left, right, amount * scale});
+    }
+  }
+
+  font->kernings_count = (nikola::u32)kernings.size();
+  font->kernings       = nullptr;
+
+  // Plenty of fonts have no kerning at all
+  if(kernings.empty()) {
+    return;
+  }
+
+  font->kernings = (nikola::NBRKerning*)nikola::memory_allocate(sizeof(nikola::NBRKerning) * kernings.size());
+  nikola::memory_copy(font->kernings, kernings.data(), sizeof(nikola::NBRKerning) * kernings.size());
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Font loader functions
+
+bool font_loader_load(nikola::NBRFont* font, const nikola::FilePath& path) {
+  if(!check_valid_extension(nikola::filepath_extension(path))) {
+    NIKOLA_LOG_ERROR("Invalid font file at \'%s\'", path.c_str());
+    return false;
+  }
+
+  nikola::u8* data = read_font_file(path);
+  if(!data) {
+    NIKOLA_LOG_ERROR("Could not read font file at \'%s\'", path.c_str());
+    return false;
+  }
+
+  stbtt_fontinfo info;
+  if(!stbtt_InitFont(&info, data, stbtt_GetFontOffsetForIndex(data, 0))) {
+    NIKOLA_LOG_ERROR("Could not parse font file at \'%s\'", path.c_str());
+    nikola::memory_free(data);
+    return false;
+  }
+
+  // Metrics init
+  nikola::f32 scale = stbtt_ScaleForPixelHeight(&info, FONT_BASE_SIZE);
+  
+  nikola::i32 ascent, descent, line_gap;
+  stbtt_GetFontVMetrics(&info, &ascent, &descent, &line_gap);
+
+  font->base_size      = FONT_BASE_SIZE;
+  font->ascent         = ascent * scale;
+  font->descent        = descent * scale;
+  font->line_gap       = line_gap * scale;
+  font->distance_range = (nikola::f32)FONT_PADDING;
+
+  // Render the distance field of every glyph, placing them in rows as they come
+  font->glyphs_count = (nikola::u16)(FONT_LAST_CODEPOINT - FONT_FIRST_CODEPOINT + 1);
+  font->glyphs       = (nikola::NBRGlyph*)nikola::memory_allocate(sizeof(nikola::NBRGlyph) * font->glyphs_count);
+
+  nikola::DynamicArray<nikola::u8*> bitmaps(font->glyphs_count, nullptr);
+  nikola::u32 pen_x = 0, pen_y = 0, row_height = 0;
+
+  // An edge value of 128 with this scale makes the field fade out to 0 right at the padding
+  nikola::f32 pixel_dist_scale = 128.0f / FONT_PADDING;
+
+  for(nikola::sizei i = 0; i < font->glyphs_count; i++) {
+    nikola::NBRGlyph& glyph = font->glyphs[i];
+    glyph.unicode           = FONT_FIRST_CODEPOINT + (nikola::i32)i;
+
+    nikola::i32 advance, left_bearing;
+    stbtt_GetCodepointHMetrics(&info, glyph.unicode, &advance, &left_bearing);
+    glyph.advance_x = advance * scale;
+
+    // Whitespace has no bitmap at all
+    nikola::i32 width = 0, height = 0, offset_x = 0, offset_y = 0;
+    bitmaps[i] = stbtt_GetCodepointSDF(&info, scale, glyph.unicode, FONT_PADDING, 128, pixel_dist_scale, &width, &height, &offset_x, &offset_y);
+
+    // Wrap into a new row, leaving a pixel in between glyphs so they never bleed into each other
+    if((pen_x + width) > FONT_ATLAS_WIDTH) {
+      pen_x      = 0;
+      pen_y     += row_height + 1;
+      row_height = 0;
+    }
+
+    glyph.atlas_x  = (nikola::u16)pen_x;
+    glyph.atlas_y  = (nikola::u16)pen_y;
+    glyph.width    = (nikola::u16)width;
+    glyph.height   = (nikola::u16)height;
+    glyph.offset_x = (nikola::f32)offset_x;
+    glyph.offset_y = (nikola::f32)offset_y;
+
+    pen_x     += width + 1;
+    row_height = (nikola::u32)height > row_height ? (nikola::u32)height : row_height;
+  }
+
+  // Copy each glyph into its place in the atlas
+  font->atlas_width  = FONT_ATLAS_WIDTH;
+  font->atlas_height = next_power_of_two(pen_y + row_height);
+  font->atlas_pixels = (nikola::u8*)nikola::memory_allocate(font->atlas_width * font->atlas_height);
+  nikola::memory_zero(font->atlas_pixels, font->atlas_width * font->atlas_height);
+
+  for(nikola::sizei i = 0; i < font->glyphs_count; i++) {
+    const nikola::NBRGlyph& glyph = font->glyphs[i];
+    if(!bitmaps[i]) {
+      continue;
+    }
+
+    for(nikola::u32 row = 0; row < glyph.height; row++) {
+      nikola::u8* dest = font->atlas_pixels + ((glyph.atlas_y + row) * font->atlas_width) + glyph.atlas_x;
+      nikola::memory_copy(dest, bitmaps[i] + (row * glyph.width), glyph.width);
+    }
+
+    stbtt_FreeSDF(bitmaps[i], nullptr);
+  }
+
+  bake_kernings(font, info, scale);
+
+  nikola::memory_free(data);
+  return true;
+}
+
+void font_loader_unload(nikola::NBRFont& font) {
+  nikola::memory_free(font.glyphs);
+  if(font.kernings) {
+    nikola::memory_free(font.kernings);
+  }
+  nikola::memory_free(font.atlas_pixels);
+}
+
+/// Font loader functions
+/// ----------------------------------------------------------------------
+
+} // End of nbr
+
+//////////////////////////////////////////////////////////////////////////
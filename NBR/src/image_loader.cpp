@@ -60,25 +60,42 @@ static void directory_iterate_func(const nikola::FilePath& base_dir, nikola::Fil
 /// ----------------------------------------------------------------------
 /// Image loader functions
 
-bool image_loader_load_texture(nikola::NBRTexture* texture, const nikola::FilePath& path) {
+bool image_loader_load_texture(nikola::NBRTexture* texture, const nikola::FilePath& path, const nikola::GfxTextureFormat format) {
   if(!check_valid_extension(nikola::filepath_extension(path))) {
     NIKOLA_LOG_ERROR("Invalid image file at \'%s\'", path.c_str());
     return false;
   }
 
   nikola::i32 width, height; 
-  texture->pixels = stbi_load(path.c_str(), &width, &height, NULL, 4);
+  nikola::u8* pixels = stbi_load(path.c_str(), &width, &height, NULL, 4);
 
-  if(!texture->pixels) {
+  if(!pixels) {
     NIKOLA_LOG_ERROR("Could not load texture at %s", stbi_failure_reason());
     return false;
   }
 
-  texture->width    = width;
-  texture->height   = height;
-  texture->channels = 4; // Sadly, sometimes the loader depicts the cubemap faces with 3 components instead of 4, so we have to force it.
+  texture->width     = width;
+  texture->height    = height;
+  texture->channels  = 4; // Sadly, sometimes the loader depicts the cubemap faces with 3 components instead of 4, so we have to force it.
+  texture->format    = nikola::GFX_TEXTURE_FORMAT_RGBA8;
+  texture->mips      = 1;
+  texture->data_size = width * height * texture->channels;
+  texture->pixels    = pixels;
+
+  // Raw pixels are kept as is
+  if(format == nikola::GFX_TEXTURE_FORMAT_RGBA8) {
+    return true;
+  }
 
-  return true;
+  // Otherwise, the pixels get replaced with the compressed blocks of the whole mip chain
+  bool compressed = texture_compressor_compress(texture, pixels, format);
+  stbi_image_free(pixels);
+
+  if(!compressed) {
+    texture->pixels = nullptr;
+  }
+
+  return compressed;
 }
 
 bool image_loader_load_cubemap(nikola::NBRCubemap* cube, const nikola::FilePath& dir) {
@@ -98,6 +115,12 @@ void image_loader_unload_texture(nikola::NBRTexture& texture) {
     return;
   }
   
+  // Compressed blocks are not allocated by the image loader
+  if(texture.format != nikola::GFX_TEXTURE_FORMAT_RGBA8) {
+    nikola::memory_free(texture.pixels);
+    return;
+  }
+  
   stbi_image_free(texture.pixels);
 }
 
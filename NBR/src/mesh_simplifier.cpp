@@ -0,0 +1,344 @@
+#include "nbr.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nbr { // Start of nbr
+
+/// ----------------------------------------------------------------------
+/// Quadric
+struct Quadric {
+  /// The upper half of a symmetric 4x4 matrix:
+  /// xx, xy, xz, xw, yy, yz, yw, zz, zw, ww
+  nikola::f64 m[10] = {};
+};
+/// Quadric
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Collapse
+struct Collapse {
+  nikola::u32 from, to;
+  nikola::f64 cost;
+};
+/// Collapse
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static nikola::Vec3 get_position(const nikola::f32* vertices, const nikola::sizei stride, const nikola::u32 index) {
+  const nikola::f32* pos = vertices + (index * stride);
+  return nikola::Vec3(pos[0], pos[1], pos[2]);
+}
+
+static void quadric_add_plane(Quadric& q, const nikola::Vec3& normal, const nikola::f64 distance, const nikola::f64 weight) {
+  nikola::f64 a = normal.x, b = normal.y, c = normal.z, d = distance;
+
+  q.m[0] += weight * a * a; q.m[1] += weight * a * b; q.m[2] += weight * a * c; q.m[3] += weight * a * d;
+  q.m[4] += weight * b * b; q.m[5] += weight * b * c; q.m[6] += weight * b * d;
+  q.m[7] += weight * c * c; q.m[8] += weight * c * d;
+  q.m[9] += weight * d * d;
+}
+
+static void quadric_add(Quadric& dest, const Quadric& src) {
+  for(nikola::sizei i = 0; i < 10; i++) {
+    dest.m[i] += src.m[i];
+  }
+}
+
+static nikola::f64 quadric_error(const Quadric& a, const Quadric& b, const nikola::Vec3& pos) {
+  nikola::f64 m[10];
+  for(nikola::sizei i = 0; i < 10; i++) {
+    m[i] = a.m[i] + b.m[i];
+  }
+
+  nikola::f64 x = pos.x, y = pos.y, z = pos.z;
+  nikola::f64 error = (m[0] * x * x) + (2.0 * m[1] * x * y) + (2.0 * m[2] * x * z) + (2.0 * m[3] * x) +
+                      (m[4] * y * y) + (2.0 * m[5] * y * z) + (2.0 * m[6] * y) +
+                      (m[7] * z * z) + (2.0 * m[8] * z) +
+                      m[9];
+
+  // Rounding can push a perfect fit slightly below zero
+  return error > 0.0 ? error : 0.0;
+}
+
+static void weld_positions(const nikola::f32* vertices,
+                           const nikola::sizei vertices_count,
+                           const nikola::sizei stride,
+                           nikola::DynamicArray<nikola::u32>& position_ids,
+                           nikola::DynamicArray<nikola::u32>& position_users) {
+  // Sorting the vertices by their positions puts the duplicates right next to each other
+  nikola::DynamicArray<nikola::u32> order(vertices_count);
+  for(nikola::sizei i = 0; i < vertices_count; i++) {
+    order[i] = (nikola::u32)i;
+  }
+
+  std::sort(order.begin(), order.end(), [&](const nikola::u32 a, const nikola::u32 b) {
+    const nikola::f32* pos_a = vertices + (a * stride);
+    const nikola::f32* pos_b = vertices + (b * stride);
+
+    return std::lexicographical_compare(pos_a, pos_a + 3, pos_b, pos_b + 3);
+  });
+
+  position_ids.resize(vertices_count);
+  position_users.clear();
+
+  for(nikola::sizei i = 0; i < vertices_count; i++) {
+    const nikola::f32* pos      = vertices + (order[i] * stride);
+    const nikola::f32* previous = i > 0 ? vertices + (order[i - 1] * stride) : nullptr;
+
+    bool is_new = !previous || pos[0] != previous[0] || pos[1] != previous[1] || pos[2] != previous[2];
+    if(is_new) {
+      position_users.push_back(0);
+    }
+
+    position_ids[order[i]] = (nikola::u32)(position_users.size() - 1);
+    position_users.back()++;
+  }
+}
+
+static void find_locked_vertices(const nikola::u32* indices,
+                                 const nikola::sizei indices_count,
+                                 const nikola::DynamicArray<nikola::u32>& position_ids,
+                                 const nikola::DynamicArray<nikola::u32>& position_users,
+                                 nikola::DynamicArray<bool>& locked) {
+  // Count how many triangles share each edge once the seams are welded together
+  nikola::HashMap<nikola::u64, nikola::u32> edges;
+  edges.reserve(indices_count);
+
+  for(nikola::sizei i = 0; i < indices_count; i += 3) {
+    for(nikola::sizei e = 0; e < 3; e++) {
+      nikola::u32 a = position_ids[indices[i + e]];
+      nikola::u32 b = position_ids[indices[i + ((e + 1) % 3)]];
+
+      nikola::u64 key = a < b ? (((nikola::u64)a << 32) | b) : (((nikola::u64)b << 32) | a);
+      edges[key]++;
+    }
+  }
+
+  // Vertices on a border or on a seam of the attributes cannot move without tearing the mesh
+  nikola::DynamicArray<bool> locked_positions(position_users.size(), false);
+  for(auto& [key, count] : edges) {
+    if(count == 2) {
+      continue;
+    }
+
+    locked_positions[(nikola::u32)(key >> 32)]        = true;
+    locked_positions[(nikola::u32)(key & 0xffffffff)] = true;
+  }
+
+  for(nikola::sizei i = 0; i < position_ids.size(); i++) {
+    nikola::u32 id = position_ids[i];
+    locked[i]      = locked_positions[id] || position_users[id] > 1;
+  }
+}
+
+static void build_adjacency(const nikola::DynamicArray<nikola::u32>& triangles,
+                            const nikola::sizei vertices_count,
+                            nikola::DynamicArray<nikola::u32>& offsets,
+                            nikola::DynamicArray<nikola::u32>& adjacency) {
+  offsets.assign(vertices_count + 1, 0);
+  for(auto& index : triangles) {
+    offsets[index + 1]++;
+  }
+
+  for(nikola::sizei i = 0; i < vertices_count; i++) {
+    offsets[i + 1] += offsets[i];
+  }
+
+  nikola::DynamicArray<nikola::u32> cursors(offsets.begin(), offsets.end() - 1);
+  adjacency.resize(triangles.size());
+
+  for(nikola::sizei i = 0; i < triangles.size(); i++) {
+    adjacency[cursors[triangles[i]]++] = (nikola::u32)(i / 3);
+  }
+}
+
+static bool collapse_flips_triangles(const nikola::f32* vertices,
+                                     const nikola::sizei stride,
+                                     const nikola::DynamicArray<nikola::u32>& triangles,
+                                     const nikola::u32* faces,
+                                     const nikola::sizei faces_count,
+                                     const Collapse& collapse) {
+  nikola::Vec3 target = get_position(vertices, stride, collapse.to);
+
+  for(nikola::sizei i = 0; i < faces_count; i++) {
+    const nikola::u32* tri = &triangles[faces[i] * 3];
+
+    // Triangles on the collapsed edge disappear anyway
+    if(tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to) {
+      continue;
+    }
+
+    nikola::Vec3 pos[3];
+    for(nikola::sizei j = 0; j < 3; j++) {
+      pos[j] = get_position(vertices, stride, tri[j]);
+    }
+
+    nikola::Vec3 old_normal = nikola::vec3_cross(pos[1] - pos[0], pos[2] - pos[0]);
+    for(nikola::sizei j = 0; j < 3; j++) {
+      pos[j] = tri[j] == collapse.from ? target : pos[j];
+    }
+
+    nikola::Vec3 new_normal = nikola::vec3_cross(pos[1] - pos[0], pos[2] - pos[0]);
+    if(nikola::vec3_dot(old_normal, new_normal) <= 0.0f) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Mesh simplifier functions
+
+bool mesh_simplifier_simplify(const nikola::f32* vertices,
+                              const nikola::sizei vertices_count,
+                              const nikola::sizei stride,
+                              const nikola::u32* indices,
+                              const nikola::sizei indices_count,
+                              const nikola::f32 target_ratio,
+                              nikola::DynamicArray<nikola::u32>& out_indices) {
+  out_indices.assign(indices, indices + indices_count);
+  if(indices_count < 3 || vertices_count == 0) {
+    return false;
+  }
+
+  nikola::sizei target_count = (nikola::sizei)((indices_count / 3) * target_ratio) * 3;
+  target_count               = target_count < 3 ? 3 : target_count;
+
+  // Seams and borders
+  nikola::DynamicArray<nikola::u32> position_ids, position_users;
+  weld_positions(vertices, vertices_count, stride, position_ids, position_users);
+
+  nikola::DynamicArray<bool> locked(vertices_count, false);
+  find_locked_vertices(indices, indices_count, position_ids, position_users, locked);
+
+  // Each vertex starts with the planes of the triangles around it, weighted by their area
+  nikola::DynamicArray<Quadric> quadrics(vertices_count);
+  for(nikola::sizei i = 0; i < indices_count; i += 3) {
+    nikola::Vec3 p0 = get_position(vertices, stride, indices[i + 0]);
+    nikola::Vec3 p1 = get_position(vertices, stride, indices[i + 1]);
+    nikola::Vec3 p2 = get_position(vertices, stride, indices[i + 2]);
+
+    nikola::Vec3 normal = nikola::vec3_cross(p1 - p0, p2 - p0);
+    nikola::f32 length  = sqrtf(nikola::vec3_dot(normal, normal));
+    if(length <= 0.0f) {
+      continue;
+    }
+
+    normal               = normal / length;
+    nikola::f64 distance = -nikola::vec3_dot(normal, p0);
+
+    for(nikola::sizei j = 0; j < 3; j++) {
+      quadric_add_plane(quadrics[indices[i + j]], normal, distance, length * 0.5f);
+    }
+  }
+
+  nikola::DynamicArray<nikola::u32> offsets, adjacency;
+  nikola::DynamicArray<Collapse> collapses;
+  nikola::DynamicArray<bool> touched;
+
+  // Every pass collapses the cheapest edges that do not overlap,
+  // and then gets rid of the triangles that degenerated
+  while(out_indices.size() > target_count) {
+    build_adjacency(out_indices, vertices_count, offsets, adjacency);
+
+    collapses.clear();
+    for(nikola::sizei i = 0; i < out_indices.size(); i += 3) {
+      for(nikola::sizei e = 0; e < 3; e++) {
+        nikola::u32 a = out_indices[i + e];
+        nikola::u32 b = out_indices[i + ((e + 1) % 3)];
+
+        if(!locked[a]) {
+          collapses.push_back(Collapse{a, b, quadric_error(quadrics[a], quadrics[b], get_position(vertices, stride, b))});
+        }
+
+        if(!locked[b]) {
+          collapses.push_back(Collapse{b, a, quadric_error(quadrics[a], quadrics[b], get_position(vertices, stride, a))});
+        }
+      }
+    }
+
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+      return a.cost < b.cost;
+    });
+
+    touched.assign(vertices_count, false);
+
+    nikola::sizei triangles_left = out_indices.size() / 3;
+    nikola::sizei target_left    = target_count / 3;
+    nikola::sizei collapsed      = 0;
+
+    for(auto& collapse : collapses) {
+      if(triangles_left <= target_left) {
+        break;
+      }
+
+      if(touched[collapse.from] || touched[collapse.to]) {
+        continue;
+      }
+
+      const nikola::u32* faces  = &adjacency[offsets[collapse.from]];
+      nikola::sizei faces_count = offsets[collapse.from + 1] - offsets[collapse.from];
+
+      if(collapse_flips_triangles(vertices, stride, out_indices, faces, faces_count, collapse)) {
+        continue;
+      }
+
+      // Move the vertex over, leaving the neighbourhood alone for the rest of the pass
+      for(nikola::sizei i = 0; i < faces_count; i++) {
+        nikola::u32* tri = &out_indices[faces[i] * 3];
+
+        for(nikola::sizei j = 0; j < 3; j++) {
+          touched[tri[j]] = true;
+          tri[j]          = tri[j] == collapse.from ? collapse.to : tri[j];
+        }
+
+        if(tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) {
+          triangles_left--;
+        }
+      }
+
+      quadric_add(quadrics[collapse.to], quadrics[collapse.from]);
+      collapsed++;
+    }
+
+    // Nothing left that can move
+    if(collapsed == 0) {
+      break;
+    }
+
+    nikola::sizei write = 0;
+    for(nikola::sizei i = 0; i < out_indices.size(); i += 3) {
+      nikola::u32 a = out_indices[i + 0], b = out_indices[i + 1], c = out_indices[i + 2];
+      if(a == b || b == c || c == a) {
+        continue;
+      }
+
+      out_indices[write++] = a;
+      out_indices[write++] = b;
+      out_indices[write++] = c;
+    }
+
+    out_indices.resize(write);
+  }
+
+  return out_indices.size() < indices_count;
+}
+
+/// Mesh simplifier functions
+/// ----------------------------------------------------------------------
+
+} // End of nbr
+
+//////////////////////////////////////////////////////////////////////////
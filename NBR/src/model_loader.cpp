@@ -19,9 +19,22 @@ struct ObjData {
   nikola::DynamicArray<nikola::NBRTexture> textures;
 
   nikola::FilePath parent_dir;
+  nikola::GfxTextureFormat texture_format;
 };
 /// ----------------------------------------------------------------------
 
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The fraction of triangles each level of detail keeps from the full mesh.
+const nikola::f32 LOD_RATIOS[] = {0.5f, 0.25f, 0.125f};
+
+/// Meshes with fewer triangles than this are not worth simplifying any further.
+const nikola::sizei LOD_TRIANGLES_MIN = 64;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
 /// ----------------------------------------------------------------------
 /// Private functions
 
@@ -103,6 +116,40 @@ static void load_node_mesh(aiMesh* mesh, nikola::NBRMesh* nbr_mesh) {
       indices.push_back((nikola::u32)face->mIndices[j]);
     }
   } 
+
+  // Generate the levels of detail from the full mesh, packing 
+  // their indices right after it 
+  nikola::DynamicArray<nikola::u32> lod_counts = {(nikola::u32)indices.size()};
+  nikola::DynamicArray<nikola::u32> lod_indices;
+
+  nikola::sizei stride     = nbr_mesh->vertex_type == (nikola::u8)nikola::VERTEX_TYPE_PNCUV ? 12 : 8;
+  nikola::sizei full_count = indices.size();
+
+  for(nikola::sizei i = 0; i < (sizeof(LOD_RATIOS) / sizeof(LOD_RATIOS[0])); i++) {
+    nikola::u32 previous_count = lod_counts.back();
+    if((previous_count / 3) < LOD_TRIANGLES_MIN) {
+      break;
+    }
+
+    if(!mesh_simplifier_simplify(vertices.data(), 
+                                 vertices.size() / stride, 
+                                 stride, 
+                                 indices.data(), 
+                                 full_count, 
+                                 LOD_RATIOS[i], 
+                                 lod_indices)) {
+      break;
+    }
+
+    // Not enough of a difference from the previous level to be worth it
+    if(lod_indices.empty() || lod_indices.size() > (previous_count * 0.8f)) {
+      break;
+    }
+
+    lod_counts.push_back((nikola::u32)lod_indices.size());
+    indices.insert(indices.end(), lod_indices.begin(), lod_indices.end());
+  }
+
   nikola::sizei bytes_size;
 
   // Allocate a new vertices array for the mesh
@@ -116,6 +163,12 @@ static void load_node_mesh(aiMesh* mesh, nikola::NBRMesh* nbr_mesh) {
   bytes_size              = sizeof(nikola::u32) * nbr_mesh->indices_count;
   nbr_mesh->indices       = (nikola::u32*)nikola::memory_allocate(bytes_size);
   nikola::memory_copy(nbr_mesh->indices, indices.data(), bytes_size);
+
+  // Allocate a new array for the levels of detail
+  nbr_mesh->lods_count         = (nikola::u8)lod_counts.size();
+  bytes_size                   = sizeof(nikola::u32) * nbr_mesh->lods_count;
+  nbr_mesh->lod_indices_counts = (nikola::u32*)nikola::memory_allocate(bytes_size);
+  nikola::memory_copy(nbr_mesh->lod_indices_counts, lod_counts.data(), bytes_size);
 }
 
 static void load_scene_meshes(const aiScene* scene, ObjData* data, aiNode* node) {
@@ -148,7 +201,7 @@ static void load_material_texture(aiMaterial* material, aiTextureType type, ObjD
 
     // Convert into our `NBRTexture`
     nikola::NBRTexture texture;
-    image_loader_load_texture(&texture, nikola::filepath_append(data->parent_dir, str.C_Str()));
+    image_loader_load_texture(&texture, nikola::filepath_append(data->parent_dir, str.C_Str()), data->texture_format);
     data->textures.push_back(texture);
   }
 }
@@ -200,7 +253,7 @@ static void load_scene_materials(const aiScene* scene, ObjData* data) {
 /// ----------------------------------------------------------------------
 /// Model loader functions
 
-bool model_loader_load(nikola::NBRModel* model, const nikola::FilePath& path) {
+bool model_loader_load(nikola::NBRModel* model, const nikola::FilePath& path, const nikola::GfxTextureFormat texture_format) {
   nikola::FilePath ext = nikola::filepath_extension(path);
 
   if(!is_valid_extension(ext)) {
@@ -218,7 +271,8 @@ bool model_loader_load(nikola::NBRModel* model, const nikola::FilePath& path) {
 
   // Loading everything into `ObjData`
   ObjData data; 
-  data.parent_dir = nikola::filepath_parent_path(path); // Usually, `path` will refer to the 3D model file directly so we need its immediate parent
+  data.parent_dir     = nikola::filepath_parent_path(path); // Usually, `path` will refer to the 3D model file directly so we need its immediate parent
+  data.texture_format = texture_format;
   
   // Meshes init 
   load_scene_meshes(scene, &data, scene->mRootNode);
@@ -245,6 +299,7 @@ void model_loader_unload(nikola::NBRModel& model) {
   for(nikola::sizei i = 0; i < model.meshes_count; i++) {
     nikola::memory_free(model.meshes[i].vertices); 
     nikola::memory_free(model.meshes[i].indices); 
+    nikola::memory_free(model.meshes[i].lod_indices_counts); 
   }
   nikola::memory_free(model.meshes);
 
@@ -15,6 +15,7 @@ enum ArgTokenType {
   ARG_TOKEN_RESOURCE_TYPE = 0, 
   ARG_TOKEN_DIRECTORY,
   ARG_TOKEN_RECURSE, 
+  ARG_TOKEN_COMPRESS, 
   ARG_TOKEN_HELP, 
   ARG_TOKEN_PARAM,
   ARG_TOKEN_EOF,
@@ -62,7 +63,7 @@ bool parser_init(const nikola::DynamicArray<ArgToken>& tokens);
 /// ----------------------------------------------------------------------
 /// Image loader functions
 
-bool image_loader_load_texture(nikola::NBRTexture* texture, const nikola::FilePath& path);
+bool image_loader_load_texture(nikola::NBRTexture* texture, const nikola::FilePath& path, const nikola::GfxTextureFormat format);
 
 bool image_loader_load_cubemap(nikola::NBRCubemap* cube, const nikola::FilePath& dir);
 
@@ -86,13 +87,52 @@ void shader_loader_unload(nikola::NBRShader& shader);
 /// ----------------------------------------------------------------------
 /// Model loader functions
 
-bool model_loader_load(nikola::NBRModel* model, const nikola::FilePath& path); 
+bool model_loader_load(nikola::NBRModel* model, const nikola::FilePath& path, const nikola::GfxTextureFormat texture_format); 
 
 void model_loader_unload(nikola::NBRModel& model); 
 
 /// Model loader functions
 /// ----------------------------------------------------------------------
 
+/// ----------------------------------------------------------------------
+/// Font loader functions
+
+bool font_loader_load(nikola::NBRFont* font, const nikola::FilePath& path);
+
+void font_loader_unload(nikola::NBRFont& font);
+
+/// Font loader functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Texture compressor functions
+
+bool texture_compressor_compress(nikola::NBRTexture* texture, const nikola::u8* pixels, const nikola::GfxTextureFormat format);
+
+/// Texture compressor functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Mesh simplifier functions
+
+/// Collapse the edges of the triangle list `indices` until only about `target_ratio` of its
+/// triangles are left, writing the new triangle list into `out_indices`.
+/// The list keeps referring to the original `vertices`, where `stride` is the number of floats
+/// between two vertices and the first three floats of each vertex are its position.
+///
+/// @NOTE: Vertices on a border or on an attribute seam never move, so the target might not be reached.
+/// The function returns `false` if no triangles could be removed at all.
+bool mesh_simplifier_simplify(const nikola::f32* vertices,
+                              const nikola::sizei vertices_count,
+                              const nikola::sizei stride,
+                              const nikola::u32* indices,
+                              const nikola::sizei indices_count,
+                              const nikola::f32 target_ratio,
+                              nikola::DynamicArray<nikola::u32>& out_indices);
+
+/// Mesh simplifier functions
+/// ----------------------------------------------------------------------
+
 /// *** Loaders ***
 /// ---------------------------------------------------------------------------------------------------------
 
@@ -9,7 +9,7 @@ namespace nbr { // Start of nbr
 /// ----------------------------------------------------------------------
 /// Consts
 
-const int VALID_OPTIONS_MAX = 4;
+const int VALID_OPTIONS_MAX = 5;
 
 /// Consts
 /// ----------------------------------------------------------------------
@@ -37,6 +37,7 @@ bool lexer_init(nikola::DynamicArray<ArgToken>* tokens, int argc, char** argv) {
     {ARG_TOKEN_RESOURCE_TYPE, "--resource-type", "-rt"}, 
     {ARG_TOKEN_DIRECTORY,     "--dir",           "-d"}, 
     {ARG_TOKEN_RECURSE,       "--recurse",       "-r"},
+    {ARG_TOKEN_COMPRESS,      "--compress",      "-c"},
     {ARG_TOKEN_HELP,          "--help",          "-h"},
   };
 
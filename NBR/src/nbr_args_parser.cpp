@@ -33,6 +33,7 @@ struct ArgParser {
   bool can_recurse  = false;
 
   nikola::ResourceType current_res_type;
+  nikola::GfxTextureFormat texture_format = nikola::GFX_TEXTURE_FORMAT_RGBA8;
 
   nikola::DynamicArray<nikola::FilePath> src_paths;
   nikola::FilePath resource_dir, nbr_output_dir; 
@@ -59,10 +60,11 @@ static void show_help() {
   printf("\n\n### Welcome to NBR ### \n\n");
   printf("NBR (Nikola Binary Resource) is a tool to convert any\nresources to the NBR format used by the Nikola engine\n\n");
   
-  printf("[Usage]: nbr [--resource-type -rt] [--dir -d] [--recurse -r] <src_path> <dest_dir>\n\n");
+  printf("[Usage]: nbr [--resource-type -rt] [--dir -d] [--recurse -r] [--compress -c] <src_path> <dest_dir>\n\n");
   printf("  --resource-type, -rt = Specify the resource type you wish to convert\n");
   printf("  --directory, -d      = Will treat the given src_path as a directory\n");
   printf("  --recurse, -r        = Recursively go through all of the resources in src_path\n");
+  printf("  --compress, -c       = Store textures as pre-compressed blocks (BC1, BC3, BC4, BC5, or BC7) with their mip chain\n");
 }
 
 static bool is_eof() {
@@ -118,6 +120,26 @@ static nikola::ResourceType get_resource_type(const nikola::String& res_type) {
   RAISE_ERROR("NBR: Unkown resource type given \'%s\'", res_type.c_str());
 }
 
+static nikola::GfxTextureFormat get_compressed_format(const nikola::String& format) {
+  if(format == "BC1") {
+    return nikola::GFX_TEXTURE_FORMAT_BC1;
+  } 
+  else if(format == "BC3") {
+    return nikola::GFX_TEXTURE_FORMAT_BC3;
+  } 
+  else if(format == "BC4") {
+    return nikola::GFX_TEXTURE_FORMAT_BC4;
+  } 
+  else if(format == "BC5") {
+    return nikola::GFX_TEXTURE_FORMAT_BC5;
+  } 
+  else if(format == "BC7") {
+    return nikola::GFX_TEXTURE_FORMAT_BC7;
+  }
+
+  RAISE_ERROR("NBR: Unkown compression format given \'%s\'", format.c_str());
+}
+
 static void check_resource_literal() {
   ArgToken param = token_consume();
 
@@ -130,6 +152,18 @@ static void check_resource_literal() {
   s_parser.current_res_type = get_resource_type(param.arg);
 }
 
+static void check_compress_literal() {
+  ArgToken param = token_consume();
+
+  // The next token should be the param
+  if(param.type != ARG_TOKEN_PARAM) {
+    RAISE_ERROR("NBR: Expected an argument passed after \'%s\'", param.arg.c_str());
+  }
+
+  // Convert the argument into a valid compressed format
+  s_parser.texture_format = get_compressed_format(param.arg);
+}
+
 static void check_final_path() {
   s_parser.resource_dir = token_previous().arg;
   ArgToken next_token   = token_consume();
@@ -166,7 +200,7 @@ static void create_nbr_texture() {
     nikola::filepath_set_extension(final_path, "nbr");
   
     // Load the texture
-    bool loaded = image_loader_load_texture(&texture, path);
+    bool loaded = image_loader_load_texture(&texture, path, s_parser.texture_format);
     if(!loaded) {
       NIKOLA_LOG_ERROR("NBR: Failed to load resource at \'%s\'", path.c_str());
       continue;
@@ -238,7 +272,7 @@ static void create_nbr_model() {
     nikola::filepath_set_extension(final_path, "nbr");
 
     // Load the model
-    bool loaded = model_loader_load(&model, path);
+    bool loaded = model_loader_load(&model, path, s_parser.texture_format);
     if(!loaded) {
       NIKOLA_LOG_ERROR("NBR: Failed to load resource at \'%s\'", path.c_str());
       continue;
@@ -252,6 +286,30 @@ static void create_nbr_model() {
   }
 }
 
+static void create_nbr_font() {
+  nikola::NBRFont font;
+  nikola::NBRFile nbr;
+  
+  for(auto& path : s_parser.src_paths) {
+    // Construct the final path
+    nikola::FilePath final_path = nikola::filepath_append(s_parser.nbr_output_dir, nikola::filepath_filename(path)); 
+    nikola::filepath_set_extension(final_path, "nbr");
+
+    // Load the font
+    bool loaded = font_loader_load(&font, path);
+    if(!loaded) {
+      NIKOLA_LOG_ERROR("NBR: Failed to load resource at \'%s\'", path.c_str());
+      continue;
+    }
+
+    // Save the font
+    nikola::nbr_file_save(nbr, font, final_path);
+
+    font_loader_unload(font);
+    NIKOLA_LOG_INFO("NBR: Converted font \'%s\' to \'%s\'...", path.c_str(), final_path.c_str());
+  }
+}
+
 static void create_nbr_file() {
   switch(s_parser.current_res_type) {
     case nikola::RESOURCE_TYPE_TEXTURE:
@@ -267,6 +325,7 @@ static void create_nbr_file() {
       create_nbr_model();
       break;
     case nikola::RESOURCE_TYPE_FONT:
+      create_nbr_font();
       break;
   }
 }
@@ -300,6 +359,9 @@ bool parser_init(const nikola::DynamicArray<ArgToken>& tokens) {
       case ARG_TOKEN_RESOURCE_TYPE: 
         check_resource_literal();
         continue;
+      case ARG_TOKEN_COMPRESS: 
+        check_compress_literal();
+        continue;
       case ARG_TOKEN_HELP:
         show_help(); 
         return false;
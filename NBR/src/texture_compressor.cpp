@@ -0,0 +1,431 @@
+#include "nbr.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nbr { // Start of nbr
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+const nikola::sizei BLOCK_PIXELS = 16;
+
+/// The interpolation weights of a BC7 endpoint pair with 4-bit indices
+const nikola::u32 BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static nikola::u32 get_block_size(const nikola::GfxTextureFormat format) {
+  switch(format) {
+    case nikola::GFX_TEXTURE_FORMAT_BC1:
+    case nikola::GFX_TEXTURE_FORMAT_BC4:
+      return 8;
+    case nikola::GFX_TEXTURE_FORMAT_BC3:
+    case nikola::GFX_TEXTURE_FORMAT_BC5:
+    case nikola::GFX_TEXTURE_FORMAT_BC7:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+static nikola::u32 get_mips_count(nikola::u32 width, nikola::u32 height) {
+  nikola::u32 size = width > height ? width : height;
+  nikola::u32 mips = 1;
+
+  while(size > 1) {
+    size >>= 1;
+    mips++;
+  }
+
+  return mips;
+}
+
+static nikola::u32 get_level_size(const nikola::u32 width, const nikola::u32 height, const nikola::GfxTextureFormat format) {
+  return ((width + 3) / 4) * ((height + 3) / 4) * get_block_size(format);
+}
+
+static nikola::u32 get_mip_dimension(const nikola::u32 size, const nikola::u32 level) {
+  nikola::u32 mip_size = size >> level;
+  return mip_size > 0 ? mip_size : 1;
+}
+
+static void downsample_rgba(const nikola::u8* src, const nikola::u32 src_width, const nikola::u32 src_height,
+                            nikola::u8* dest, const nikola::u32 dest_width, const nikola::u32 dest_height) {
+  // A simple 2x2 box filter, clamping at the edges for odd sizes
+  for(nikola::u32 y = 0; y < dest_height; y++) {
+    nikola::u32 y0 = (y * 2) < src_height ? (y * 2) : (src_height - 1);
+    nikola::u32 y1 = (y * 2 + 1) < src_height ? (y * 2 + 1) : (src_height - 1);
+
+    for(nikola::u32 x = 0; x < dest_width; x++) {
+      nikola::u32 x0 = (x * 2) < src_width ? (x * 2) : (src_width - 1);
+      nikola::u32 x1 = (x * 2 + 1) < src_width ? (x * 2 + 1) : (src_width - 1);
+
+      for(nikola::u32 c = 0; c < 4; c++) {
+        nikola::u32 sum = src[(y0 * src_width + x0) * 4 + c] +
+                          src[(y0 * src_width + x1) * 4 + c] +
+                          src[(y1 * src_width + x0) * 4 + c] +
+                          src[(y1 * src_width + x1) * 4 + c];
+
+        dest[(y * dest_width + x) * 4 + c] = (nikola::u8)((sum + 2) / 4);
+      }
+    }
+  }
+}
+
+static void fetch_block(const nikola::u8* pixels, const nikola::u32 width, const nikola::u32 height,
+                        const nikola::u32 block_x, const nikola::u32 block_y, nikola::u8 block[BLOCK_PIXELS][4]) {
+  // Blocks hanging off the edges of the image repeat the last row/column
+  for(nikola::u32 y = 0; y < 4; y++) {
+    nikola::u32 py = (block_y * 4 + y) < height ? (block_y * 4 + y) : (height - 1);
+
+    for(nikola::u32 x = 0; x < 4; x++) {
+      nikola::u32 px = (block_x * 4 + x) < width ? (block_x * 4 + x) : (width - 1);
+      nikola::memory_copy(block[y * 4 + x], &pixels[(py * width + px) * 4], 4);
+    }
+  }
+}
+
+static nikola::u16 pack_565(const nikola::u8* color) {
+  return (nikola::u16)(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3));
+}
+
+static void unpack_565(const nikola::u16 value, nikola::i32* color) {
+  nikola::i32 r = (value >> 11) & 31;
+  nikola::i32 g = (value >> 5) & 63;
+  nikola::i32 b = value & 31;
+
+  color[0] = (r << 3) | (r >> 2);
+  color[1] = (g << 2) | (g >> 4);
+  color[2] = (b << 3) | (b >> 2);
+}
+
+static void write_bits(nikola::u8* out, nikola::u32& bit, const nikola::u32 value, const nikola::u32 count) {
+  for(nikola::u32 i = 0; i < count; i++) {
+    if((value >> i) & 1) {
+      out[bit >> 3] |= (nikola::u8)(1 << (bit & 7));
+    }
+
+    bit++;
+  }
+}
+
+static void encode_bc1(const nikola::u8 block[BLOCK_PIXELS][4], nikola::u8* out) {
+  nikola::u8 min[3] = {255, 255, 255};
+  nikola::u8 max[3] = {0, 0, 0};
+
+  // Find the bounding box of the colors
+  for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+    for(nikola::sizei c = 0; c < 3; c++) {
+      min[c] = block[i][c] < min[c] ? block[i][c] : min[c];
+      max[c] = block[i][c] > max[c] ? block[i][c] : max[c];
+    }
+  }
+
+  // Pull the endpoints slightly inwards since the extremes are rarely hit
+  for(nikola::sizei c = 0; c < 3; c++) {
+    nikola::u8 inset = (max[c] - min[c]) >> 4;
+
+    min[c] += inset;
+    max[c] -= inset;
+  }
+
+  // `max` will always pack to the bigger value, which keeps the block in 4-color mode
+  nikola::u16 color0  = pack_565(max);
+  nikola::u16 color1  = pack_565(min);
+  nikola::u32 indices = 0;
+
+  if(color0 != color1) {
+    nikola::i32 palette[4][3];
+    unpack_565(color0, palette[0]);
+    unpack_565(color1, palette[1]);
+
+    for(nikola::sizei c = 0; c < 3; c++) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+      nikola::u32 best_index = 0;
+      nikola::i32 best_error = INT32_MAX;
+
+      for(nikola::u32 p = 0; p < 4; p++) {
+        nikola::i32 error = 0;
+        for(nikola::sizei c = 0; c < 3; c++) {
+          nikola::i32 diff = block[i][c] - palette[p][c];
+          error += diff * diff;
+        }
+
+        if(error < best_error) {
+          best_error = error;
+          best_index = p;
+        }
+      }
+
+      indices |= best_index << (i * 2);
+    }
+  }
+
+  out[0] = color0 & 0xff;
+  out[1] = color0 >> 8;
+  out[2] = color1 & 0xff;
+  out[3] = color1 >> 8;
+
+  for(nikola::sizei i = 0; i < 4; i++) {
+    out[4 + i] = (indices >> (i * 8)) & 0xff;
+  }
+}
+
+static void encode_bc4(const nikola::u8 block[BLOCK_PIXELS][4], const nikola::sizei channel, nikola::u8* out) {
+  nikola::u8 min = 255;
+  nikola::u8 max = 0;
+
+  for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+    min = block[i][channel] < min ? block[i][channel] : min;
+    max = block[i][channel] > max ? block[i][channel] : max;
+  }
+
+  // Having `max` first puts the block in the 8-value mode
+  out[0] = max;
+  out[1] = min;
+
+  nikola::u64 indices = 0;
+
+  if(max != min) {
+    nikola::i32 palette[8] = {max, min};
+    for(nikola::i32 p = 2; p < 8; p++) {
+      palette[p] = ((8 - p) * max + (p - 1) * min) / 7;
+    }
+
+    for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+      nikola::u64 best_index = 0;
+      nikola::i32 best_error = INT32_MAX;
+
+      for(nikola::u32 p = 0; p < 8; p++) {
+        nikola::i32 error = block[i][channel] - palette[p];
+        error             = error < 0 ? -error : error;
+
+        if(error < best_error) {
+          best_error = error;
+          best_index = p;
+        }
+      }
+
+      indices |= best_index << (i * 3);
+    }
+  }
+
+  for(nikola::sizei i = 0; i < 6; i++) {
+    out[2 + i] = (indices >> (i * 8)) & 0xff;
+  }
+}
+
+static void quantize_bc7_endpoint(const nikola::u8* color, nikola::u8* quantized, nikola::u8* p_bit) {
+  nikola::i32 best_error = INT32_MAX;
+
+  // Every endpoint is 7 bits per channel plus a shared low bit. Try both.
+  for(nikola::u8 p = 0; p < 2; p++) {
+    nikola::u8 values[4];
+    nikola::i32 error = 0;
+
+    for(nikola::sizei c = 0; c < 4; c++) {
+      nikola::i32 value = (color[c] - p + 1) / 2;
+      value             = value < 0 ? 0 : (value > 127 ? 127 : value);
+
+      nikola::i32 diff = ((value << 1) | p) - color[c];
+      error           += diff * diff;
+      values[c]        = (nikola::u8)value;
+    }
+
+    if(error < best_error) {
+      best_error = error;
+      *p_bit     = p;
+      nikola::memory_copy(quantized, values, 4);
+    }
+  }
+}
+
+static void encode_bc7(const nikola::u8 block[BLOCK_PIXELS][4], nikola::u8* out) {
+  nikola::u8 min[4] = {255, 255, 255, 255};
+  nikola::u8 max[4] = {0, 0, 0, 0};
+
+  for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+    for(nikola::sizei c = 0; c < 4; c++) {
+      min[c] = block[i][c] < min[c] ? block[i][c] : min[c];
+      max[c] = block[i][c] > max[c] ? block[i][c] : max[c];
+    }
+  }
+
+  // Only mode 6 is used (one RGBA endpoint pair with 4-bit indices).
+  // Not the best quality BC7 can give, but good enough for an offline tool.
+  nikola::u8 endpoints[2][4];
+  nikola::u8 p_bits[2];
+  quantize_bc7_endpoint(min, endpoints[0], &p_bits[0]);
+  quantize_bc7_endpoint(max, endpoints[1], &p_bits[1]);
+
+  nikola::i32 palette[16][4];
+  for(nikola::sizei p = 0; p < 16; p++) {
+    for(nikola::sizei c = 0; c < 4; c++) {
+      nikola::i32 e0 = (endpoints[0][c] << 1) | p_bits[0];
+      nikola::i32 e1 = (endpoints[1][c] << 1) | p_bits[1];
+
+      palette[p][c] = ((64 - BC7_WEIGHTS[p]) * e0 + BC7_WEIGHTS[p] * e1 + 32) >> 6;
+    }
+  }
+
+  nikola::u32 indices[BLOCK_PIXELS];
+  for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+    nikola::i32 best_error = INT32_MAX;
+
+    for(nikola::u32 p = 0; p < 16; p++) {
+      nikola::i32 error = 0;
+      for(nikola::sizei c = 0; c < 4; c++) {
+        nikola::i32 diff = block[i][c] - palette[p][c];
+        error += diff * diff;
+      }
+
+      if(error < best_error) {
+        best_error = error;
+        indices[i] = p;
+      }
+    }
+  }
+
+  // The first index only has 3 bits stored, so its top bit must be 0.
+  // Swapping the endpoints and flipping the indices makes sure of that.
+  if(indices[0] & 8) {
+    for(nikola::sizei c = 0; c < 4; c++) {
+      nikola::u8 temp   = endpoints[0][c];
+      endpoints[0][c]   = endpoints[1][c];
+      endpoints[1][c]   = temp;
+    }
+
+    nikola::u8 temp_p = p_bits[0];
+    p_bits[0]         = p_bits[1];
+    p_bits[1]         = temp_p;
+
+    for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+      indices[i] = 15 - indices[i];
+    }
+  }
+
+  nikola::memory_zero(out, 16);
+  nikola::u32 bit = 0;
+
+  // Mode 6 is six 0 bits followed by a 1
+  write_bits(out, bit, 1 << 6, 7);
+
+  for(nikola::sizei c = 0; c < 4; c++) {
+    write_bits(out, bit, endpoints[0][c], 7);
+    write_bits(out, bit, endpoints[1][c], 7);
+  }
+
+  write_bits(out, bit, p_bits[0], 1);
+  write_bits(out, bit, p_bits[1], 1);
+
+  for(nikola::sizei i = 0; i < BLOCK_PIXELS; i++) {
+    write_bits(out, bit, indices[i], i == 0 ? 3 : 4);
+  }
+}
+
+static void encode_block(const nikola::u8 block[BLOCK_PIXELS][4], const nikola::GfxTextureFormat format, nikola::u8* out) {
+  switch(format) {
+    case nikola::GFX_TEXTURE_FORMAT_BC1:
+      encode_bc1(block, out);
+      break;
+    case nikola::GFX_TEXTURE_FORMAT_BC3:
+      encode_bc4(block, 3, out);
+      encode_bc1(block, out + 8);
+      break;
+    case nikola::GFX_TEXTURE_FORMAT_BC4:
+      encode_bc4(block, 0, out);
+      break;
+    case nikola::GFX_TEXTURE_FORMAT_BC5:
+      encode_bc4(block, 0, out);
+      encode_bc4(block, 1, out + 8);
+      break;
+    case nikola::GFX_TEXTURE_FORMAT_BC7:
+      encode_bc7(block, out);
+      break;
+    default:
+      break;
+  }
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Texture compressor functions
+
+bool texture_compressor_compress(nikola::NBRTexture* texture, const nikola::u8* pixels, const nikola::GfxTextureFormat format) {
+  if(get_block_size(format) == 0) {
+    NIKOLA_LOG_ERROR("NBR: Cannot compress a texture to a non block-compressed format");
+    return false;
+  }
+
+  nikola::u32 mips = get_mips_count(texture->width, texture->height);
+
+  // Figure out the size of the whole chain
+  nikola::u32 data_size = 0;
+  for(nikola::u32 i = 0; i < mips; i++) {
+    data_size += get_level_size(get_mip_dimension(texture->width, i), get_mip_dimension(texture->height, i), format);
+  }
+
+  nikola::u8* blocks = (nikola::u8*)nikola::memory_allocate(data_size);
+  nikola::u32 offset = 0;
+
+  // The chain is generated from the raw pixels first, since the blocks cannot be filtered
+  nikola::DynamicArray<nikola::u8> level(pixels, pixels + (texture->width * texture->height * 4));
+  nikola::DynamicArray<nikola::u8> next_level;
+
+  for(nikola::u32 i = 0; i < mips; i++) {
+    nikola::u32 width  = get_mip_dimension(texture->width, i);
+    nikola::u32 height = get_mip_dimension(texture->height, i);
+
+    // Compress every 4x4 block of the level
+    for(nikola::u32 by = 0; by < (height + 3) / 4; by++) {
+      for(nikola::u32 bx = 0; bx < (width + 3) / 4; bx++) {
+        nikola::u8 block[BLOCK_PIXELS][4];
+        fetch_block(level.data(), width, height, bx, by, block);
+
+        encode_block(block, format, &blocks[offset]);
+        offset += get_block_size(format);
+      }
+    }
+
+    // Prepare the next level
+    if(i == (mips - 1)) {
+      break;
+    }
+
+    nikola::u32 next_width  = get_mip_dimension(texture->width, i + 1);
+    nikola::u32 next_height = get_mip_dimension(texture->height, i + 1);
+
+    next_level.resize(next_width * next_height * 4);
+    downsample_rgba(level.data(), width, height, next_level.data(), next_width, next_height);
+    level.swap(next_level);
+  }
+
+  texture->format    = format;
+  texture->mips      = (nikola::u8)mips;
+  texture->data_size = data_size;
+  texture->pixels    = blocks;
+
+  return true;
+}
+
+/// Texture compressor functions
+/// ----------------------------------------------------------------------
+
+} // End of nbr
+
+//////////////////////////////////////////////////////////////////////////
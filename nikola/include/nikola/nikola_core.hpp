@@ -48,9 +48,12 @@ typedef double f64;
 /// ----------------------------------------------------------------------
 /// *** DEFS ***
 
-/// Nikola only supports OpenGL versions greater than these.
+/// Nikola only supports OpenGL versions greater than or equal to these.
+///
+/// @NOTE: The backend is built on direct state access (4.5), and all of the 
+/// shaders are written against `#version 460`.
 #define NIKOLA_GL_MINIMUM_MAJOR_VERSION 4
-#define NIKOLA_GL_MINIMUM_MINOR_VERSION 2
+#define NIKOLA_GL_MINIMUM_MINOR_VERSION 6
 
 /// Nikola only supports Direct3D11 versions greater than these.
 #define NIKOLA_D3D11_MINIMUM_MAJOR_VERSION 11 
@@ -122,6 +125,13 @@ typedef double f64;
 #define NIKOLA_GFX_CONTEXT_OPENGL
 #endif
 
+/// The null backend replaces any platform backend when requested by the build 
+/// (`NIKOLA_GFX_NULL` in CMake)
+#ifdef NIKOLA_GFX_CONTEXT_NULL
+#undef NIKOLA_GFX_CONTEXT_OPENGL
+#undef NIKOLA_GFX_CONTEXT_DX11
+#endif
+
 /// *** Platform detection ***
 /// ----------------------------------------------------------------------
 
@@ -820,6 +830,9 @@ enum WindowFlags {
   
   /// Set the graphics context to be software rendered
   WINDOW_FLAGS_GFX_SOFTWARE        = 1 << 11,
+
+  /// Keep the window hidden on creation. The window will be shown by default.
+  WINDOW_FLAGS_HIDDEN              = 1 << 12,
 };
 /// WindowFlags
 ///---------------------------------------------------------------------------------------------------------------------
@@ -846,6 +859,7 @@ enum WindowFlags {
 ///   - `WINDOW_FLAGS_FULLSCREEN`          = Set the window to be fullscreen on creation. 
 ///   - `WINDOW_FLAGS_GFX_HARDWARE`        = Set the graphics context to be hardware accelerated (i.e either using OpenGL or DirectX).
 ///   - `WINDOW_FLAGS_GFX_SOFTWARE`        = Set the graphics context to be software rendered
+///   - `WINDOW_FLAGS_HIDDEN`              = Keep the window hidden on creation. The window will be shown by default.
 /// 
 NIKOLA_API Window* window_open(const i8* title, const i32 width, const i32 height, i32 flags);
 
@@ -971,6 +985,34 @@ const sizei LAYOUT_ELEMENTS_MAX = 32;
 /// The maximum number of render targets to be bound at once.
 const sizei RENDER_TARGETS_MAX  = 8;
 
+/// The amount of frames a `GFX_BUFFER_USAGE_STREAM_RING` buffer will be partitioned into. 
+const sizei RING_BUFFER_FRAMES  = 3;
+
+/// The maximum amount of unique samplers a context can hold at a time.
+const sizei SAMPLERS_MAX        = 64;
+
+/// The maximum amount of shader storage buffers to be bound in a compute pipeline.
+const sizei STORAGE_BUFFERS_MAX = 8;
+
+/// The maximum amount of images to be bound in a compute pipeline.
+const sizei IMAGES_MAX          = 8;
+
+/// The maximum amount of transient render targets a context can pool at a time.
+const sizei TRANSIENT_TARGETS_MAX     = 64;
+
+/// The amount of frames a pooled render target can go unused before its memory is released.
+const sizei TRANSIENT_TARGET_FRAMES   = 8;
+
+/// The maximum amount of framebuffers a context caches for the sets of render targets it was given.
+const sizei TARGET_FRAMEBUFFERS_MAX   = 32;
+
+/// The initial size (in bytes) of the staging ring that texture uploads get copied through. 
+/// The ring grows to fit any upload bigger than it.
+const sizei STAGING_BUFFER_SIZE       = 16 * 1024 * 1024;
+
+/// The maximum amount of uploads the staging ring keeps track of while the GPU is still reading them.
+const sizei STAGING_FENCES_MAX        = 64;
+
 // Consts
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -1155,13 +1197,22 @@ enum GfxContextFlags {
 /// GfxBufferType
 enum GfxBufferType {
   /// A vertex buffer.
-  GFX_BUFFER_VERTEX  = 4 << 0, 
+  GFX_BUFFER_VERTEX            = 4 << 0, 
 
   /// An index buffer.
-  GFX_BUFFER_INDEX   = 4 << 1, 
+  GFX_BUFFER_INDEX             = 4 << 1, 
 
   /// A uniform buffer.
-  GFX_BUFFER_UNIFORM = 4 << 2,
+  GFX_BUFFER_UNIFORM           = 4 << 2,
+
+  /// A buffer of `GfxDrawIndirectCommand`s to be used in an indirect draw command.
+  GFX_BUFFER_DRAW_INDIRECT     = 4 << 3,
+
+  /// A shader storage buffer that compute (and any other) shaders can read from and write to.
+  GFX_BUFFER_SHADER_STORAGE    = 4 << 4,
+  
+  /// A buffer of `GfxDispatchIndirectCommand`s to be used in an indirect dispatch command.
+  GFX_BUFFER_DISPATCH_INDIRECT = 4 << 5,
 };
 /// GfxBufferType
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1184,6 +1235,16 @@ enum GfxBufferUsage {
   /// Set the buffer to be statically read from.
   /// This will be used for reading from the buffer once or rarely.
   GFX_BUFFER_USAGE_STATIC_READ  = 5 << 3,
+
+  /// Set the buffer to be a persistently mapped ring of `RING_BUFFER_FRAMES` partitions.
+  /// This will be used for data that gets rewritten every frame.
+  ///
+  /// @NOTE: Each frame writes into its own partition, so the GPU can keep reading 
+  /// the previous frames without the CPU ever waiting on it or the driver copying. 
+  /// However, the contents of the buffer are only valid for the frame they were written in. 
+  /// Any data that is needed must be written again every frame. Only vertex, uniform, 
+  /// and shader storage buffers can use this mode.
+  GFX_BUFFER_USAGE_STREAM_RING  = 5 << 4,
 };
 /// GfxBufferUsage
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1277,6 +1338,9 @@ enum GfxTextureType {
   
   /// Creates a texture to be used as both the depth and stencil buffers.
   GFX_TEXTURE_DEPTH_STENCIL_TARGET = 8 << 4,
+  
+  /// Creates an array of 2D textures with the same size and format.
+  GFX_TEXTURE_2D_ARRAY             = 8 << 5,
 };
 /// GfxTextureType
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1305,6 +1369,24 @@ enum GfxTextureFormat {
   /// A format to be used with the depth and stencil buffers where 
   /// the depth buffer gets 24 bits and the stencil buffer gets 8 bits.
   GFX_TEXTURE_FORMAT_DEPTH_STENCIL_24_8 = 9 << 6,
+
+  /// A block-compressed (BC1/DXT1) red, green, blue, and 1-bit alpha texture format 
+  /// with 4 bits per pixel.
+  GFX_TEXTURE_FORMAT_BC1                = 9 << 7,
+  
+  /// A block-compressed (BC3/DXT5) red, green, blue, and alpha texture format 
+  /// with 8 bits per pixel.
+  GFX_TEXTURE_FORMAT_BC3                = 9 << 8,
+  
+  /// A block-compressed (BC4/RGTC1) red channel texture format with 4 bits per pixel.
+  GFX_TEXTURE_FORMAT_BC4                = 9 << 9,
+  
+  /// A block-compressed (BC5/RGTC2) red and green channel texture format with 8 bits per pixel.
+  GFX_TEXTURE_FORMAT_BC5                = 9 << 10,
+  
+  /// A block-compressed (BC7/BPTC) red, green, blue, and alpha texture format 
+  /// with 8 bits per pixel.
+  GFX_TEXTURE_FORMAT_BC7                = 9 << 11,
 };
 /// GfxTextureFromat
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1364,10 +1446,64 @@ enum GfxShaderType {
 
   /// A geometry shader.
   GFX_SHADER_GEOMETRY = 12 << 2,
+  
+  /// A compute shader.
+  GFX_SHADER_COMPUTE  = 12 << 3,
 };
 /// GfxShaderType
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxImageAccess
+enum GfxImageAccess {
+  /// The image can only be read from.
+  GFX_IMAGE_ACCESS_READ       = 18 << 0,
+  
+  /// The image can only be written to.
+  GFX_IMAGE_ACCESS_WRITE      = 18 << 1,
+  
+  /// The image can be both read from and written to.
+  GFX_IMAGE_ACCESS_READ_WRITE = 18 << 2,
+};
+/// GfxImageAccess
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxMemoryBarrier
+enum GfxMemoryBarrier {
+  /// Vertex data written by shaders will be visible to vertex fetches.
+  GFX_MEMORY_BARRIER_VERTEX_BUFFER  = 1 << 0,
+  
+  /// Index data written by shaders will be visible to indexed draw commands.
+  GFX_MEMORY_BARRIER_INDEX_BUFFER   = 1 << 1,
+  
+  /// Uniform buffers written by shaders will be visible to uniform blocks.
+  GFX_MEMORY_BARRIER_UNIFORM_BUFFER = 1 << 2,
+  
+  /// Storage buffers written by shaders will be visible to other shaders.
+  GFX_MEMORY_BARRIER_STORAGE_BUFFER = 1 << 3,
+  
+  /// Images written by shaders will be visible to texture sampling.
+  GFX_MEMORY_BARRIER_TEXTURE_FETCH  = 1 << 4,
+  
+  /// Images written by shaders will be visible to other image loads and stores.
+  GFX_MEMORY_BARRIER_IMAGE_ACCESS   = 1 << 5,
+  
+  /// Indirect commands written by shaders will be visible to indirect draws and dispatches.
+  GFX_MEMORY_BARRIER_COMMAND        = 1 << 6,
+  
+  /// Buffers written by shaders will be visible to buffer updates and reads.
+  GFX_MEMORY_BARRIER_BUFFER_UPDATE  = 1 << 7,
+  
+  /// Textures written by shaders will be visible to texture updates and reads.
+  GFX_MEMORY_BARRIER_TEXTURE_UPDATE = 1 << 8,
+
+  /// Every previous write will be visible to everything after the barrier.
+  GFX_MEMORY_BARRIER_ALL            = 1 << 9,
+};
+/// GfxMemoryBarrier
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxContext
 struct GfxContext; 
@@ -1404,6 +1540,30 @@ struct GfxPipeline;
 /// GfxPipeline
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxComputePipeline
+struct GfxComputePipeline;
+/// GfxComputePipeline
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxReadback
+struct GfxReadback;
+/// GfxReadback
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxSampler
+struct GfxSampler;
+/// GfxSampler
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxCommandList
+struct GfxCommandList;
+/// GfxCommandList
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxDepthDesc
 struct GfxDepthDesc {
@@ -1551,6 +1711,12 @@ struct GfxContextDesc {
   /// @NOTE: Check `GfxCullDesc` to know the default values
   /// of each member.
   GfxCullDesc cull_desc         = {};
+
+  /// The directory where linked shader programs get cached, keyed 
+  /// by their sources and the driver that compiled them. 
+  ///
+  /// @NOTE: By default, this is set to `nullptr`, which disables the cache.
+  const i8* shader_cache_dir    = nullptr;
 };
 /// GfxContextDesc 
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1581,6 +1747,12 @@ struct GfxShaderDesc {
 
   /// The full source code for the pixel/fragment shader. 
   const i8* pixel_source  = nullptr;
+
+  /// The full source code for the compute shader. 
+  ///
+  /// @NOTE: If this is set, the shader will be a compute shader and 
+  /// both `vertex_source` and `pixel_source` _must_ be left as `nullptr`.
+  const i8* compute_source = nullptr;
 };
 /// GfxShaderDesc
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1632,13 +1804,15 @@ struct GfxTextureDesc {
   
   /// The depth on the Z-axis of the texture. 
   ///
-  /// If the texture `type` is anything other than `GFX_TEXTURE_3D`, 
+  /// If the texture `type` is `GFX_TEXTURE_2D_ARRAY`, `depth` is the amount of layers in the array.
+  /// If the texture `type` is anything other than `GFX_TEXTURE_3D` or `GFX_TEXTURE_2D_ARRAY`, 
   /// the `depth` member will be ignored.
   u32 depth;
 
-  /// The mipmap level of the texture. 
+  /// The amount of mipmap levels of the texture. 
   ///
-  /// @NOTE: Leave this as `1` if the mipmap levels are not important.
+  /// @NOTE: Leave this as `0` to allocate the full mip chain down to `1x1`. 
+  /// Set it to `1` if the mipmap levels are not important.
   u32 mips; 
 
   /// The type of the texture to be used.
@@ -1652,9 +1826,30 @@ struct GfxTextureDesc {
 
   /// The addressing mode of the texture.
   GfxTextureWrap wrap_mode;
+
+  /// The amount of MSAA samples per pixel. 
+  ///
+  /// @NOTE: This is only used by `GFX_TEXTURE_RENDER_TARGET` and 
+  /// `GFX_TEXTURE_DEPTH_STENCIL_TARGET`. Multisampled targets cannot 
+  /// have any mipmaps, nor can they be filtered when sampled.
+  u32 samples = 1;
   
   /// The pixels that will be sent to the GPU.
+  ///
+  /// @NOTE: For any of the block-compressed formats (`GFX_TEXTURE_FORMAT_BC*`), 
+  /// `data` holds the compressed 4x4 blocks rather than raw pixels.
   void* data = nullptr;
+
+  /// If this is `true`, `data` holds every mip level of the texture, 
+  /// packed tightly one after the other starting from level `0`. 
+  ///
+  /// @NOTE: For `GFX_TEXTURE_2D_ARRAY`, each level in `data` holds that level 
+  /// of every layer, one layer after the other.
+  ///
+  /// @NOTE: If this is `false`, only level `0` will be read from `data` 
+  /// and the rest of the mip chain will be generated on the GPU. Block-compressed 
+  /// textures cannot be generated on the GPU, so they will only get level `0`.
+  bool data_has_mips = false;
 };
 /// GfxTextureDesc
 ///---------------------------------------------------------------------------------------------------------------------
@@ -1688,6 +1883,38 @@ struct GfxCubemapDesc {
 /// GfxCubemapDesc
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxSamplerDesc
+struct GfxSamplerDesc {
+  /// The filter to be used when a texture is magnified or minified.
+  GfxTextureFilter filter  = GFX_TEXTURE_FILTER_MIN_MAG_LINEAR;
+
+  /// The addressing mode on all the axes of a texture.
+  GfxTextureWrap wrap_mode = GFX_TEXTURE_WRAP_REPEAT;
+
+  /// The color to be used with `GFX_TEXTURE_WRAP_BORDER_COLOR`.
+  ///
+  /// @NOTE: This is `{0, 0, 0, 0}` by default.
+  f32 border_color[4]      = {0, 0, 0, 0};
+
+  /// The maximum amount of anisotropy to apply. 
+  ///
+  /// @NOTE: This is `1` (no anisotropy) by default and will be 
+  /// clamped to the maximum amount the GPU supports.
+  f32 max_anisotropy       = 1.0f;
+
+  /// The range of mip levels that can be sampled. 
+  ///
+  /// @NOTE: By default, the whole mip chain can be sampled.
+  f32 min_lod              = -1000.0f;
+  f32 max_lod              = 1000.0f;
+
+  /// The bias added to the computed mip level. 
+  f32 lod_bias             = 0.0f;
+};
+/// GfxSamplerDesc
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxPipelineDesc
 struct GfxPipelineDesc {
@@ -1699,6 +1926,12 @@ struct GfxPipelineDesc {
 
   /// The amount of vertices in the `vertex_buffer` to be drawn. 
   sizei vertices_count               = 0;
+
+  /// The offset (in vertices) of the first vertex in `vertex_buffer`. 
+  ///
+  /// @NOTE: In a `draw_index` command, this gets added to every index (i.e, the base vertex). 
+  /// This allows many pipelines to share one big vertex buffer with the same layout.
+  sizei vertices_offset              = 0;
   
   /// The index buffer to be used in a `draw_index` command.
   ///
@@ -1709,6 +1942,9 @@ struct GfxPipelineDesc {
   /// The amount of indices in the `index_buffer` to be drawn.
   sizei indices_count                = 0;
 
+  /// The offset (in indices) of the first index in `index_buffer`.
+  sizei indices_offset               = 0;
+
   /// The shader to be used in the draw command.
   GfxShader* shader                  = nullptr;
   
@@ -1718,6 +1954,22 @@ struct GfxPipelineDesc {
   /// The amount of layouts to be set in `layout`.
   sizei layout_count                 = 0; 
 
+  /// The buffer holding the per-instance data to be used in 
+  /// an `*_instanced` draw command.
+  ///
+  /// @NOTE: This can be left as `nullptr` if no per-instance data is needed.
+  GfxBuffer* instance_buffer         = nullptr;
+
+  /// Layout array up to `LAYOUT_ELEMENTS_MAX` describing each attribute in `instance_buffer`.
+  ///
+  /// @NOTE: The attributes in this array take the locations right after 
+  /// the ones in `layout`. The `instance_rate` of the first element will 
+  /// be used for the whole buffer, and if it is `0`, it will be treated as `1`.
+  GfxLayoutDesc instance_layout[LAYOUT_ELEMENTS_MAX];
+
+  /// The amount of layouts to be set in `instance_layout`.
+  sizei instance_layout_count        = 0;
+
   /// The draw mode of the entire pipeline.
   ///
   /// @NOTE: This can be changed at anytime before the draw command.
@@ -1734,6 +1986,16 @@ struct GfxPipelineDesc {
 
   /// The amount of textures to be used in `textures`.
   sizei textures_count               = 0;
+
+  /// Array of samplers up to `TEXTURES_MAX` to be used in a draw command. 
+  /// The sampler at index `i` will be used to sample the texture at index `i`.
+  ///
+  /// @NOTE: Any texture without a sampler (or with a `nullptr` sampler) 
+  /// will be sampled using its own `filter` and `wrap_mode`.
+  GfxSampler* samplers[TEXTURES_MAX] = {nullptr};
+
+  /// The amount of samplers to be used in `samplers`.
+  sizei samplers_count               = 0;
  
   /// A flag to indicate if the pipeline can 
   /// or cannot write to the depth buffer. 
@@ -1763,6 +2025,111 @@ struct GfxPipelineDesc {
 /// GfxPipelineDesc
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxDrawIndirectCommand
+struct GfxDrawIndirectCommand {
+  /// The amount of indices to be drawn.
+  u32 indices_count; 
+
+  /// The amount of instances to be drawn. 
+  ///
+  /// @NOTE: Set this to `1` for a normal, non-instanced draw.
+  u32 instance_count; 
+
+  /// The offset (in indices) into the index buffer of the first index.
+  u32 first_index; 
+
+  /// A value that will be added to each index before 
+  /// fetching the vertex from the vertex buffer.
+  i32 base_vertex; 
+
+  /// The first instance to be fetched from the instance buffer.
+  u32 base_instance;
+};
+/// GfxDrawIndirectCommand
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxDispatchIndirectCommand
+struct GfxDispatchIndirectCommand {
+  /// The amount of work groups to dispatch on each axis.
+  u32 groups_x; 
+  u32 groups_y; 
+  u32 groups_z;
+};
+/// GfxDispatchIndirectCommand
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxReadbackDesc
+struct GfxReadbackDesc {
+  /// The dimensions of the last read pixels.
+  u32 width  = 0; 
+  u32 height = 0;
+
+  /// The format of the last read pixels.
+  GfxTextureFormat format = GFX_TEXTURE_FORMAT_RGBA8;
+
+  /// The size in bytes of the last read pixels.
+  ///
+  /// @NOTE: Rows are tightly packed and start from the _bottom_ of the image.
+  sizei size = 0;
+};
+/// GfxReadbackDesc
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxImageDesc
+struct GfxImageDesc {
+  /// The texture to be accessed as an image. 
+  ///
+  /// @NOTE: The texture cannot be of a block-compressed format.
+  GfxTexture* texture   = nullptr;
+
+  /// How the shader will access the image. 
+  ///
+  /// @NOTE: This is `GFX_IMAGE_ACCESS_READ_WRITE` by default.
+  GfxImageAccess access = GFX_IMAGE_ACCESS_READ_WRITE;
+
+  /// The mip level of `texture` to be accessed.
+  u32 mip_level         = 0;
+};
+/// GfxImageDesc
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxComputePipelineDesc
+struct GfxComputePipelineDesc {
+  /// The compute shader to be used in a dispatch command.
+  ///
+  /// @NOTE: This shader _must_ be created with a `compute_source`.
+  GfxShader* shader = nullptr;
+
+  /// Array of shader storage buffers up to `STORAGE_BUFFERS_MAX`. 
+  /// The buffer at index `i` will be bound to the storage binding point `i`. 
+  ///
+  /// @NOTE: Each buffer _must_ be of type `GFX_BUFFER_SHADER_STORAGE`.
+  GfxBuffer* storage_buffers[STORAGE_BUFFERS_MAX] = {nullptr};
+
+  /// The amount of buffers to be used in `storage_buffers`.
+  sizei storage_buffers_count                     = 0;
+
+  /// Array of images up to `IMAGES_MAX`. 
+  /// The image at index `i` will be bound to the image unit `i`.
+  GfxImageDesc images[IMAGES_MAX];
+
+  /// The amount of images to be used in `images`.
+  sizei images_count                              = 0;
+
+  /// Array of textures up to `TEXTURES_MAX` to be sampled in a dispatch command. 
+  GfxTexture* textures[TEXTURES_MAX]              = {nullptr};
+
+  /// The amount of textures to be used in `textures`.
+  sizei textures_count                            = 0;
+};
+/// GfxComputePipelineDesc
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Context functions 
 
@@ -1821,6 +2188,51 @@ NIKOLA_API void gfx_context_apply_pipeline(GfxContext* gfx, GfxPipeline* pipelin
 /// @NOTE: This function will be affected by vsync. 
 NIKOLA_API void gfx_context_present(GfxContext* gfx);
 
+/// Retrieve the amount of redundant graphics API calls skipped by `gfx` so far.
+///
+/// @NOTE: The context keeps a cache of the currently bound shaders, vertex arrays, textures,
+/// framebuffers, and masks. Any request to bind or set a value that is already active
+/// will be skipped and counted instead.
+NIKOLA_API const u64 gfx_context_get_saved_calls(GfxContext* gfx);
+
+/// Retrieve the alignment (in bytes) any offset into a uniform or shader storage buffer has to follow.
+NIKOLA_API const sizei gfx_context_get_uniform_alignment(GfxContext* gfx);
+
+/// Make any writes done by shaders before this call visible to the operations in `barriers` after it. 
+/// `barriers` is a bitwise ORed value from `GfxMemoryBarrier`. 
+///
+/// @NOTE: Writes to storage buffers and images are not ordered with anything else. So a barrier 
+/// is needed between, say, a dispatch that writes to a buffer and a draw that reads from it.
+NIKOLA_API void gfx_context_memory_barrier(GfxContext* gfx, const u32 barriers);
+
+/// Retrieve a render target with the size, format, type, and samples of `desc` from the pool of `gfx`.
+///
+/// @NOTE: The `type` of `desc` must either be `GFX_TEXTURE_RENDER_TARGET` or `GFX_TEXTURE_DEPTH_STENCIL_TARGET`.
+/// The target only belongs to the caller until the next `gfx_context_present`, after which it 
+/// goes back into the pool to be handed out again. Its contents are undefined when retrieved, and it 
+/// must never be destroyed or updated by the caller. Targets that stay unused for `TRANSIENT_TARGET_FRAMES` 
+/// frames are destroyed to give their memory back.
+NIKOLA_API GfxTexture* gfx_context_acquire_target(GfxContext* gfx, const GfxTextureDesc& desc);
+
+/// Render into the `colors_count` targets of `colors` and the `depth_stencil` target with 
+/// every following clear and draw call of `gfx` that uses `GFX_CONTEXT_FLAGS_CUSTOM_RENDER_TARGET`.
+/// The viewport will also be set to the size of the targets.
+///
+/// @NOTE: `colors` can have up to `RENDER_TARGETS_MAX` targets of type `GFX_TEXTURE_RENDER_TARGET`, 
+/// and `depth_stencil` can be set to `nullptr` to be ignored. All of the targets must be of the 
+/// same size and samples. Setting no targets at all will go back to rendering into the window, 
+/// while `GFX_CONTEXT_FLAGS_CUSTOM_RENDER_TARGET` will then use the render targets created with `gfx_texture_create`.
+///
+/// @NOTE: A framebuffer is created and cached for each unique set of targets, so switching 
+/// back and forth between the same sets is cheap.
+NIKOLA_API void gfx_context_set_targets(GfxContext* gfx, GfxTexture** colors, const sizei colors_count, GfxTexture* depth_stencil);
+
+/// Execute every command recorded in `list` in the order they were recorded.
+///
+/// @NOTE: This function _must_ be called on the same thread `gfx` was created on. 
+/// Recording into `list` has to be finished before it gets submitted.
+NIKOLA_API void gfx_context_submit(GfxContext* gfx, GfxCommandList* list);
+
 /// Context functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -1839,6 +2251,13 @@ NIKOLA_API GfxBufferDesc& gfx_buffer_get_desc(GfxBuffer* buffer);
 /// Update the contents of `buff` starting at `offset` with `data` of size `size`.
 NIKOLA_API void gfx_buffer_update(GfxBuffer* buff, const sizei offset, const sizei size, const void* data);
 
+/// Bind only the range of `size` bytes starting at `offset` in the uniform or shader storage buffer `buff` to `bind_point`. 
+/// This is useful to pack the data of many draw calls into one big buffer and point each draw call 
+/// to its own region.
+///
+/// @NOTE: The `offset` _must_ be a multiple of `gfx_context_get_uniform_alignment`.
+NIKOLA_API void gfx_buffer_bind_range(GfxBuffer* buff, const u32 bind_point, const sizei offset, const sizei size);
+
 /// Buffer functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -1865,8 +2284,22 @@ NIKOLA_API void gfx_shader_attach_uniform(GfxShader* shader, const GfxShaderType
 /// Only for GLSL (OpenGL), retrieve the location of the `uniform_name` in the `shader`.
 ///
 /// @NOTE: If `uniform_name` is not found within `shader`, the function will return `-1`.
+/// The active uniforms of `shader` are reflected once when it is created, so this is only 
+/// a lookup into a sorted table rather than a query to the driver. Arrays can be found by 
+/// their bare name (i.e `u_lights` rather than `u_lights[0]`).
 NIKOLA_API i32 gfx_glsl_get_uniform_location(GfxShader* shader, const i8* uniform_name);
 
+/// Only for GLSL (OpenGL), retrieve the binding point of the uniform block `block_name` in the `shader`.
+///
+/// @NOTE: If `block_name` is not found within `shader`, the function will return `-1`.
+NIKOLA_API i32 gfx_glsl_get_uniform_block_binding(GfxShader* shader, const i8* block_name);
+
+/// Only for GLSL (OpenGL), retrieve the location of the vertex attribute `attribute_name` in the `shader`.
+///
+/// @NOTE: If `attribute_name` is not found within `shader`, the function will return `-1`.
+/// Matrix attributes report the location of their first column.
+NIKOLA_API i32 gfx_glsl_get_attribute_location(GfxShader* shader, const i8* attribute_name);
+
 /// Only for GLSL (OpenGL), upload a uniform array with `count` elements of type `type` with `data` at `location` to `shader`. 
 NIKOLA_API void gfx_glsl_upload_uniform_array(GfxShader* shader, const i32 location, const sizei count, const GfxLayoutType type, const void* data);
 
@@ -1890,9 +2323,17 @@ NIKOLA_API GfxTextureDesc& gfx_texture_get_desc(GfxTexture* texture);
 
 /// Update the `texture`'s information from the given `desc`.
 ///
-/// @NOTE: This will resend the pixels of `texture` to the GPU with the new information provided by `desc`.
+/// @NOTE: This will resend the pixels of `texture` to the GPU with the new information provided by `desc`. 
+/// Texture storage is immutable, so changing the size, format, type, or mip levels of `texture` will 
+/// recreate it internally. Any pipelines referencing `texture` will need to be updated afterwards.
 NIKOLA_API void gfx_texture_update(GfxTexture* texture, const GfxTextureDesc& desc);
 
+/// Only for `GFX_TEXTURE_2D_ARRAY`, update the pixels of the single `layer` in `texture` with `data`.
+///
+/// @NOTE: `data` holds only the level `0` pixels of the layer and will not be kept by `texture`. 
+/// If the texture was not given its mips, the rest of the mip chain will be generated again.
+NIKOLA_API void gfx_texture_update(GfxTexture* texture, const u32 layer, const void* data);
+
 /// Texture functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -1916,10 +2357,33 @@ NIKOLA_API void gfx_cubemap_update(GfxCubemap* cubemap, const GfxCubemapDesc& de
 /// Cubemap functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Sampler functions 
+
+/// Retrieve a `GfxSampler` matching the information provided by `desc`. 
+///
+/// @NOTE: Samplers are shared. If `gfx` already holds a sampler with the same `desc`, 
+/// that sampler will be returned instead of creating a new one. Each call to this function 
+/// _must_ be matched with a call to `gfx_sampler_destroy`.
+NIKOLA_API GfxSampler* gfx_sampler_create(GfxContext* gfx, const GfxSamplerDesc& desc);
+
+/// Release a reference to `sampler`, reclaiming its memory once no one else is using it.
+NIKOLA_API void gfx_sampler_destroy(GfxSampler* sampler);
+
+/// Retrieve the internal `GfxSamplerDesc` of `sampler`.
+///
+/// @NOTE: Since samplers are shared, the returned description cannot be changed.
+NIKOLA_API const GfxSamplerDesc& gfx_sampler_get_desc(GfxSampler* sampler);
+
+/// Sampler functions 
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Pipeline functions 
 
 /// Allocate and return a `GfxPipeline` from the information provided by `desc`.
+///
+/// @NOTE: Pipelines with the same layouts and buffers will share the same internal vertex state.
 NIKOLA_API GfxPipeline* gfx_pipeline_create(GfxContext* gfx, const GfxPipelineDesc& desc);
 
 /// Reclaim/free any memory allocated by `pipeline`.
@@ -1934,9 +2398,258 @@ NIKOLA_API void gfx_pipeline_draw_vertex(GfxPipeline* pipeline);
 /// Draw the contents of the `vertex_buffer` using the `index_buffer` in `pipeline`.
 NIKOLA_API void gfx_pipeline_draw_index(GfxPipeline* pipeline);
 
+/// Draw the contents of the `vertex_buffer` in `pipeline` `instance_count` times, 
+/// reading the per-instance data in `instance_buffer` starting from `base_instance`.
+NIKOLA_API void gfx_pipeline_draw_vertex_instanced(GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance = 0);
+
+/// Draw the contents of the `vertex_buffer` using the `index_buffer` in `pipeline` `instance_count` times, 
+/// reading the per-instance data in `instance_buffer` starting from `base_instance`.
+NIKOLA_API void gfx_pipeline_draw_index_instanced(GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance = 0);
+
+/// Draw `count` commands of type `GfxDrawIndirectCommand` in `indirect_buffer` using the 
+/// `vertex_buffer` and the `index_buffer` in `pipeline`, all in one call.
+///
+/// @NOTE: The `indirect_buffer` _must_ be of type `GFX_BUFFER_DRAW_INDIRECT`. Each command 
+/// in the buffer can draw any range of the `index_buffer`, so many meshes sharing the same 
+/// vertex layout and shader can be packed into the same buffers and drawn together.
+NIKOLA_API void gfx_pipeline_draw_indirect(GfxPipeline* pipeline, GfxBuffer* indirect_buffer, const sizei count);
+
 /// Pipeline functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Compute pipeline functions 
+
+/// Allocate and return a `GfxComputePipeline` from the information provided by `desc`.
+NIKOLA_API GfxComputePipeline* gfx_compute_pipeline_create(GfxContext* gfx, const GfxComputePipelineDesc& desc);
+
+/// Reclaim/free any memory allocated by `pipeline`.
+NIKOLA_API void gfx_compute_pipeline_destroy(GfxComputePipeline* pipeline);
+
+/// Retrieve the internal `GfxComputePipelineDesc` of `pipeline`. 
+///
+/// @NOTE: The buffers, images, and textures are bound on every dispatch, 
+/// so any changes made to them through here will take effect on the next dispatch.
+NIKOLA_API GfxComputePipelineDesc& gfx_compute_pipeline_get_desc(GfxComputePipeline* pipeline);
+
+/// Dispatch `groups_x * groups_y * groups_z` work groups of the compute shader in `pipeline`.
+NIKOLA_API void gfx_compute_dispatch(GfxComputePipeline* pipeline, const u32 groups_x, const u32 groups_y = 1, const u32 groups_z = 1);
+
+/// Dispatch the work groups described by the `GfxDispatchIndirectCommand` found 
+/// at `offset` bytes into `indirect_buffer` using the compute shader in `pipeline`.
+///
+/// @NOTE: The `indirect_buffer` _must_ be of type `GFX_BUFFER_DISPATCH_INDIRECT`.
+NIKOLA_API void gfx_compute_dispatch_indirect(GfxComputePipeline* pipeline, GfxBuffer* indirect_buffer, const sizei offset = 0);
+
+/// Compute pipeline functions 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Readback functions 
+
+/// Allocate and return a `GfxReadback` that pixels can be asynchronously read into. 
+///
+/// @NOTE: The internal storage will grow as needed with each new read.
+NIKOLA_API GfxReadback* gfx_readback_create(GfxContext* gfx);
+
+/// Reclaim/free any memory allocated by `readback`.
+NIKOLA_API void gfx_readback_destroy(GfxReadback* readback);
+
+/// Retrieve the internal `GfxReadbackDesc` of `readback`, describing the last read pixels.
+NIKOLA_API const GfxReadbackDesc& gfx_readback_get_desc(GfxReadback* readback);
+
+/// Return `true` if `readback` has a read that was not yet retrieved by `gfx_readback_poll`.
+NIKOLA_API const bool gfx_readback_is_pending(GfxReadback* readback);
+
+/// Check if the pending read of `readback` is done without waiting for the GPU. 
+/// If it is, copy the pixels into `data` and return `true`. Otherwise, return `false`.
+///
+/// @NOTE: `data` _must_ be able to hold at least `size` bytes from `gfx_readback_get_desc`. 
+/// Reads are usually polled a few frames after being issued, by which point the GPU would 
+/// have finished them. Polling right after the read is allowed but will most likely return `false`.
+NIKOLA_API const bool gfx_readback_poll(GfxReadback* readback, void* data);
+
+/// Start reading the level `0` pixels of `texture` into `readback` without waiting for the GPU. 
+///
+/// @NOTE: The `texture` cannot be compressed or of type `GFX_TEXTURE_DEPTH_STENCIL_TARGET`. 
+/// Any previous read in `readback` that was not polled yet will be discarded.
+NIKOLA_API void gfx_texture_read_async(GfxTexture* texture, GfxReadback* readback);
+
+/// Start reading the color pixels of the current framebuffer into `readback` without waiting for the GPU. 
+///
+/// @NOTE: This is usually called before `gfx_context_present` to capture the frame that is about to be shown. 
+/// The pixels are read in the `pixel_format` of the context.
+NIKOLA_API void gfx_context_read_async(GfxContext* gfx, GfxReadback* readback);
+
+/// Start reading the contents of `buff` into `readback` without waiting for the GPU. 
+///
+/// @NOTE: The bytes are described as a single row of `GFX_TEXTURE_FORMAT_R8` pixels, 
+/// with a `width` of `size` bytes. Ring buffers only read back their current partition. 
+/// Writes done by compute shaders need a `GFX_MEMORY_BARRIER_BUFFER_UPDATE` barrier before the read.
+NIKOLA_API void gfx_buffer_read_async(GfxBuffer* buff, GfxReadback* readback);
+
+/// Readback functions 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Command list functions 
+
+/// Allocate and return a `GfxCommandList` that can record commands to be submitted to `gfx` later. 
+/// The list will reserve `initial_size` bytes for its commands up front and grow as needed.
+///
+/// @NOTE: None of the recording functions touch the graphics API, so any thread can record into a list. 
+/// However, a single list should only be recorded into by one thread at a time. To build commands in 
+/// parallel, give each thread its own list and submit them in order with `gfx_context_submit`.
+NIKOLA_API GfxCommandList* gfx_command_list_create(GfxContext* gfx, const sizei initial_size = 0);
+
+/// Reclaim/free any memory allocated by `list`.
+NIKOLA_API void gfx_command_list_destroy(GfxCommandList* list);
+
+/// Remove all the commands recorded in `list`, keeping its memory around for the next recording.
+NIKOLA_API void gfx_command_list_reset(GfxCommandList* list);
+
+/// Retrieve the amount of commands currently recorded in `list`.
+NIKOLA_API const sizei gfx_command_list_get_count(GfxCommandList* list);
+
+/// Record a `gfx_context_clear` command into `list`.
+NIKOLA_API void gfx_command_list_clear(GfxCommandList* list, const f32 r, const f32 g, const f32 b, const f32 a, const u32 flags);
+
+/// Record a `gfx_context_apply_pipeline` command into `list`.
+///
+/// @NOTE: `pipe_desc` is copied into `list`, so it can be changed right after this call.
+NIKOLA_API void gfx_command_list_apply_pipeline(GfxCommandList* list, GfxPipeline* pipeline, const GfxPipelineDesc& pipe_desc);
+
+/// Record a `gfx_buffer_update` command into `list`.
+///
+/// @NOTE: The `size` bytes of `data` are copied into `list`, so `data` does not need to outlive this call.
+NIKOLA_API void gfx_command_list_update_buffer(GfxCommandList* list, GfxBuffer* buff, const sizei offset, const sizei size, const void* data);
+
+/// Record a `gfx_buffer_bind_range` command into `list`.
+NIKOLA_API void gfx_command_list_bind_range(GfxCommandList* list, GfxBuffer* buff, const u32 bind_point, const sizei offset, const sizei size);
+
+/// Only for GLSL (OpenGL), record a `gfx_glsl_upload_uniform` command into `list`. 
+///
+/// @NOTE: The value in `data` is copied into `list`.
+NIKOLA_API void gfx_command_list_upload_uniform(GfxCommandList* list, GfxShader* shader, const i32 location, const GfxLayoutType type, const void* data);
+
+/// Record a `gfx_pipeline_draw_vertex` command into `list`. 
+/// If `instance_count` is greater than `1` or `base_instance` is set, `gfx_pipeline_draw_vertex_instanced` will be used instead.
+NIKOLA_API void gfx_command_list_draw_vertex(GfxCommandList* list, GfxPipeline* pipeline, const sizei instance_count = 1, const u32 base_instance = 0);
+
+/// Record a `gfx_pipeline_draw_index` command into `list`.
+/// If `instance_count` is greater than `1` or `base_instance` is set, `gfx_pipeline_draw_index_instanced` will be used instead.
+NIKOLA_API void gfx_command_list_draw_index(GfxCommandList* list, GfxPipeline* pipeline, const sizei instance_count = 1, const u32 base_instance = 0);
+
+/// Record a `gfx_pipeline_draw_indirect` command into `list`.
+NIKOLA_API void gfx_command_list_draw_indirect(GfxCommandList* list, GfxPipeline* pipeline, GfxBuffer* indirect_buffer, const sizei count);
+
+/// Command list functions 
+///---------------------------------------------------------------------------------------------------------------------
+
+#ifdef NIKOLA_GFX_CONTEXT_NULL // Null check
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxCallType
+enum GfxCallType {
+  GFX_CALL_CONTEXT_SET_STATE = 0,
+  GFX_CALL_CONTEXT_CLEAR,
+  GFX_CALL_CONTEXT_APPLY_PIPELINE,
+  GFX_CALL_CONTEXT_PRESENT,
+
+  GFX_CALL_BUFFER_CREATE,
+  GFX_CALL_BUFFER_DESTROY,
+  GFX_CALL_BUFFER_UPDATE,
+  GFX_CALL_BUFFER_BIND_RANGE,
+
+  GFX_CALL_SHADER_CREATE,
+  GFX_CALL_SHADER_DESTROY,
+  GFX_CALL_SHADER_ATTACH_UNIFORM,
+  GFX_CALL_SHADER_UPLOAD_UNIFORM,
+
+  GFX_CALL_TEXTURE_CREATE,
+  GFX_CALL_TEXTURE_DESTROY,
+  GFX_CALL_TEXTURE_UPDATE,
+  GFX_CALL_TEXTURE_UPDATE_LAYER,
+
+  GFX_CALL_CUBEMAP_CREATE,
+  GFX_CALL_CUBEMAP_DESTROY,
+  GFX_CALL_CUBEMAP_UPDATE,
+
+  GFX_CALL_PIPELINE_CREATE,
+  GFX_CALL_PIPELINE_DESTROY,
+  GFX_CALL_PIPELINE_DRAW_VERTEX,
+  GFX_CALL_PIPELINE_DRAW_INDEX,
+  GFX_CALL_PIPELINE_DRAW_INDIRECT,
+
+  GFX_CALL_SAMPLER_CREATE,
+  GFX_CALL_SAMPLER_DESTROY,
+
+  GFX_CALL_CONTEXT_MEMORY_BARRIER,
+  GFX_CALL_COMPUTE_CREATE,
+  GFX_CALL_COMPUTE_DESTROY,
+  GFX_CALL_COMPUTE_DISPATCH,
+  GFX_CALL_COMPUTE_DISPATCH_INDIRECT,
+
+  GFX_CALL_READBACK_CREATE,
+  GFX_CALL_READBACK_DESTROY,
+  GFX_CALL_TEXTURE_READ_ASYNC,
+  GFX_CALL_CONTEXT_READ_ASYNC,
+  GFX_CALL_BUFFER_READ_ASYNC,
+
+  GFX_CALL_CONTEXT_ACQUIRE_TARGET,
+  GFX_CALL_CONTEXT_SET_TARGETS,
+};
+/// GfxCallType
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxCallRecord
+///
+/// @NOTE: A record only describes a call, and not the descs, data or state that went along with it. 
+/// The log is only meant for counting and checking calls in headless runs and tests.
+/// To record commands and submit them again later, use a `GfxCommandList` instead.
+struct GfxCallRecord {
+  /// The `gfx_*` function that was called.
+  GfxCallType type;
+
+  /// The ID of the object the call was made on. 
+  ///
+  /// @NOTE: Calls made on the context itself will have an ID of `0`.
+  u32 object_id;
+
+  /// Any arguments of the call, like sizes, offsets, flags, or counts.
+  ///
+  /// @NOTE: The meaning of each argument depends on `type`. 
+  /// Unused arguments are left as `0`.
+  u64 args[2];
+};
+/// GfxCallRecord
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Null context functions 
+
+/// Start or stop recording every call made on `gfx` into its call log.
+///
+/// @NOTE: Recording is off by default.
+NIKOLA_API void gfx_context_set_recording(GfxContext* gfx, const bool record);
+
+/// Retrieve the calls recorded by `gfx` so far and set `count` to the amount of calls.
+///
+/// @NOTE: The returned array is owned by `gfx` and is only valid until the next call made on `gfx`.
+NIKOLA_API const GfxCallRecord* gfx_context_get_call_log(GfxContext* gfx, sizei* count);
+
+/// Empty the call log of `gfx`. This is usually done once per frame.
+NIKOLA_API void gfx_context_clear_call_log(GfxContext* gfx);
+
+/// Retrieve the amount of objects created with `gfx` that are still alive.
+NIKOLA_API const sizei gfx_context_get_live_objects(GfxContext* gfx);
+
+/// Null context functions 
+///---------------------------------------------------------------------------------------------------------------------
+
+#endif // Null check
+
 /// *** Graphics ***
 /// ---------------------------------------------------------------------
 
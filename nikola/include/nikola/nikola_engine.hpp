@@ -759,7 +759,7 @@ const u8 NBR_VALID_IDENTIFIER     = 107;
 const i16 NBR_VALID_MAJOR_VERSION = 0;
 
 /// The currently valid minor version of any `.nbr` file
-const i16 NBR_VALID_MINOR_VERSION = 1;
+const i16 NBR_VALID_MINOR_VERSION = 3;
 
 /// NBR consts
 ///---------------------------------------------------------------------------------------------------------------------
@@ -773,7 +773,20 @@ struct NBRTexture {
   /// The number of channel components per pixel.
   i8 channels; 
 
-  /// The raw pixel data.
+  /// The format of the data in `pixels`.
+  ///
+  /// @NOTE: This is either `GFX_TEXTURE_FORMAT_RGBA8` for raw pixels or 
+  /// one of the block-compressed formats (`GFX_TEXTURE_FORMAT_BC*`).
+  GfxTextureFormat format = GFX_TEXTURE_FORMAT_RGBA8;
+
+  /// The amount of mip levels stored in `pixels`, packed one 
+  /// after the other starting from level `0`.
+  u8 mips = 1;
+
+  /// The size in bytes of `pixels`.
+  u32 data_size = 0;
+
+  /// The raw pixel data or the compressed blocks.
   void* pixels = nullptr;
 };
 /// NBRTexture
@@ -859,6 +872,9 @@ struct NBRMesh {
   u32 indices_count; 
 
   /// An `unsigned int` array of the indices.
+  ///
+  /// @NOTE: The indices of every level of detail are packed one 
+  /// after the other, starting with the full mesh.
   u32* indices;
 
   /// An index into the `matrices` array in `NBRModel`. 
@@ -866,6 +882,12 @@ struct NBRMesh {
   /// @NOTE: This value will be `0` if no materials are present 
   /// in this mesh. 
   u8 material_index;
+
+  /// The total number of levels of detail in `lod_indices_counts`.
+  u8 lods_count; 
+
+  /// The amount of indices of each level of detail in `indices`.
+  u32* lod_indices_counts;
 };
 /// NBRMesh 
 ///---------------------------------------------------------------------------------------------------------------------
@@ -894,6 +916,76 @@ struct NBRModel {
 /// NBRModel 
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// NBRGlyph 
+struct NBRGlyph {
+  /// The Unicode codepoint of the glyph.
+  i32 unicode;
+
+  /// The top-left corner and size of the glyph in the atlas, in pixels.
+  u16 atlas_x, atlas_y;
+  u16 width, height;
+
+  /// The offset from the pen on the baseline to the 
+  /// top-left corner of the glyph, in pixels.
+  f32 offset_x, offset_y;
+
+  /// The distance in pixels to move the pen after this glyph.
+  f32 advance_x;
+};
+/// NBRGlyph 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// NBRKerning 
+struct NBRKerning {
+  /// The codepoints of the pair of glyphs, in order.
+  i32 left, right;
+
+  /// The extra distance in pixels to move the pen in between the pair.
+  f32 amount;
+};
+/// NBRKerning 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// NBRFont 
+struct NBRFont {
+  /// The pixel height the glyphs were baked at. 
+  /// Every other metric is in pixels at this size.
+  f32 base_size;
+
+  /// The vertical metrics of the font.
+  f32 ascent, descent, line_gap;
+
+  /// The distance in pixels the signed distance field spreads out 
+  /// around the edges of each glyph.
+  f32 distance_range;
+
+  /// The total number of glyphs in `glyphs`.
+  u16 glyphs_count;
+
+  /// An array of `NBRGlyph`, sorted by their codepoints.
+  NBRGlyph* glyphs;
+
+  /// The total number of pairs in `kernings`.
+  u32 kernings_count;
+
+  /// An array of `NBRKerning` of every pair of glyphs with a non-zero kerning.
+  ///
+  /// @NOTE: This will be `nullptr` if the font has no kerning pairs.
+  NBRKerning* kernings;
+
+  /// The width and height of the atlas.
+  u32 atlas_width, atlas_height;
+
+  /// The single-channel distance field of every glyph, 
+  /// where the edge of a glyph sits at a value of `128`.
+  u8* atlas_pixels;
+};
+/// NBRFont 
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// NBRFile 
 struct NBRFile {
@@ -943,6 +1035,9 @@ NIKOLA_API void nbr_file_save(NBRFile& nbr, const NBRShader& shader, const FileP
 /// Save the given `model` at `path` using `nbr`'s information.
 NIKOLA_API void nbr_file_save(NBRFile& nbr, const NBRModel& model, const FilePath& path);
 
+/// Save the given `font` at `path` using `nbr`'s information.
+NIKOLA_API void nbr_file_save(NBRFile& nbr, const NBRFont& font, const FilePath& path);
+
 /// NBR file functions
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -965,10 +1060,77 @@ const sizei MATERIAL_UNIFORM_BUFFERS_MAX   = 2;
 const sizei MATERIAL_MATRICES_BUFFER_INDEX = 0;
 
 /// The index of the lighting uniform buffer within all materials.
+///
+/// @NOTE: The renderer fills this block every pass with the camera, the amount of queued lights, 
+/// and the layout of the light cluster grid, which shaders can declare as follows: 
+///
+/// layout (std140, binding = 1) uniform Lighting {
+///   mat4 u_inverse_view_projection;
+///   vec4 u_camera_position; // w = near
+///   vec4 u_camera_front;    // w = far
+///   vec4 u_ambient_light;
+///   ivec4 u_lights_count;   // x = all lights, y = directional lights
+///   ivec4 u_cluster_grid;   // xyz = clusters along each axis
+///   vec4 u_cluster_scale;   // xy = clusters per pixel, z = depth slice scale, w = depth slice bias
+/// };
 const sizei MATERIAL_LIGHTING_BUFFER_INDEX = 1;
 
+/// The index of the per-draw uniform buffer within all materials.
+///
+/// @NOTE: Shaders can declare this block to receive the model matrix and colors 
+/// of each draw call with a single buffer range bind instead of separate uniforms: 
+///
+/// layout (std140, binding = 2) uniform DrawData {
+///   mat4 u_model;
+///   vec4 u_ambient_color;
+///   vec4 u_diffuse_color;
+///   vec4 u_specular_color;
+/// };
+const sizei MATERIAL_DRAW_BUFFER_INDEX     = 2;
+
+/// The index of the lights storage buffer within all materials.
+///
+/// @NOTE: The directional lights always come first, followed by the point and spot lights. 
+/// The type of each light is stored in `direction_type.w` as 0 for point, 1 for spot, 
+/// and 2 for directional lights: 
+///
+/// struct Light {
+///   vec4 position_radius;
+///   vec4 direction_type;
+///   vec4 color_intensity;
+///   vec4 cone; // x = cosine of the inner cone, y = cosine of the outer cone
+/// };
+///
+/// layout (std430, binding = 0) readonly buffer Lights {
+///   Light u_lights[];
+/// };
+const sizei MATERIAL_LIGHTS_BUFFER_INDEX        = 0;
+
+/// The index of the light clusters storage buffer within all materials.
+///
+/// @NOTE: The view of the camera is split into a grid of clusters, tiled across the screen and 
+/// sliced exponentially along the view depth. Each cluster holds the offset and count of 
+/// the point and spot lights touching it in the light indices buffer, so a shader only has 
+/// to evaluate those on top of the directional lights: 
+///
+/// layout (std430, binding = 1) readonly buffer Clusters {
+///   uvec2 u_clusters[]; // x = offset, y = count
+/// };
+///
+/// layout (std430, binding = 2) readonly buffer LightIndices {
+///   uint u_light_indices[];
+/// };
+///
+/// ivec3 cell    = ivec3(gl_FragCoord.xy * u_cluster_scale.xy, log(view_depth) * u_cluster_scale.z + u_cluster_scale.w);
+/// cell          = clamp(cell, ivec3(0), u_cluster_grid.xyz - 1);
+/// uvec2 cluster = u_clusters[cell.x + (cell.y * u_cluster_grid.x) + (cell.z * u_cluster_grid.x * u_cluster_grid.y)];
+const sizei MATERIAL_CLUSTERS_BUFFER_INDEX      = 1;
+
+/// The index of the light indices storage buffer within all materials.
+const sizei MATERIAL_LIGHT_INDICES_BUFFER_INDEX = 2;
+
 /// The maximum amount of preset uniforms. 
-const u32 MATERIAL_UNIFORMS_MAX           = 4;
+const u32 MATERIAL_UNIFORMS_MAX           = 6;
 
 /// The name of the ambient color uniform in materials. 
 #define MATERIAL_UNIFORM_AMBIENT_COLOR  "u_ambient_color" 
@@ -982,6 +1144,32 @@ const u32 MATERIAL_UNIFORMS_MAX           = 4;
 /// The name of the model transform uniform in materials. 
 #define MATERIAL_UNIFORM_MODEL_MATRIX   "u_model" 
 
+/// The name of the diffuse map layer uniform in materials. 
+///
+/// @NOTE: Both layer uniforms are uploaded as `GFX_LAYOUT_INT1`, so shaders 
+/// must declare them as `int` (not `uint`) to match.
+#define MATERIAL_UNIFORM_DIFFUSE_LAYER  "u_diffuse_layer" 
+
+/// The name of the specular map layer uniform in materials. 
+#define MATERIAL_UNIFORM_SPECULAR_LAYER "u_specular_layer" 
+
+/// The name of the per-instance model matrix attribute in materials. 
+///
+/// @NOTE: Shaders that declare this `mat4` attribute at the location right after 
+/// the attributes of the mesh (i.e `layout (location = 3) in mat4 aInstanceModel;` for 
+/// a `VERTEX_TYPE_PNUV` mesh) will have identical commands merged into instanced draws 
+/// by the renderer. It should be used in place of `u_model` in such shaders.
+#define MATERIAL_ATTRIBUTE_INSTANCE_MODEL "aInstanceModel"
+
+/// The size (in bytes) of each shared vertex buffer that meshes get packed into.
+const sizei GEOMETRY_VERTEX_BUFFER_SIZE    = 16 * 1024 * 1024;
+
+/// The size (in bytes) of each shared index buffer that meshes get packed into.
+const sizei GEOMETRY_INDEX_BUFFER_SIZE     = 4 * 1024 * 1024;
+
+/// The maximum amount of levels of detail a mesh can have, including the full mesh.
+const sizei MESH_LODS_MAX                  = 4;
+
 /// Resources consts
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -1033,6 +1221,32 @@ enum MeshType {
 /// MeshType
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// MaterialSlot
+///
+/// @NOTE: Each slot is the index of one of the `MATERIAL_UNIFORM_*` uniforms in `Material::uniform_locations`.
+enum MaterialSlot {
+  /// The slot of `MATERIAL_UNIFORM_AMBIENT_COLOR`.
+  MATERIAL_SLOT_AMBIENT_COLOR = 0,
+  
+  /// The slot of `MATERIAL_UNIFORM_DIFFUSE_COLOR`.
+  MATERIAL_SLOT_DIFFUSE_COLOR,
+  
+  /// The slot of `MATERIAL_UNIFORM_SPECULAR_COLOR`.
+  MATERIAL_SLOT_SPECULAR_COLOR,
+  
+  /// The slot of `MATERIAL_UNIFORM_MODEL_MATRIX`.
+  MATERIAL_SLOT_MODEL_MATRIX,
+  
+  /// The slot of `MATERIAL_UNIFORM_DIFFUSE_LAYER`.
+  MATERIAL_SLOT_DIFFUSE_LAYER,
+  
+  /// The slot of `MATERIAL_UNIFORM_SPECULAR_LAYER`.
+  MATERIAL_SLOT_SPECULAR_LAYER,
+};
+/// MaterialSlot
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// RenderableType 
 enum RenderableType {
@@ -1069,6 +1283,22 @@ struct Mesh {
   GfxPipeline* pipe         = nullptr;
   GfxPipelineDesc pipe_desc = {};
 
+  /// The local-space bounding box of the vertices. 
+  ///
+  /// @NOTE: Meshes created from bare buffers have no bounds and will never get culled.
+  Vec3 bounds_min, bounds_max;
+  bool has_bounds = false;
+
+  /// The range of indices of each level of detail, starting with the full mesh. 
+  /// Every level shares the vertices of the full mesh.
+  struct LOD {
+    sizei indices_offset; 
+    sizei indices_count;
+  };
+
+  LOD lods[MESH_LODS_MAX];
+  u8 lods_count = 0;
+
   ResourceStorage* storage_ref;
 };
 /// Mesh 
@@ -1079,6 +1309,11 @@ struct Mesh {
 struct Material {
   GfxTexture* diffuse_map  = nullptr;
   GfxTexture* specular_map = nullptr;
+  
+  /// The layers of the maps when they are `GFX_TEXTURE_2D_ARRAY` textures.
+  i32 diffuse_layer  = 0;
+  i32 specular_layer = 0;
+
   GfxShader* shader        = nullptr; 
   GfxBuffer* uniform_buffers[MATERIAL_UNIFORM_BUFFERS_MAX];
   
@@ -1086,7 +1321,10 @@ struct Material {
   Vec3 diffuse_color; 
   Vec3 specular_color;
   Mat4 model_matrix;
-  HashMap<String, i32> uniform_locations;
+
+  /// The locations of the preset uniforms in `shader`, indexed by `MaterialSlot`. 
+  /// A location of `-1` means the shader does not use that uniform.
+  i32 uniform_locations[MATERIAL_UNIFORMS_MAX];
 
   ResourceStorage* storage_ref;
 };
@@ -1114,6 +1352,10 @@ struct Model {
   DynamicArray<Material*> materials;
   DynamicArray<u8> material_indices;
 
+  /// The local-space bounding box enclosing all of the `meshes`.
+  Vec3 bounds_min, bounds_max;
+  bool has_bounds = false;
+
   ResourceStorage* storage_ref;
 };
 /// Model 
@@ -1123,22 +1365,33 @@ struct Model {
 /// Font 
 struct Font {
   struct Glyph {
-    i8 unicode; 
-    GfxTexture* texture = nullptr;
+    i32 unicode; 
 
-    u32 width, height;
-    u32 left, right, top, bottom;
+    /// The offset (xy) and size (zw) of the glyph in the atlas, in texture coordinates.
+    Vec4 texture_rect;
 
-    i32 offset_x, offset_y;
-    i32 advance_x, kern, left_bearing;
+    /// The size of the glyph and its offset from the pen on the baseline, in pixels at `base_size`.
+    Vec2 size, offset;
+
+    f32 advance_x;
   };
 
   f32 base_size;
   f32 ascent, descent, line_gap;
-  f32 glyph_padding;
+  f32 distance_range;
+
+  /// A single-channel distance field of every glyph.
+  GfxTexture* atlas = nullptr;
 
+  /// The glyphs of a contiguous range of codepoints, starting at `glyphs[0].unicode`.
+  ///
+  /// @NOTE: NBR currently bakes the printable ASCII range only (`32` to `126`).
   DynamicArray<Glyph> glyphs;
 
+  /// The kerning of every pair of glyphs with a non-zero kerning, 
+  /// keyed by `(left << 32) | right`.
+  HashMap<u64, f32> kernings;
+
   ResourceStorage* storage_ref;
 };
 /// Font 
@@ -1168,15 +1421,41 @@ NIKOLA_API void material_set_uniform(Material* mat, const i8* uniform_name, cons
 /// Set the data of the uniform buffer at `index` of the associated shader in `mat` to `buffer`
 NIKOLA_API void material_set_uniform_buffer(Material* mat, const sizei index, GfxBuffer* buffer);
 
-/// Go over all of the available uniforms in `uniform_locations` in `mat` and send the appropriate data.
+/// Go over all of the available uniform slots in `uniform_locations` in `mat` and send the appropriate data.
+///
+/// @NOTE: This will ONLY send the uniforms with the `MATERIAL_UNIFORM_*` constants that 
+/// the shader declares as plain uniforms. Shaders using the `MATERIAL_DRAW_BUFFER_INDEX` block 
+/// get that data from the renderer instead. The `material_set_uniform` functions, however, will send any other data.
 ///
-/// @NOTE: This will ONLY send the uniforms with the `MATERIAL_UNIFORM_*` constants.
-/// The `material_set_uniform` functions, however, will send any other data.
-NIKOLA_API void material_use(Material* mat);
+/// If `list` is given, the uniforms will be recorded into it instead of being sent right away.
+NIKOLA_API void material_use(Material* mat, GfxCommandList* list = nullptr);
 
 /// Material functions
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Font functions
+
+/// Retrieve the glyph of `codepoint` in `font`.
+///
+/// @NOTE: Codepoints that were not baked into `font` fall back to `?`, 
+/// and to the first glyph if even that is missing.
+NIKOLA_API const Font::Glyph& font_get_glyph(const Font* font, const i32 codepoint);
+
+/// Return `true` if the glyph of `codepoint` was baked into `font`.
+NIKOLA_API const bool font_has_glyph(const Font* font, const i32 codepoint);
+
+/// Retrieve the kerning in pixels at `base_size` between the `left` and `right` codepoints in `font`.
+NIKOLA_API const f32 font_get_kerning(const Font* font, const i32 left, const i32 right);
+
+/// Retrieve the width and height of the given `text` laid out with `font` at a pixel height of `size`.
+///
+/// @NOTE: Just like `batch_renderer_text`, any byte without a baked glyph is skipped.
+NIKOLA_API const Vec2 font_measure_text(const Font* font, const String& text, const f32 size);
+
+/// Font functions
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Resource manager functions
 
@@ -1219,12 +1498,15 @@ NIKOLA_API ResourceID resource_storage_push_texture(ResourceStorage* storage, co
 ///
 /// Default values: 
 ///   - `format` = `GFX_TEXTURE_FORMAT_RGBA8`.
-///   - `filter` = `GFX_TEXTURE_FILTER_MIN_MAG_NEAREST`.
+///   - `filter` = `GFX_TEXTURE_FILTER_MIN_TRILINEAR_MAG_NEAREST`.
 ///   - `wrap`   = `GFX_TEXTURE_WRAP_CLAMP`.
+///
+/// @NOTE: The texture will be created with its full mip chain. If the NBR file 
+/// holds pre-compressed blocks, the format stored in the file will be used instead of `format`.
 NIKOLA_API ResourceID resource_storage_push_texture(ResourceStorage* storage, 
                                                     const FilePath& nbr_path,
                                                     const GfxTextureFormat format = GFX_TEXTURE_FORMAT_RGBA8, 
-                                                    const GfxTextureFilter filter = GFX_TEXTURE_FILTER_MIN_MAG_NEAREST, 
+                                                    const GfxTextureFilter filter = GFX_TEXTURE_FILTER_MIN_TRILINEAR_MAG_NEAREST, 
                                                     const GfxTextureWrap wrap     = GFX_TEXTURE_WRAP_CLAMP);
 
 /// Allocate a new `GfxCubemap` using `desc`, store it in `storage`,
@@ -1273,6 +1555,28 @@ NIKOLA_API ResourceID resource_storage_push_mesh(ResourceStorage* storage,
 /// store it in `storage`, return a `ResourceID` to identified it. 
 NIKOLA_API ResourceID resource_storage_push_mesh(ResourceStorage* storage, const MeshType type);
 
+/// Allocate a new `Mesh` by packing `vertices` and `indices` into the shared 
+/// geometry buffers of `storage`, and return a `ResourceID` to identify it.
+///
+/// A `vertex_type` must be provided to calculate the stride, while `vertices_size` 
+/// is the size of `vertices` in bytes.
+///
+/// If `lods_count` is greater than `1`, `indices` holds the indices of every level of detail 
+/// one after the other, starting with the full mesh, and `lod_indices_counts` holds the amount 
+/// of indices of each one. Only the first `MESH_LODS_MAX` levels are kept.
+///
+/// @NOTE: Meshes of the same `vertex_type` end up in the same buffers, which lets them 
+/// share a single vertex array. Meshes bigger than `GEOMETRY_VERTEX_BUFFER_SIZE` or 
+/// `GEOMETRY_INDEX_BUFFER_SIZE` will get buffers of their own.
+NIKOLA_API ResourceID resource_storage_push_mesh(ResourceStorage* storage, 
+                                                 const VertexType vertex_type, 
+                                                 const void* vertices, 
+                                                 const sizei vertices_size, 
+                                                 const u32* indices, 
+                                                 const sizei indices_count, 
+                                                 const u32* lod_indices_counts = nullptr, 
+                                                 const sizei lods_count        = 0);
+
 /// Allocate a new `Material` using the textures `diffuse_id` and `specular_id`
 /// and the shader `shader_id`, store it in `storage`, and 
 /// return a `ResourceID` to identify it.
@@ -1291,7 +1595,22 @@ NIKOLA_API ResourceID resource_storage_push_skybox(ResourceStorage* storage, con
 
 /// Allocate a new `Model` using the `NBRModel` retrieved from the `nbr_path`, 
 /// store it in `storage`, and return a `ResourceID` to identify it.
-NIKOLA_API ResourceID resource_storage_push_model(ResourceStorage* storage, const FilePath& nbr_path);
+///
+/// If `pack_textures` is `true`, textures of the model with the same size and format will be packed 
+/// into `GFX_TEXTURE_2D_ARRAY` textures. Materials will then point to the array and keep the layer of their 
+/// maps in `diffuse_layer` and `specular_layer`, so meshes with different maps can share the same texture binding.
+///
+/// @NOTE: Textures with baked mips are never packed. Shaders used with packed models need to 
+/// sample a `sampler2DArray` using the `MATERIAL_UNIFORM_DIFFUSE_LAYER` and `MATERIAL_UNIFORM_SPECULAR_LAYER` uniforms.
+NIKOLA_API ResourceID resource_storage_push_model(ResourceStorage* storage, const FilePath& nbr_path, const bool pack_textures = false);
+
+/// Allocate a new `Font` using the `NBRFont` retrieved from the `nbr_path`, 
+/// store it in `storage`, and return a `ResourceID` to identify it.
+///
+/// @NOTE: The glyphs are baked into a single-channel signed distance field atlas, 
+/// which is pushed into `storage` as well. The atlas is sampled linearly and without mips, 
+/// so text can be drawn crisply at any size without re-rasterizing the glyphs.
+NIKOLA_API ResourceID resource_storage_push_font(ResourceStorage* storage, const FilePath& nbr_path);
 
 /// Retrieve `GfxBuffer` identified by `id` in `storage`. 
 ///
@@ -1359,6 +1678,88 @@ const f32 CAMERA_MAX_ZOOM    = 180.0f;
 /// Camera consts 
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Renderer consts 
+
+/// The maximum amount of commands the render queue can hold in one frame.
+const sizei RENDER_QUEUE_MAX = 4096;
+
+/// The maximum amount of lights the renderer can hold in one frame.
+const sizei LIGHTS_MAX       = 1024;
+
+/// The maximum amount of quads the batch renderer can draw in one draw call.
+///
+/// @NOTE: This is not a limit on the quads of a frame. Frames with more quads 
+/// than this just spread them over more vertex buffers.
+const sizei BATCH_QUADS_MAX    = 32768;
+
+/// The maximum amount of textures a single batch can sample from. 
+///
+/// @NOTE: The first one is always taken by a white texture for any untextured shapes.
+const sizei BATCH_TEXTURES_MAX = 16;
+
+/// Renderer consts 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// CaptureFormat 
+enum CaptureFormat {
+  /// Each captured frame will be encoded into a `.png` file.
+  CAPTURE_FORMAT_PNG = 19 << 0, 
+  
+  /// Each captured frame will be written as is into a `.raw` file of tightly-packed, top-to-bottom rows.
+  CAPTURE_FORMAT_RAW = 19 << 1, 
+};
+/// CaptureFormat 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// RenderPath 
+enum RenderPath {
+  /// Every command gets shaded by the shader of its material as it is drawn.
+  RENDER_PATH_FORWARD  = 20 << 0, 
+  
+  /// Opaque commands are first drawn into a G-buffer of albedo, normal, material, and depth, 
+  /// and only then shaded by every light in screen space. Anything else is drawn forward afterwards.
+  RENDER_PATH_DEFERRED = 20 << 1, 
+};
+/// RenderPath 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// LightType 
+enum LightType {
+  /// Lights everything within its radius in every direction.
+  LIGHT_TYPE_POINT       = 21 << 0, 
+  
+  /// Lights everything within its radius inside a cone along its direction.
+  LIGHT_TYPE_SPOT        = 21 << 1, 
+  
+  /// Lights everything along its direction regardless of distance, like the sun.
+  LIGHT_TYPE_DIRECTIONAL = 21 << 2, 
+};
+/// LightType 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// CaptureDesc 
+struct CaptureDesc {
+  /// The directory every captured frame will be written into. 
+  ///
+  /// @NOTE: The directory will be created if it does not exist.
+  FilePath output_dir  = "captures";
+
+  /// The format of each captured frame file.
+  CaptureFormat format = CAPTURE_FORMAT_PNG;
+
+  /// The amount of frames to capture before stopping on its own. 
+  ///
+  /// @NOTE: If this is left as `0`, frames will be captured until `renderer_end_capture` is called.
+  u32 frames_count     = 0;
+};
+/// CaptureDesc 
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Camera function pointers
 
@@ -1414,10 +1815,73 @@ struct RenderCommand {
   
   Transform transform;
   ResourceStorage* storage;
+
+  /// Transparent commands are rendered after everything else, from back to front.
+  bool is_transparent = false;
+
+  /// An id that stays the same for the object drawn by this command across frames. 
+  ///
+  /// @NOTE: The renderer uses it to remember the level of detail the object was drawn with, so it 
+  /// does not flicker between two levels around a threshold. It _must_ be unique per object and 
+  /// must not change while the object moves (an entity handle, for example). If left at `0`, the 
+  /// level is picked fresh every frame without any hysteresis, and can flicker around a threshold.
+  u64 object_id       = 0;
+
+  /// The level of detail of the meshes to render.
+  ///
+  /// @NOTE: This is filled in by `renderer_queue_command`, so any value set here will be overwritten.
+  u8 lod              = 0;
+
+  /// The key the render queue is sorted by before being rendered.
+  ///
+  /// @NOTE: This is filled in by `renderer_queue_command`, so any value set here will be overwritten.
+  u64 sort_key        = 0;
 };
 /// RenderCommand
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Light
+struct Light {
+  LightType type = LIGHT_TYPE_POINT;
+
+  Vec3 position; 
+  Vec3 direction = Vec3(0.0f, -1.0f, 0.0f);
+  Vec3 color     = Vec3(1.0f);
+
+  /// Nothing beyond this distance gets lit by point and spot lights.
+  f32 radius     = 10.0f;
+  f32 intensity  = 1.0f;
+
+  /// The angles (in radians) of the cone of a spot light. 
+  /// The light fades out between the inner and the outer cone.
+  f32 inner_cone = 0.35f;
+  f32 outer_cone = 0.5f;
+};
+/// Light
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// RendererStats
+struct RendererStats {
+  /// The amount of commands queued in the last pass.
+  sizei commands_count  = 0; 
+
+  /// The amount of commands that were outside the view of the camera in the last pass.
+  sizei culled_count    = 0;
+
+  /// The amount of draws the visible commands were merged into in the last pass.
+  sizei draws_count     = 0;
+
+  /// The amount of lights queued in the last pass.
+  sizei lights_count    = 0;
+
+  /// The amount of triangles the draws of the last pass rendered, at their selected levels of detail.
+  sizei triangles_count = 0;
+};
+/// RendererStats
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Renderer functions
 
@@ -1434,6 +1898,35 @@ NIKOLA_API const GfxContext* renderer_get_context();
 /// Set the background color of the global renderer to `clear_color`
 NIKOLA_API void renderer_set_clear_color(const Vec4& clear_color);
 
+/// Set the ambient light every lit surface receives to `color`.
+NIKOLA_API void renderer_set_ambient_color(const Vec3& color);
+
+/// Switch the global renderer over to the given render `path`. 
+///
+/// @NOTE: The path can be switched at any point between passes. The deferred path renders its 
+/// opaque commands with a built-in G-buffer shader in place of the shaders of their materials, 
+/// which only works for meshes with normals. Any other command is still rendered forward.
+NIKOLA_API void renderer_set_path(const RenderPath path);
+
+/// Retrieve the current render path of the global renderer.
+NIKOLA_API const RenderPath renderer_get_path();
+
+/// Enable or disable frustum culling of the render queue. 
+///
+/// @NOTE: The bounds, the local lights, and the light clusters are tested on up to `threads_count` threads 
+/// out of a worker pool that is started once in `renderer_init`. The pool has a thread for every hardware 
+/// thread, and a worker is only woken up when there is enough work to make it worth it.
+NIKOLA_API void renderer_set_culling(const bool enabled, const u32 threads_count = 1);
+
+/// Scale the projected size of every command by `bias` before picking its level of detail. 
+///
+/// @NOTE: A `bias` greater than `1` keeps the detailed levels around for longer, while a 
+/// `bias` lower than `1` switches to the simplified levels sooner. The default is `1`.
+NIKOLA_API void renderer_set_lod_bias(const f32 bias);
+
+/// Retrieve the statistics of the last pass of the global renderer.
+NIKOLA_API const RendererStats renderer_get_stats();
+
 // @TODO: Change this to a set of defaults later.
 NIKOLA_API const GfxBuffer* renderer_default_matrices_buffer();
 
@@ -1445,11 +1938,98 @@ NIKOLA_API void renderer_end_pass();
 
 NIKOLA_API void renderer_post_pass();
 
+/// Add `command` to the render queue of the current pass. 
+///
+/// @NOTE: Commands are not rendered in the order they were queued. The whole queue gets sorted 
+/// by `sort_key` in `renderer_end_pass` to render opaque commands front to back with as few 
+/// shader and material switches as possible, followed by the skyboxes and then the transparent 
+/// commands from back to front. 
+///
+/// Once sorted, commands sharing the same renderable, material, and storage are merged into 
+/// a single instanced draw if the shader of the material declares `MATERIAL_ATTRIBUTE_INSTANCE_MODEL`.
 NIKOLA_API void renderer_queue_command(const RenderCommand& command);
 
+/// Add `light` to the lights of the current pass. 
+///
+/// @NOTE: Lights only last for the pass they were queued in. Every pass, the point and spot lights 
+/// get sorted into a grid of clusters across the view of the camera, so each pixel only evaluates 
+/// the lights that can reach it. See `MATERIAL_CLUSTERS_BUFFER_INDEX`.
+NIKOLA_API void renderer_queue_light(const Light& light);
+
+/// Start capturing every presented frame into the files described by `desc`. 
+///
+/// @NOTE: Frames are read back a few frames late so the GPU never gets stalled, 
+/// and are written to disk on a separate worker thread. 
+NIKOLA_API void renderer_begin_capture(const CaptureDesc& desc);
+
+/// Stop capturing frames, waiting for any frames that are still in flight to be written to disk.
+NIKOLA_API void renderer_end_capture();
+
+/// Return `true` if the renderer is currently capturing frames and `false` otherwise.
+NIKOLA_API const bool renderer_is_capturing();
+
 /// Renderer functions
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Batch renderer functions
+
+/// Start a new batch of 2D shapes in screen space, with the origin 
+/// at the top-left corner of the window and the Y-axis pointing down.
+///
+/// @NOTE: Every shape in the batch gets appended into one big vertex buffer, and is only 
+/// drawn once `batch_renderer_flush` gets called. A batch gets flushed early only when it runs 
+/// out of texture slots or reaches `BATCH_QUADS_MAX` quads, so most batches end up as a single draw call. Batches are drawn 
+/// on top of anything before them, without any depth testing.
+NIKOLA_API void batch_renderer_begin();
+
+/// Start a new batch of 2D shapes using `view_projection` to transform them.
+NIKOLA_API void batch_renderer_begin(const Mat4& view_projection);
+
+/// Draw every shape in the current batch.
+NIKOLA_API void batch_renderer_flush();
+
+/// Add a quad with its top-left corner at `position` of `size` and `color` to the current batch.
+NIKOLA_API void batch_renderer_quad(const Vec2& position, const Vec2& size, const Vec4& color);
+
+/// Add a quad with its top-left corner at `position` of `size` that samples `texture` to the current batch.
+///
+/// @NOTE: The `texture_rect` is the offset (xy) and size (zw) of the region of `texture` 
+/// to sample in texture coordinates, which allows drawing sprites off of an atlas.
+NIKOLA_API void batch_renderer_textured_quad(const Vec2& position, 
+                                             const Vec2& size, 
+                                             GfxTexture* texture, 
+                                             const Vec4& tint         = Vec4(1.0f), 
+                                             const Vec4& texture_rect = Vec4(0.0f, 0.0f, 1.0f, 1.0f));
+
+/// Add the outline of a rectangle with its top-left corner at `position` of `size`, 
+/// `thickness`, and `color` to the current batch.
+NIKOLA_API void batch_renderer_rect(const Vec2& position, const Vec2& size, const f32 thickness, const Vec4& color);
+
+/// Add a filled circle at `center` of `radius` and `color` to the current batch.
+NIKOLA_API void batch_renderer_circle(const Vec2& center, const f32 radius, const Vec4& color);
+
+/// Add a line from `start` to `end` of `thickness` and `color` to the current batch.
+NIKOLA_API void batch_renderer_line(const Vec2& start, const Vec2& end, const f32 thickness, const Vec4& color);
+
+/// Add the given `text` with its top-left corner at `position`, laid out using `font` 
+/// at a pixel height of `size` with `color`, to the current batch.
+///
+/// @NOTE: Every glyph is a quad sampling the distance field atlas of `font`, so the 
+/// text shares the draw call with the rest of the batch. A `\n` starts a new line.
+///
+/// The `text` is read one byte at a time, and any byte without a baked glyph in `font` is skipped 
+/// entirely, without moving the pen. Since only the printable ASCII range gets baked, this drops 
+/// tabs and every byte of a UTF-8 sequence instead of drawing a `?` for each of them.
+NIKOLA_API void batch_renderer_text(const Font* font, 
+                                    const String& text, 
+                                    const Vec2& position, 
+                                    const f32 size, 
+                                    const Vec4& color = Vec4(1.0f));
+
+/// Batch renderer functions
+///---------------------------------------------------------------------------------------------------------------------
+
 /// *** Renderer ***
 /// ----------------------------------------------------------------------
 
@@ -2,17 +2,20 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
 
 //////////////////////////////////////////////////////////////////////////
 
 namespace nikola { // Start of nikola
 
 /// MemoryState
+///
+/// @NOTE: Command lists can be recorded (and grown) from any thread, so the counters need to be atomic.
 struct MemoryState {
-  sizei alloc_count = 0; 
-  sizei free_count  = 0;
+  std::atomic<sizei> alloc_count = 0; 
+  std::atomic<sizei> free_count  = 0;
 
-  sizei alloc_total_bytes = 0;
+  std::atomic<sizei> alloc_total_bytes = 0;
 };
 
 static MemoryState s_state;
@@ -202,11 +202,12 @@ static bool nikol_cursor_show_callback(const Event& event, const void* dispatche
 ///---------------------------------------------------------------------------------------------------------------------
 /// Private functions
 static void set_gfx_context(Window* window) {
-#if defined(NIKOL_GFX_CONTEXT_OPENGL)
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+#if defined(NIKOLA_GFX_CONTEXT_OPENGL)
+  // Drivers are free to hand out any newer version that is still compatible
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, NIKOLA_GL_MINIMUM_MAJOR_VERSION);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, NIKOLA_GL_MINIMUM_MINOR_VERSION);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#elif defined(NIKOL_GTX_CONTEXT_DX11) 
+#elif defined(NIKOLA_GFX_CONTEXT_DX11) || defined(NIKOLA_GFX_CONTEXT_NULL)
   glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 #endif
 }
@@ -262,6 +263,10 @@ static void set_window_hints(Window* window) {
     window->is_fullscreen = true; 
   }
   
+  if(IS_BIT_SET(window->flags, WINDOW_FLAGS_HIDDEN)) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  }
+  
   if(IS_BIT_SET(window->flags, WINDOW_FLAGS_GFX_HARDWARE)) {
     set_gfx_context(window);
   }
@@ -275,8 +280,11 @@ static void create_glfw_handle(Window* window, const i8* title) {
   // Creating the window
   window->handle = glfwCreateWindow(window->width, window->height, title, nullptr, nullptr);
 
-  // Setting the new refresh rate
-  window->refresh_rate = glfwGetVideoMode(glfwGetPrimaryMonitor())->refreshRate;
+  // Setting the new refresh rate (if there is any monitor to query)
+  GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+  if(monitor) {
+    window->refresh_rate = glfwGetVideoMode(monitor)->refreshRate;
+  }
 }
 
 static void set_window_callbacks(Window* window) {
@@ -317,18 +325,39 @@ Window* window_open(const i8* title, const i32 width, const i32 height, i32 flag
   window->height = height; 
   window->flags  = (WindowFlags)flags;
 
-  // GLFW init and setup 
+#if defined(NIKOLA_GFX_CONTEXT_NULL)
+  // Headless runs might not have any display server to open a window on, 
+  // so only GLFW itself gets initialized for its timer and joysticks. 
+  // Its null platform (GLFW 3.4 and up) does not need a display either.
+#if defined(GLFW_PLATFORM_NULL)
+  glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
   glfwInit();
+
+  window->is_focused = true;
+  
+  NIKOLA_LOG_INFO("Window: {t = \"%s\", w = %i, h = %i} was successfully opened (headless)", title, width, height);
+  return window;
+#endif
+
+  // GLFW init and setup 
+  if(!glfwInit()) {
+    memory_free(window);
+    return nullptr;
+  }
+
   set_window_hints(window);
   create_glfw_handle(window, title);
-  set_window_callbacks(window);
   
   // Something wrong...
   if(!window->handle) {
+    glfwTerminate();
     memory_free(window);
     return nullptr;
   }
 
+  set_window_callbacks(window);
+
   // Setting our `window` as user data in the glfw window
   glfwSetWindowUserPointer(window->handle, window);
   
@@ -364,7 +393,10 @@ void window_close(Window* window) {
     glfwDestroyCursor(window->cursor);
   }
 
-  glfwDestroyWindow(window->handle);
+  // Headless windows never had a handle
+  if(window->handle) {
+    glfwDestroyWindow(window->handle);
+  }
   glfwTerminate();
   
   memory_free(window);
@@ -381,10 +413,19 @@ void window_poll_events(Window* window) {
 }
 
 void window_swap_buffers(Window* window) {
+  if(!window->handle) {
+    return;
+  }
+
   glfwSwapBuffers(window->handle);
 }
 
 const bool window_is_open(const Window* window) {
+  // A headless window stays open until the application stops on its own
+  if(!window->handle) {
+    return true;
+  }
+
   return !glfwWindowShouldClose(window->handle);
 }
 
@@ -397,6 +438,10 @@ const bool window_is_focused(const Window* window) {
 }
 
 const bool window_is_shown(const Window* window) {
+  if(!window->handle) {
+    return false;
+  }
+
   return glfwGetWindowAttrib(window->handle, GLFW_VISIBLE);
 }
 
@@ -410,10 +455,22 @@ void* window_get_handle(const Window* window) {
 }
 
 const i8* window_get_title(const Window* window) {
+  if(!window->handle) {
+    return "";
+  }
+
   return glfwGetWindowTitle(window->handle);
 }
 
 void window_get_monitor_size(const Window* window, i32* width, i32* height) {
+  // Headless windows are their own monitor
+  if(!window->handle) {
+    *width  = window->width;
+    *height = window->height;
+
+    return;
+  }
+
   const GLFWvidmode* video_mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
   
   *width  = video_mode->width;
@@ -438,11 +495,17 @@ void window_get_position(const Window* window, i32* x, i32* y) {
 }
 
 void window_set_current_context(Window* window) {
+#ifndef NIKOLA_GFX_CONTEXT_NULL
   glfwMakeContextCurrent(window->handle);
+#endif
 }
 
 void window_set_fullscreen(Window* window, const bool fullscreen) {
   window->is_fullscreen = fullscreen; 
+  if(!window->handle) {
+    return;
+  }
+
   const GLFWvidmode* video_mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
 
   if(fullscreen) {
@@ -468,6 +531,10 @@ void window_set_fullscreen(Window* window, const bool fullscreen) {
 }
 
 void window_set_show(Window* window, const bool show) {
+  if(!window->handle) {
+    return;
+  }
+
   if(show) {
     glfwShowWindow(window->handle);
   }
@@ -480,18 +547,24 @@ void window_set_size(Window* window, const i32 width, const i32 height) {
   window->width = width; 
   window->height = height;
 
-  glfwSetWindowSize(window->handle, width, height);
+  if(window->handle) {
+    glfwSetWindowSize(window->handle, width, height);
+  }
 }
 
 void window_set_title(Window* window, const i8* title) {
-  glfwSetWindowTitle(window->handle, title);
+  if(window->handle) {
+    glfwSetWindowTitle(window->handle, title);
+  }
 }
 
 void window_set_position(Window* window, const i32 x_pos, const i32 y_pos) {
   window->position_x = x_pos; 
   window->position_y = y_pos; 
   
-  glfwSetWindowPos(window->handle, window->position_x, window->position_y);
+  if(window->handle) {
+    glfwSetWindowPos(window->handle, window->position_x, window->position_y);
+  }
 }
 
 /// Window functions
@@ -0,0 +1,373 @@
+#include "nikola/nikola_core.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ---------------------------------------------------------------------
+/// *** Graphics ***
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Consts
+
+/// The amount of bytes a command list reserves if no initial size was given.
+const sizei COMMAND_LIST_DEFAULT_SIZE = 4096;
+
+/// Every command in the list starts at an offset aligned to this.
+const sizei COMMAND_ALIGNMENT         = 8;
+
+/// Big enough to hold the biggest uniform (`GFX_LAYOUT_MAT4`).
+const sizei UNIFORM_DATA_MAX          = sizeof(f32) * 16;
+
+/// Consts
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// CommandType
+enum CommandType {
+  COMMAND_CLEAR = 0,
+  COMMAND_APPLY_PIPELINE,
+  COMMAND_UPDATE_BUFFER,
+  COMMAND_BIND_RANGE,
+  COMMAND_UPLOAD_UNIFORM,
+  COMMAND_DRAW_VERTEX,
+  COMMAND_DRAW_INDEX,
+  COMMAND_DRAW_INDIRECT,
+};
+/// CommandType
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Commands
+
+struct CommandHeader {
+  CommandType type;
+
+  /// The size of the whole command, including this header and any trailing data.
+  u32 size;
+};
+
+struct ClearCommand {
+  f32 color[4];
+  u32 flags;
+};
+
+struct ApplyPipelineCommand {
+  GfxPipeline* pipeline;
+  GfxPipelineDesc desc;
+};
+
+/// @NOTE: The data of the update is placed right after this command in the list.
+struct UpdateBufferCommand {
+  GfxBuffer* buffer;
+  sizei offset;
+  sizei size;
+};
+
+struct BindRangeCommand {
+  GfxBuffer* buffer;
+  u32 bind_point;
+  sizei offset;
+  sizei size;
+};
+
+struct UploadUniformCommand {
+  GfxShader* shader;
+  i32 location;
+  GfxLayoutType type;
+  u8 data[UNIFORM_DATA_MAX];
+};
+
+struct DrawCommand {
+  GfxPipeline* pipeline;
+  sizei instance_count;
+  u32 base_instance;
+};
+
+struct DrawIndirectCommand {
+  GfxPipeline* pipeline;
+  GfxBuffer* indirect_buffer;
+  sizei count;
+};
+
+/// Commands
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxCommandList
+struct GfxCommandList {
+  GfxContext* gfx = nullptr;
+
+  u8* data        = nullptr;
+  sizei size      = 0;
+  sizei capacity  = 0;
+
+  sizei commands_count = 0;
+};
+/// GfxCommandList
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Private functions
+
+static sizei align_command_size(const sizei size) {
+  return (size + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+}
+
+static sizei get_uniform_size(const GfxLayoutType type) {
+  switch(type) {
+    case GFX_LAYOUT_FLOAT1:
+    case GFX_LAYOUT_INT1:
+    case GFX_LAYOUT_UINT1:
+      return sizeof(f32);
+    case GFX_LAYOUT_FLOAT2:
+    case GFX_LAYOUT_INT2:
+    case GFX_LAYOUT_UINT2:
+      return sizeof(f32) * 2;
+    case GFX_LAYOUT_FLOAT3:
+    case GFX_LAYOUT_INT3:
+    case GFX_LAYOUT_UINT3:
+      return sizeof(f32) * 3;
+    case GFX_LAYOUT_FLOAT4:
+    case GFX_LAYOUT_INT4:
+    case GFX_LAYOUT_UINT4:
+    case GFX_LAYOUT_MAT2:
+      return sizeof(f32) * 4;
+    case GFX_LAYOUT_MAT3:
+      return sizeof(f32) * 9;
+    case GFX_LAYOUT_MAT4:
+      return sizeof(f32) * 16;
+    default:
+      return 0;
+  }
+}
+
+/// Reserve space for a command of type `type` with `extra_size` bytes of trailing data
+/// and return a pointer right after its header.
+static void* push_command(GfxCommandList* list, const CommandType type, const sizei command_size, const sizei extra_size = 0) {
+  sizei total_size = align_command_size(sizeof(CommandHeader) + command_size + extra_size);
+
+  // Grow the list when needed
+  if((list->size + total_size) > list->capacity) {
+    sizei new_capacity = list->capacity * 2;
+    while(new_capacity < (list->size + total_size)) {
+      new_capacity *= 2;
+    }
+
+    list->data     = (u8*)memory_reallocate(list->data, new_capacity);
+    list->capacity = new_capacity;
+  }
+
+  CommandHeader* header = (CommandHeader*)(list->data + list->size);
+  header->type          = type;
+  header->size          = (u32)total_size;
+
+  list->size += total_size;
+  list->commands_count++;
+
+  return (u8*)header + sizeof(CommandHeader);
+}
+
+/// Private functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Context functions
+
+void gfx_context_submit(GfxContext* gfx, GfxCommandList* list) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT((list->gfx == gfx), "Submitting a GfxCommandList to a different context than the one it was created with");
+
+  sizei offset = 0;
+  while(offset < list->size) {
+    CommandHeader* header = (CommandHeader*)(list->data + offset);
+    u8* command           = (u8*)header + sizeof(CommandHeader);
+
+    switch(header->type) {
+      case COMMAND_CLEAR: {
+        ClearCommand* cmd = (ClearCommand*)command;
+        gfx_context_clear(gfx, cmd->color[0], cmd->color[1], cmd->color[2], cmd->color[3], cmd->flags);
+      } break;
+      case COMMAND_APPLY_PIPELINE: {
+        ApplyPipelineCommand* cmd = (ApplyPipelineCommand*)command;
+        gfx_context_apply_pipeline(gfx, cmd->pipeline, cmd->desc);
+      } break;
+      case COMMAND_UPDATE_BUFFER: {
+        UpdateBufferCommand* cmd = (UpdateBufferCommand*)command;
+        gfx_buffer_update(cmd->buffer, cmd->offset, cmd->size, command + sizeof(UpdateBufferCommand));
+      } break;
+      case COMMAND_BIND_RANGE: {
+        BindRangeCommand* cmd = (BindRangeCommand*)command;
+        gfx_buffer_bind_range(cmd->buffer, cmd->bind_point, cmd->offset, cmd->size);
+      } break;
+      case COMMAND_UPLOAD_UNIFORM: {
+        UploadUniformCommand* cmd = (UploadUniformCommand*)command;
+        gfx_glsl_upload_uniform(cmd->shader, cmd->location, cmd->type, cmd->data);
+      } break;
+      case COMMAND_DRAW_VERTEX: {
+        DrawCommand* cmd = (DrawCommand*)command;
+
+        if(cmd->instance_count > 1 || cmd->base_instance != 0) {
+          gfx_pipeline_draw_vertex_instanced(cmd->pipeline, cmd->instance_count, cmd->base_instance);
+        }
+        else {
+          gfx_pipeline_draw_vertex(cmd->pipeline);
+        }
+      } break;
+      case COMMAND_DRAW_INDEX: {
+        DrawCommand* cmd = (DrawCommand*)command;
+
+        if(cmd->instance_count > 1 || cmd->base_instance != 0) {
+          gfx_pipeline_draw_index_instanced(cmd->pipeline, cmd->instance_count, cmd->base_instance);
+        }
+        else {
+          gfx_pipeline_draw_index(cmd->pipeline);
+        }
+      } break;
+      case COMMAND_DRAW_INDIRECT: {
+        DrawIndirectCommand* cmd = (DrawIndirectCommand*)command;
+        gfx_pipeline_draw_indirect(cmd->pipeline, cmd->indirect_buffer, cmd->count);
+      } break;
+    }
+
+    offset += header->size;
+  }
+}
+
+/// Context functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Command list functions
+
+GfxCommandList* gfx_command_list_create(GfxContext* gfx, const sizei initial_size) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxCommandList* list = (GfxCommandList*)memory_allocate(sizeof(GfxCommandList));
+  memory_zero(list, sizeof(GfxCommandList));
+
+  list->gfx      = gfx;
+  list->capacity = align_command_size(initial_size > 0 ? initial_size : COMMAND_LIST_DEFAULT_SIZE);
+  list->data     = (u8*)memory_allocate(list->capacity);
+
+  return list;
+}
+
+void gfx_command_list_destroy(GfxCommandList* list) {
+  if(!list) {
+    return;
+  }
+
+  memory_free(list->data);
+  memory_free(list);
+}
+
+void gfx_command_list_reset(GfxCommandList* list) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+
+  list->size           = 0;
+  list->commands_count = 0;
+}
+
+const sizei gfx_command_list_get_count(GfxCommandList* list) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+
+  return list->commands_count;
+}
+
+void gfx_command_list_clear(GfxCommandList* list, const f32 r, const f32 g, const f32 b, const f32 a, const u32 flags) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+
+  ClearCommand* cmd = (ClearCommand*)push_command(list, COMMAND_CLEAR, sizeof(ClearCommand));
+  cmd->color[0]     = r;
+  cmd->color[1]     = g;
+  cmd->color[2]     = b;
+  cmd->color[3]     = a;
+  cmd->flags        = flags;
+}
+
+void gfx_command_list_apply_pipeline(GfxCommandList* list, GfxPipeline* pipeline, const GfxPipelineDesc& pipe_desc) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  ApplyPipelineCommand* cmd = (ApplyPipelineCommand*)push_command(list, COMMAND_APPLY_PIPELINE, sizeof(ApplyPipelineCommand));
+  cmd->pipeline             = pipeline;
+  memory_copy(&cmd->desc, &pipe_desc, sizeof(GfxPipelineDesc));
+}
+
+void gfx_command_list_update_buffer(GfxCommandList* list, GfxBuffer* buff, const sizei offset, const sizei size, const void* data) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+  NIKOLA_ASSERT(data, "Cannot record a buffer update with invalid data");
+
+  UpdateBufferCommand* cmd = (UpdateBufferCommand*)push_command(list, COMMAND_UPDATE_BUFFER, sizeof(UpdateBufferCommand), size);
+  cmd->buffer              = buff;
+  cmd->offset              = offset;
+  cmd->size                = size;
+  memory_copy((u8*)cmd + sizeof(UpdateBufferCommand), data, size);
+}
+
+void gfx_command_list_bind_range(GfxCommandList* list, GfxBuffer* buff, const u32 bind_point, const sizei offset, const sizei size) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+
+  BindRangeCommand* cmd = (BindRangeCommand*)push_command(list, COMMAND_BIND_RANGE, sizeof(BindRangeCommand));
+  cmd->buffer           = buff;
+  cmd->bind_point       = bind_point;
+  cmd->offset           = offset;
+  cmd->size             = size;
+}
+
+void gfx_command_list_upload_uniform(GfxCommandList* list, GfxShader* shader, const i32 location, const GfxLayoutType type, const void* data) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+  NIKOLA_ASSERT(data, "Cannot record a uniform upload with invalid data");
+
+  UploadUniformCommand* cmd = (UploadUniformCommand*)push_command(list, COMMAND_UPLOAD_UNIFORM, sizeof(UploadUniformCommand));
+  cmd->shader               = shader;
+  cmd->location             = location;
+  cmd->type                 = type;
+  memory_copy(cmd->data, data, get_uniform_size(type));
+}
+
+void gfx_command_list_draw_vertex(GfxCommandList* list, GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  DrawCommand* cmd    = (DrawCommand*)push_command(list, COMMAND_DRAW_VERTEX, sizeof(DrawCommand));
+  cmd->pipeline       = pipeline;
+  cmd->instance_count = instance_count;
+  cmd->base_instance  = base_instance;
+}
+
+void gfx_command_list_draw_index(GfxCommandList* list, GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  DrawCommand* cmd    = (DrawCommand*)push_command(list, COMMAND_DRAW_INDEX, sizeof(DrawCommand));
+  cmd->pipeline       = pipeline;
+  cmd->instance_count = instance_count;
+  cmd->base_instance  = base_instance;
+}
+
+void gfx_command_list_draw_indirect(GfxCommandList* list, GfxPipeline* pipeline, GfxBuffer* indirect_buffer, const sizei count) {
+  NIKOLA_ASSERT(list, "Invalid GfxCommandList struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(indirect_buffer, "Invalid indirect buffer passed");
+
+  DrawIndirectCommand* cmd = (DrawIndirectCommand*)push_command(list, COMMAND_DRAW_INDIRECT, sizeof(DrawIndirectCommand));
+  cmd->pipeline            = pipeline;
+  cmd->indirect_buffer     = indirect_buffer;
+  cmd->count               = count;
+}
+
+/// Command list functions
+///---------------------------------------------------------------------------------------------------------------------
+
+/// *** Graphics ***
+/// ---------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -4,9 +4,22 @@
 
 #ifdef NIKOLA_GFX_CONTEXT_OPENGL  // OpenGL check
 
+#include "ring_buffer.hpp"
+
 #include <glad/glad.h>
 
 #include <cstring>
+#include <cstdio>
+#include <filesystem>
+
+// S3TC is an extension rather than core, so GLAD does not define its enums
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
 
 namespace nikola { // Start of nikola
 
@@ -37,6 +50,98 @@ namespace nikola { // Start of nikola
 /// Macros
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxBufferBinding
+struct GfxBufferBinding {
+  u32 buffer   = 0;
+  sizei offset = 0;
+  sizei size   = 0; // Zero means the whole buffer is bound
+};
+/// GfxBufferBinding
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxStateCache
+struct GfxStateCache {
+  u32 program      = 0;
+  u32 vertex_array = 0;
+  u32 framebuffer  = 0;
+
+  u32 draw_indirect_buffer     = 0;
+  u32 dispatch_indirect_buffer = 0;
+
+  u32 texture_units[TEXTURES_MAX] = {};
+  u32 sampler_units[TEXTURES_MAX] = {};
+
+  GfxBufferBinding storage_buffers[STORAGE_BUFFERS_MAX] = {};
+
+  u32 enabled_states = 0;
+  bool depth_mask    = true;
+  u32 stencil_mask   = 0;
+  f32 blend_color[4] = {0, 0, 0, 0};
+
+  u64 saved_calls = 0;
+};
+/// GfxStateCache
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxVertexArray
+struct GfxVertexArray {
+  u32 id;
+  u64 hash;
+  u32 ref_count;
+
+  GfxBuffer* vertex_buffer   = nullptr;
+  GfxBuffer* index_buffer    = nullptr;
+  GfxBuffer* instance_buffer = nullptr;
+
+  sizei vertex_stride   = 0;
+  sizei vertex_offset   = 0;
+  sizei instance_stride = 0;
+  sizei instance_offset = 0;
+};
+/// GfxVertexArray
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxTransientTarget
+struct GfxTransientTarget {
+  GfxTexture* texture = nullptr;
+  u64 key;
+
+  sizei last_frame = 0;
+  bool in_use      = false;
+};
+/// GfxTransientTarget
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxTargetFramebuffer
+struct GfxTargetFramebuffer {
+  u32 id;
+  u64 hash;
+
+  u32 clear_bits    = 0;
+  u32 width, height = 0;
+  sizei last_frame  = 0;
+
+  GfxTexture* attachments[RENDER_TARGETS_MAX + 1] = {};
+  sizei attachments_count                         = 0;
+};
+/// GfxTargetFramebuffer
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxStagingRegion
+struct GfxStagingRegion {
+  sizei offset = 0; 
+  sizei size   = 0;
+  GLsync fence = nullptr;
+};
+/// GfxStagingRegion
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxContext
 struct GfxContext {
@@ -51,6 +156,39 @@ struct GfxContext {
 
   u32 current_clear_bits  = 0;
   u32 current_framebuffer = 0;
+
+  u32 target_framebuffer  = 0;
+  u32 target_clear_bits   = 0;
+
+  GfxStateCache cache;
+
+  i32 uniform_alignment = 0;
+  u64 driver_hash       = 0;
+  f32 max_anisotropy    = 1.0f;
+
+  GfxSampler* samplers[SAMPLERS_MAX] = {};
+  sizei samplers_count               = 0;
+
+  GfxVertexArray** vertex_arrays = nullptr;
+  sizei vertex_arrays_count      = 0;
+  sizei vertex_arrays_capacity   = 0;
+
+  GfxTransientTarget transient_targets[TRANSIENT_TARGETS_MAX] = {};
+  sizei transient_targets_count                               = 0;
+
+  GfxTargetFramebuffer target_framebuffers[TARGET_FRAMEBUFFERS_MAX] = {};
+  sizei target_framebuffers_count                                   = 0;
+
+  sizei frame_index                       = 0;
+  GLsync frame_fences[RING_BUFFER_FRAMES] = {};
+
+  u32 staging_buffer = 0;
+  u8* staging_data   = nullptr;
+  sizei staging_size = 0;
+  sizei staging_head = 0;
+
+  GfxStagingRegion staging_regions[STAGING_FENCES_MAX] = {};
+  sizei staging_regions_count                          = 0;
 };
 /// GfxContext
 ///---------------------------------------------------------------------------------------------------------------------
@@ -65,21 +203,56 @@ struct GfxBuffer {
 
   GLenum gl_buff_type; 
   GLenum gl_buff_usage;
+
+  i32 bind_point = -1;
+
+  u8* mapped_data = nullptr;
+  RingPartitions ring;
 };
 /// GfxBuffer  
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxShaderUniform
+struct GfxShaderUniform {
+  u64 hash;
+  
+  /// The location of a uniform or an attribute, or the binding point of a uniform block.
+  i32 location;
+};
+/// GfxShaderUniform
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxShader
 struct GfxShader {
   GfxContext* gfx    = nullptr;
   GfxShaderDesc desc = {};
 
-  u32 id, vert_id, frag_id;
+  u32 id, vert_id, frag_id, comp_id;
+
+  GfxShaderUniform* uniforms = nullptr;
+  sizei uniforms_count       = 0;
+  
+  GfxShaderUniform* blocks   = nullptr;
+  sizei blocks_count         = 0;
+  
+  GfxShaderUniform* attributes = nullptr;
+  sizei attributes_count       = 0;
 };
 /// GfxShader
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// ShaderCacheHeader
+struct ShaderCacheHeader {
+  u64 key;
+  GLenum format;
+  i32 length;
+};
+/// ShaderCacheHeader
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxTexture
 struct GfxTexture {
@@ -102,13 +275,26 @@ struct GfxCubemap {
 /// GfxCubemap
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxSampler
+struct GfxSampler {
+  GfxSamplerDesc desc = {};
+  GfxContext* gfx     = nullptr;
+
+  u32 id;
+  u64 hash;
+  u32 ref_count;
+};
+/// GfxSampler
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// GfxPipeline
 struct GfxPipeline {
   GfxPipelineDesc desc = {};
   GfxContext* gfx      = nullptr;
 
-  u32 vertex_array;
+  GfxVertexArray* vertex_array = nullptr;
 
   GfxBuffer* vertex_buffer = nullptr;
   sizei vertex_count       = 0;
@@ -116,6 +302,8 @@ struct GfxPipeline {
   GfxBuffer* index_buffer  = nullptr; 
   sizei index_count        = 0;
 
+  GfxBuffer* instance_buffer = nullptr;
+
   GfxDrawMode draw_mode;
 
   GfxShader* shader;
@@ -125,10 +313,40 @@ struct GfxPipeline {
 
   u32 textures[TEXTURES_MAX] = {};
   sizei textures_count       = 0;
+
+  u32 samplers[TEXTURES_MAX] = {};
 };
 /// GfxPipeline
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxComputePipeline
+struct GfxComputePipeline {
+  GfxComputePipelineDesc desc = {};
+  GfxContext* gfx             = nullptr;
+  
+  u32 textures[TEXTURES_MAX] = {};
+};
+/// GfxComputePipeline
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxReadback
+struct GfxReadback {
+  GfxReadbackDesc desc = {};
+  GfxContext* gfx      = nullptr;
+
+  u32 id;
+  sizei capacity = 0;
+
+  GLsync fence = nullptr;
+
+  /// The pack alignment to restore once the read is queued.
+  i32 previous_alignment = 1;
+};
+/// GfxReadback
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Callbacks 
 
@@ -149,8 +367,9 @@ static bool framebuffer_resize(const Event& event, const void* disp, const void*
 /// Private functions 
 
 static void check_supported_gl_version(const i32 major, const i32 minor) {
-  NIKOLA_ASSERT((major >= NIKOLA_GL_MINIMUM_MAJOR_VERSION) && (minor >= NIKOLA_GL_MINIMUM_MINOR_VERSION), 
-               "OpenGL versions less than 4.2 are not supported");
+  NIKOLA_ASSERT(((major > NIKOLA_GL_MINIMUM_MAJOR_VERSION) || 
+                 (major == NIKOLA_GL_MINIMUM_MAJOR_VERSION && minor >= NIKOLA_GL_MINIMUM_MINOR_VERSION)), 
+               "OpenGL versions less than 4.6 are not supported");
 }
 
 static const char* gl_get_error_source(GLenum src) {
@@ -308,6 +527,14 @@ static GLenum get_gl_cull_mode(const GfxCullMode mode) {
 }
 
 static void set_state(GfxContext* gfx, const GfxStates state, const bool value) {
+  // The state is already where we want it to be
+  if(IS_BIT_SET(gfx->cache.enabled_states, state) == value) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  SET_BUFFER_BIT(value, gfx->cache.enabled_states, state);
+
   switch(state) {
     case GFX_STATE_DEPTH:
       SET_GFX_STATE(value, GL_DEPTH_TEST);
@@ -373,25 +600,20 @@ static void set_gfx_states(GfxContext* gfx) {
   set_blend_state(gfx);
   set_cull_state(gfx);
 
-  if(IS_BIT_SET(gfx->states, GFX_STATE_DEPTH)) {
-    set_state(gfx, GFX_STATE_DEPTH, true);   
-  }
-  
-  if(IS_BIT_SET(gfx->states, GFX_STATE_STENCIL)) {
-    set_state(gfx, GFX_STATE_STENCIL, true);   
-  }
-  
-  if(IS_BIT_SET(gfx->states, GFX_STATE_BLEND)) {
-    set_state(gfx, GFX_STATE_BLEND, true);   
-  }
-  
-  if(IS_BIT_SET(gfx->states, GFX_STATE_MSAA)) {
-    set_state(gfx, GFX_STATE_MSAA, true);   
-  }
+  // Keeping the cache in sync with what was just sent to OpenGL
+  gfx->cache.depth_mask   = gfx->desc.depth_desc.depth_write_enabled;
+  gfx->cache.stencil_mask = gfx->desc.stencil_desc.mask;
+  memory_copy(gfx->cache.blend_color, gfx->desc.blend_desc.blend_factor, sizeof(f32) * 4);
 
-  if(IS_BIT_SET(gfx->states, GFX_STATE_CULL)) {
-    set_state(gfx, GFX_STATE_CULL, true);   
-  }
+  // Every state gets sent to OpenGL at least once (enabled or not) 
+  // so the cache does not start off with any false assumptions.
+  gfx->cache.enabled_states = ~gfx->states;
+
+  set_state(gfx, GFX_STATE_DEPTH, IS_BIT_SET(gfx->states, GFX_STATE_DEPTH));
+  set_state(gfx, GFX_STATE_STENCIL, IS_BIT_SET(gfx->states, GFX_STATE_STENCIL));
+  set_state(gfx, GFX_STATE_BLEND, IS_BIT_SET(gfx->states, GFX_STATE_BLEND));
+  set_state(gfx, GFX_STATE_MSAA, IS_BIT_SET(gfx->states, GFX_STATE_MSAA));
+  set_state(gfx, GFX_STATE_CULL, IS_BIT_SET(gfx->states, GFX_STATE_CULL));
 }
 
 static void set_context_flags(GfxContext* gfx, const u32 flags) {
@@ -407,9 +629,10 @@ static void set_context_flags(GfxContext* gfx, const u32 flags) {
     gfx->has_vsync = true;
   }
 
+  // Any targets set by `gfx_context_set_targets` take priority
   if(IS_BIT_SET(flags, GFX_CONTEXT_FLAGS_CUSTOM_RENDER_TARGET)) {
-    gfx->current_framebuffer = gfx->framebuffer_id;
-    gfx->current_clear_bits  = gfx->framebuffer_clear_bits;
+    gfx->current_framebuffer = gfx->target_framebuffer ? gfx->target_framebuffer : gfx->framebuffer_id;
+    gfx->current_clear_bits  = gfx->target_framebuffer ? gfx->target_clear_bits : gfx->framebuffer_clear_bits;
   }
   
   if(IS_BIT_SET(flags, GFX_CONTEXT_FLAGS_CLEAR_COLOR_BUFFER)) {
@@ -433,6 +656,12 @@ static GLenum get_buffer_type(const GfxBufferType type) {
       return GL_ELEMENT_ARRAY_BUFFER;
     case GFX_BUFFER_UNIFORM:
       return GL_UNIFORM_BUFFER;
+    case GFX_BUFFER_DRAW_INDIRECT:
+      return GL_DRAW_INDIRECT_BUFFER;
+    case GFX_BUFFER_SHADER_STORAGE:
+      return GL_SHADER_STORAGE_BUFFER;
+    case GFX_BUFFER_DISPATCH_INDIRECT:
+      return GL_DISPATCH_INDIRECT_BUFFER;
   } 
 }
 
@@ -446,6 +675,8 @@ static GLenum get_buffer_usage(const GfxBufferUsage usage) {
       return GL_STATIC_DRAW;
     case GFX_BUFFER_USAGE_STATIC_READ:
       return GL_STATIC_READ;
+    case GFX_BUFFER_USAGE_STREAM_RING:
+      return GL_STREAM_DRAW;
     default:
       return 0;
   }
@@ -598,7 +829,7 @@ static bool is_semantic_attrib(const GfxLayoutType layout) {
          layout == GFX_LAYOUT_MAT4;
 }
 
-static void set_vertex_attrib(const u32 vao, const GfxLayoutDesc& layout, const sizei index, sizei* offset) {
+static void set_vertex_attrib(const u32 vao, const GfxLayoutDesc& layout, const sizei index, const u32 binding, sizei* offset) {
   glEnableVertexArrayAttrib(vao, index);
 
   GLenum gl_comp_type = get_layout_type(layout.type);
@@ -606,13 +837,12 @@ static void set_vertex_attrib(const u32 vao, const GfxLayoutDesc& layout, const
   sizei size          = get_layout_size(layout.type);
 
   glVertexArrayAttribFormat(vao, index, comp_count, gl_comp_type, false, *offset);
-  glVertexArrayBindingDivisor(vao, index, layout.instance_rate);
-  glVertexArrayAttribBinding(vao, index, 0);
+  glVertexArrayAttribBinding(vao, index, binding);
 
   *offset += size;
 }
 
-static sizei set_semantic_attrib(const u32 vao, const GfxLayoutDesc& layout, const sizei index, sizei* offset) {
+static sizei set_semantic_attrib(const u32 vao, const GfxLayoutDesc& layout, const sizei index, const u32 binding, sizei* offset) {
   sizei semantic_count = get_semantic_count(layout.type);  
   sizei semantic_size  = get_semantic_size(layout.type); 
   sizei semantic_index = 0;
@@ -626,8 +856,7 @@ static sizei set_semantic_attrib(const u32 vao, const GfxLayoutDesc& layout, con
     glEnableVertexArrayAttrib(vao, semantic_index);
   
     glVertexArrayAttribFormat(vao, semantic_index, comp_count, gl_comp_type, false, *offset);
-    glVertexArrayBindingDivisor(vao, semantic_index, layout.instance_rate);
-    glVertexArrayAttribBinding(vao, semantic_index, 0);
+    glVertexArrayAttribBinding(vao, semantic_index, binding);
 
     *offset += semantic_size;
   }
@@ -635,10 +864,10 @@ static sizei set_semantic_attrib(const u32 vao, const GfxLayoutDesc& layout, con
   return semantic_index;
 }
 
-static sizei set_buffer_layout(const u32 vao, const GfxLayoutDesc* layout, const sizei layout_count) {
+static sizei set_buffer_layout(const u32 vao, const GfxLayoutDesc* layout, const sizei layout_count, const u32 binding, sizei* attrib_index) {
   sizei stride         = calc_stride(layout, layout_count);
   sizei offset         = 0;
-  sizei semantic_index = 0;
+  sizei semantic_index = *attrib_index;
 
   for(sizei i = 0; i < layout_count; i++) {
     /// @NOTE: A "semantic" is the inner value of an attribute. 
@@ -648,15 +877,16 @@ static sizei set_buffer_layout(const u32 vao, const GfxLayoutDesc* layout, const
     
     // Different configuration if the current layout is a semantic or not
     if(is_semantic_attrib(layout[i].type)) {
-      semantic_index = set_semantic_attrib(vao, layout[i], semantic_index, &offset); 
+      semantic_index = set_semantic_attrib(vao, layout[i], semantic_index, binding, &offset); 
     }
     else {
-      set_vertex_attrib(vao, layout[i], semantic_index, &offset);
+      set_vertex_attrib(vao, layout[i], semantic_index, binding, &offset);
     }
 
     semantic_index += 1;
   }
   
+  *attrib_index = semantic_index;
   return stride;
 }
 
@@ -672,7 +902,7 @@ static void check_shader_compile_error(const sizei shader) {
   }
 }
 
-static void check_shader_linker_error(const GfxShader* shader) {
+static bool check_shader_linker_error(const GfxShader* shader) {
   i32 success;
   i8 log_info[512];
 
@@ -682,6 +912,263 @@ static void check_shader_linker_error(const GfxShader* shader) {
     glGetProgramInfoLog(shader->id, 512, nullptr, log_info);
     NIKOLA_LOG_WARN("SHADER-ERROR: %s", log_info);
   }
+
+  return success;
+}
+
+static u32 compile_gl_shader(const GLenum type, const i8* source) {
+  i32 src_len = strlen(source);
+
+  u32 id = glCreateShader(type);
+  glShaderSource(id, 1, &source, &src_len); 
+  glCompileShader(id);
+  check_shader_compile_error(id);
+
+  return id;
+}
+
+static u64 hash_bytes(u64 hash, const void* data, const sizei size) {
+  const u8* bytes = (const u8*)data;
+
+  // FNV-1a
+  for(sizei i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
+static u64 hash_string(u64 hash, const i8* str) {
+  return str ? hash_bytes(hash, str, strlen(str)) : hash;
+}
+
+static u64 hash_tagged_string(u64 hash, const u32 tag, const i8* str) {
+  // The tag and the length keep the boundary between each string. Otherwise, 
+  // text moved from the end of one string to the start of the next hashes the same.
+  u64 length = str ? strlen(str) : UINT64_MAX;
+
+  hash = hash_bytes(hash, &tag, sizeof(tag));
+  hash = hash_bytes(hash, &length, sizeof(length));
+
+  return hash_string(hash, str);
+}
+
+static u64 get_driver_hash() {
+  u64 hash = 14695981039346656037ull;
+
+  // Any driver update invalidates the binaries
+  hash = hash_tagged_string(hash, GL_VENDOR, (const i8*)glGetString(GL_VENDOR));
+  hash = hash_tagged_string(hash, GL_RENDERER, (const i8*)glGetString(GL_RENDERER));
+  hash = hash_tagged_string(hash, GL_VERSION, (const i8*)glGetString(GL_VERSION));
+
+  return hash;
+}
+
+static void get_shader_cache_path(const GfxContext* gfx, const u64 key, i8* path, const sizei path_size) {
+  snprintf(path, path_size, "%s/%016llx.bin", gfx->desc.shader_cache_dir, (unsigned long long)key);
+}
+
+static sizei reflect_gl_interface(const u32 program, const GLenum interface, GfxShaderUniform** out_entries) {
+  i32 count = 0, max_name_len = 0;
+  glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+  glGetProgramInterfaceiv(program, interface, GL_MAX_NAME_LENGTH, &max_name_len);
+
+  *out_entries = nullptr;
+  if(count <= 0) {
+    return 0;
+  }
+
+  GfxShaderUniform* entries = (GfxShaderUniform*)memory_allocate(sizeof(GfxShaderUniform) * count);
+  i8* name                  = (i8*)memory_allocate(max_name_len);
+  sizei entries_count       = 0;
+
+  for(i32 i = 0; i < count; i++) {
+    i32 location = -1;
+
+    if(interface == GL_UNIFORM) {
+      GLenum props[2] = {GL_BLOCK_INDEX, GL_LOCATION};
+      i32 values[2]   = {-1, -1};
+      glGetProgramResourceiv(program, interface, i, 2, props, 2, nullptr, values);
+
+      // Members of uniform blocks do not have a location of their own
+      if(values[0] != -1) {
+        continue;
+      }
+
+      location = values[1];
+    }
+    else if(interface == GL_PROGRAM_INPUT) {
+      GLenum prop = GL_LOCATION;
+      glGetProgramResourceiv(program, interface, i, 1, &prop, 1, nullptr, &location);
+
+      // Built-in inputs (like `gl_VertexID`) cannot be fed by a layout
+      if(location == -1) {
+        continue;
+      }
+    }
+    else {
+      GLenum prop = GL_BUFFER_BINDING;
+      glGetProgramResourceiv(program, interface, i, 1, &prop, 1, nullptr, &location);
+    }
+
+    i32 name_len = 0;
+    glGetProgramResourceName(program, interface, i, max_name_len, &name_len, name);
+
+    // Arrays are reported by their first element, but are looked up by their bare name
+    if(name_len > 3 && strcmp(&name[name_len - 3], "[0]") == 0) {
+      name_len -= 3;
+    }
+
+    entries[entries_count].hash     = hash_bytes(14695981039346656037ull, name, name_len);
+    entries[entries_count].location = location;
+    entries_count++;
+  }
+
+  memory_free(name);
+
+  // Sorting by hash for the lookups later on. 
+  // Shaders do not have that many uniforms, so this is plenty.
+  for(sizei i = 1; i < entries_count; i++) {
+    GfxShaderUniform entry = entries[i];
+
+    sizei j = i;
+    while(j > 0 && entries[j - 1].hash > entry.hash) {
+      entries[j] = entries[j - 1];
+      j--;
+    }
+
+    entries[j] = entry;
+  }
+
+  *out_entries = entries;
+  return entries_count;
+}
+
+static void reflect_shader_uniforms(GfxShader* shader) {
+  shader->uniforms_count = reflect_gl_interface(shader->id, GL_UNIFORM, &shader->uniforms);
+  shader->blocks_count   = reflect_gl_interface(shader->id, GL_UNIFORM_BLOCK, &shader->blocks);
+
+  // Compute shaders have no vertex inputs to reflect
+  if(!shader->desc.compute_source) {
+    shader->attributes_count = reflect_gl_interface(shader->id, GL_PROGRAM_INPUT, &shader->attributes);
+  }
+}
+
+static i32 find_shader_uniform(const GfxShaderUniform* entries, const sizei count, const i8* name) {
+  u64 hash = hash_string(14695981039346656037ull, name);
+
+  // Binary search through the sorted entries
+  sizei low  = 0; 
+  sizei high = count;
+  while(low < high) {
+    sizei mid = low + (high - low) / 2;
+
+    if(entries[mid].hash == hash) {
+      return entries[mid].location;
+    }
+    else if(entries[mid].hash < hash) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+
+  return -1;
+}
+
+static bool load_cached_program(GfxShader* shader, const u64 key) {
+  i8 path[512];
+  get_shader_cache_path(shader->gfx, key, path, sizeof(path));
+
+  // A missing file is just a cache miss
+  FILE* file = fopen(path, "rb");
+  if(!file) {
+    return false;
+  }
+
+  ShaderCacheHeader header;
+  if(fread(&header, sizeof(header), 1, file) != 1 || header.key != key || header.length <= 0) {
+    fclose(file);
+    return false;
+  }
+
+  void* binary = memory_allocate(header.length);
+  bool is_read = fread(binary, 1, header.length, file) == (sizei)header.length;
+  fclose(file);
+
+  if(!is_read) {
+    memory_free(binary);
+    return false;
+  }
+
+  // The driver is free to reject the binary for any reason. 
+  // The caller will just compile from source in that case.
+  shader->id = glCreateProgram();
+  glProgramBinary(shader->id, header.format, binary, header.length);
+  memory_free(binary);
+
+  i32 success;
+  glGetProgramiv(shader->id, GL_LINK_STATUS, &success); 
+
+  if(!success) {
+    glDeleteProgram(shader->id);
+    shader->id = 0;
+
+    return false;
+  }
+
+  return true;
+}
+
+static void save_cached_program(GfxShader* shader, const u64 key) {
+  i32 length = 0;
+  glGetProgramiv(shader->id, GL_PROGRAM_BINARY_LENGTH, &length);
+
+  if(length <= 0) {
+    return;
+  }
+
+  ShaderCacheHeader header = {
+    .key    = key,
+    .format = 0,
+    .length = length,
+  };
+
+  void* binary = memory_allocate(length);
+  glGetProgramBinary(shader->id, length, nullptr, &header.format, binary);
+  
+  i8 path[512];
+  get_shader_cache_path(shader->gfx, key, path, sizeof(path));
+
+  // Write everything to a temporary file first and only move it into place once it is complete, 
+  // so a crash in the middle of the write never leaves a truncated binary behind.
+  i8 temp_path[520];
+  snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+  FILE* file = fopen(temp_path, "wb");
+  if(!file) {
+    NIKOLA_LOG_WARN("Could not write shader cache file at \'%s\'", temp_path);
+    memory_free(binary);
+    return;
+  }
+
+  bool is_written = fwrite(&header, sizeof(header), 1, file) == 1 && 
+                    fwrite(binary, 1, length, file) == (sizei)length;
+  is_written      = (fclose(file) == 0) && is_written;
+  
+  memory_free(binary);
+
+  std::error_code err;
+  if(is_written) {
+    std::filesystem::rename(temp_path, path, err);
+  }
+
+  if(!is_written || err) {
+    NIKOLA_LOG_WARN("Could not write shader cache file at \'%s\'", path);
+    std::filesystem::remove(temp_path, err);
+  }
 }
 
 static void get_texture_gl_format(const GfxTextureFormat format, GLenum* in_format, GLenum* gl_format, GLenum* gl_type) {
@@ -721,11 +1208,63 @@ static void get_texture_gl_format(const GfxTextureFormat format, GLenum* in_form
       *gl_format = GL_DEPTH_STENCIL;
       *gl_type   = GL_UNSIGNED_INT_24_8;
       break;
+    case GFX_TEXTURE_FORMAT_BC1:
+      *in_format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+      *gl_format = GL_RGBA;
+      *gl_type   = GL_UNSIGNED_BYTE;
+      break;
+    case GFX_TEXTURE_FORMAT_BC3:
+      *in_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+      *gl_format = GL_RGBA;
+      *gl_type   = GL_UNSIGNED_BYTE;
+      break;
+    case GFX_TEXTURE_FORMAT_BC4:
+      *in_format = GL_COMPRESSED_RED_RGTC1;
+      *gl_format = GL_RED;
+      *gl_type   = GL_UNSIGNED_BYTE;
+      break;
+    case GFX_TEXTURE_FORMAT_BC5:
+      *in_format = GL_COMPRESSED_RG_RGTC2;
+      *gl_format = GL_RG;
+      *gl_type   = GL_UNSIGNED_BYTE;
+      break;
+    case GFX_TEXTURE_FORMAT_BC7:
+      *in_format = GL_COMPRESSED_RGBA_BPTC_UNORM;
+      *gl_format = GL_RGBA;
+      *gl_type   = GL_UNSIGNED_BYTE;
+      break;
     default:
       break;
   }
 }
 
+static bool is_texture_compressed(const GfxTextureFormat format) {
+  switch(format) {
+    case GFX_TEXTURE_FORMAT_BC1:
+    case GFX_TEXTURE_FORMAT_BC3:
+    case GFX_TEXTURE_FORMAT_BC4:
+    case GFX_TEXTURE_FORMAT_BC5:
+    case GFX_TEXTURE_FORMAT_BC7:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static sizei get_texture_block_size(const GfxTextureFormat format) {
+  switch(format) {
+    case GFX_TEXTURE_FORMAT_BC1:
+    case GFX_TEXTURE_FORMAT_BC4:
+      return 8;
+    case GFX_TEXTURE_FORMAT_BC3:
+    case GFX_TEXTURE_FORMAT_BC5:
+    case GFX_TEXTURE_FORMAT_BC7:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
 static void get_texture_gl_filter(const GfxTextureFilter filter, GLenum* min, GLenum* mag) {
   switch(filter) {
     case GFX_TEXTURE_FILTER_MIN_MAG_LINEAR:
@@ -772,96 +1311,1115 @@ static GLenum get_texture_gl_wrap(const GfxTextureWrap wrap) {
   }
 }
 
-static GLenum create_gl_texture(const GfxTextureType type) {
-  u32 id = 0;
+static u64 hash_sampler_desc(const GfxSamplerDesc& desc) {
+  u64 hash = 14695981039346656037ull;
 
-  switch(type) {
-    case GFX_TEXTURE_1D:
-      glCreateTextures(GL_TEXTURE_1D, 1, &id);
-      break;
-    case GFX_TEXTURE_2D:
-    case GFX_TEXTURE_RENDER_TARGET:
-      glCreateTextures(GL_TEXTURE_2D, 1, &id);
-      break;
-    case GFX_TEXTURE_3D:
-      glCreateTextures(GL_TEXTURE_3D, 1, &id);
-      break;
-    case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
-      glCreateRenderbuffers(1, &id);
-      break;
-    default:
-      break;
-  } 
+  hash = hash_bytes(hash, &desc.filter, sizeof(desc.filter));
+  hash = hash_bytes(hash, &desc.wrap_mode, sizeof(desc.wrap_mode));
+  hash = hash_bytes(hash, desc.border_color, sizeof(desc.border_color));
+  hash = hash_bytes(hash, &desc.max_anisotropy, sizeof(desc.max_anisotropy));
+  hash = hash_bytes(hash, &desc.min_lod, sizeof(desc.min_lod));
+  hash = hash_bytes(hash, &desc.max_lod, sizeof(desc.max_lod));
+  hash = hash_bytes(hash, &desc.lod_bias, sizeof(desc.lod_bias));
 
-  return id;
+  return hash;
 }
 
-static void update_gl_texture_storage(GfxTexture* texture, GLenum in_format, GLenum gl_format, GLenum gl_pixel_type) {
-  switch(texture->desc.type) {
-    case GFX_TEXTURE_1D: 
-      glTextureStorage1D(texture->id, texture->desc.mips, in_format, texture->desc.width);
-      glTextureSubImage1D(texture->id, 
-                          texture->desc.mips, 
-                          0, 
-                          texture->desc.width, 
-                          gl_format, 
-                          gl_pixel_type, 
-                          texture->desc.data);
-      break;
-    case GFX_TEXTURE_2D:
-      glTextureStorage2D(texture->id, texture->desc.mips, in_format, texture->desc.width, texture->desc.height);
-      glTextureSubImage2D(texture->id, 
-                          0, 
-                          0, 0,
-                          texture->desc.width, texture->desc.height,
-                          gl_format, 
-                          gl_pixel_type, 
-                          texture->desc.data);
-      break;
-    case GFX_TEXTURE_3D:
-      glTextureStorage3D(texture->id, texture->desc.mips, in_format, texture->desc.width, texture->desc.height, texture->desc.height);
-      glTextureSubImage3D(texture->id, 
-                          texture->desc.mips, 
-                          0, 0, 0,
-                          texture->desc.width, texture->desc.height, texture->desc.depth,
-                          gl_format, 
-                          gl_pixel_type, 
-                          texture->desc.data);
+static void set_pipeline_samplers(GfxPipeline* pipeline, const GfxPipelineDesc& desc) {
+  NIKOLA_ASSERT((desc.samplers_count <= TEXTURES_MAX), "Too many samplers in the pipeline");
+
+  memory_zero(pipeline->samplers, sizeof(pipeline->samplers));
+  for(sizei i = 0; i < desc.samplers_count; i++) {
+    pipeline->samplers[i] = desc.samplers[i] ? desc.samplers[i]->id : 0;
+  }
+}
+
+static sizei get_texture_pixel_size(const GfxTextureFormat format) {
+  switch(format) {
+    case GFX_TEXTURE_FORMAT_R8:
+      return 1;
+    case GFX_TEXTURE_FORMAT_R16:
+    case GFX_TEXTURE_FORMAT_RG8:
+      return 2;
+    case GFX_TEXTURE_FORMAT_RG16:
+    case GFX_TEXTURE_FORMAT_RGBA8:
+    case GFX_TEXTURE_FORMAT_DEPTH_STENCIL_24_8:
+      return 4;
+    case GFX_TEXTURE_FORMAT_RGBA16:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static u32 get_mip_dimension(const u32 size, const u32 level) {
+  u32 mip_size = size >> level;
+  return mip_size > 0 ? mip_size : 1;
+}
+
+static u32 get_texture_full_mips(const GfxTextureDesc& desc) {
+  u32 size = desc.width;
+
+  switch(desc.type) {
+    case GFX_TEXTURE_2D:
+    case GFX_TEXTURE_2D_ARRAY:
+      size = desc.width > desc.height ? desc.width : desc.height;
+      break;
+    case GFX_TEXTURE_3D:
+      size = desc.width > desc.height ? desc.width : desc.height;
+      size = size > desc.depth ? size : desc.depth;
+      break;
+    case GFX_TEXTURE_RENDER_TARGET:
+    case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
+      return 1;
+    default:
+      break;
+  }
+
+  // floor(log2(size)) + 1
+  u32 mips = 1;
+  while(size > 1) {
+    size >>= 1;
+    mips++;
+  }
+
+  return mips;
+}
+
+static void resolve_texture_mips(GfxTextureDesc& desc) {
+  u32 full_mips = get_texture_full_mips(desc);
+
+  // A `0` means the whole chain. Anything above the full chain is invalid storage.
+  if(desc.mips == 0 || desc.mips > full_mips) {
+    desc.mips = full_mips;
+  }
+
+  // Compressed mips can only come from the data itself
+  if(is_texture_compressed(desc.format) && !desc.data_has_mips) {
+    desc.mips = 1;
+  }
+}
+
+static u32 get_cubemap_levels(const GfxCubemapDesc& desc) {
+  u32 size = desc.width > desc.height ? desc.width : desc.height;
+
+  u32 full_mips = 1;
+  while(size > 1) {
+    size >>= 1;
+    full_mips++;
+  }
+
+  // A `0` only needs the base level here
+  if(desc.mips == 0) {
+    return 1;
+  }
+
+  return desc.mips > full_mips ? full_mips : desc.mips;
+}
+
+static sizei get_texture_level_size(const GfxTextureDesc& desc, const u32 level) {
+  sizei width  = get_mip_dimension(desc.width, level);
+  sizei height = desc.type == GFX_TEXTURE_1D ? 1 : get_mip_dimension(desc.height, level);
+  sizei depth  = 1;
+
+  // Array layers do not shrink down the mip chain
+  if(desc.type == GFX_TEXTURE_3D) {
+    depth = get_mip_dimension(desc.depth, level);
+  }
+  else if(desc.type == GFX_TEXTURE_2D_ARRAY) {
+    depth = desc.depth;
+  }
+
+  // Compressed textures are stored in 4x4 blocks, rounded up
+  if(is_texture_compressed(desc.format)) {
+    return ((width + 3) / 4) * ((height + 3) / 4) * depth * get_texture_block_size(desc.format);
+  }
+
+  return width * height * depth * get_texture_pixel_size(desc.format);
+}
+
+static u32 create_gl_texture(const GfxTextureType type, const u32 samples) {
+  u32 id = 0;
+
+  switch(type) {
+    case GFX_TEXTURE_1D:
+      glCreateTextures(GL_TEXTURE_1D, 1, &id);
+      break;
+    case GFX_TEXTURE_2D:
+      glCreateTextures(GL_TEXTURE_2D, 1, &id);
+      break;
+    case GFX_TEXTURE_RENDER_TARGET:
+      glCreateTextures(samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D, 1, &id);
+      break;
+    case GFX_TEXTURE_3D:
+      glCreateTextures(GL_TEXTURE_3D, 1, &id);
+      break;
+    case GFX_TEXTURE_2D_ARRAY:
+      glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &id);
+      break;
+    case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
+      glCreateRenderbuffers(1, &id);
+      break;
+    default:
+      break;
+  } 
+
+  return id;
+}
+
+static void set_gl_texture_parameters(GfxTexture* texture) {
+  // Renderbuffers and multisampled textures do not have any sampling state
+  if(texture->desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET || texture->desc.samples > 1) {
+    return;
+  }
+
+  // Getting the appropriate GL addressing modes
+  GLenum gl_wrap_format = get_texture_gl_wrap(texture->desc.wrap_mode);
+  
+  // Getting the appropriate GL filters
+  GLenum min_filter, mag_filter;
+  get_texture_gl_filter(texture->desc.filter, &min_filter, &mag_filter); 
+
+  glTextureParameteri(texture->id, GL_TEXTURE_WRAP_S, gl_wrap_format);
+  glTextureParameteri(texture->id, GL_TEXTURE_WRAP_T, gl_wrap_format);
+  glTextureParameteri(texture->id, GL_TEXTURE_MIN_FILTER, min_filter);
+  glTextureParameteri(texture->id, GL_TEXTURE_MAG_FILTER, mag_filter);
+}
+
+static void allocate_gl_texture_storage(GfxTexture* texture, GLenum in_format) {
+  GfxTextureDesc& desc = texture->desc;
+
+  switch(desc.type) {
+    case GFX_TEXTURE_1D: 
+      glTextureStorage1D(texture->id, desc.mips, in_format, desc.width);
+      break;
+    case GFX_TEXTURE_2D:
+      glTextureStorage2D(texture->id, desc.mips, in_format, desc.width, desc.height);
       break;
     case GFX_TEXTURE_RENDER_TARGET:
-      glTextureStorage2D(texture->id, texture->desc.mips, in_format, texture->desc.width, texture->desc.height);
-      glTextureSubImage2D(texture->id, 
-                          0, 
-                          0, 0,
-                          texture->desc.width, texture->desc.height,
-                          gl_format, 
-                          gl_pixel_type, 
-                          NULL);
+      if(desc.samples > 1) {
+        glTextureStorage2DMultisample(texture->id, desc.samples, in_format, desc.width, desc.height, GL_TRUE);
+      }
+      else {
+        glTextureStorage2D(texture->id, desc.mips, in_format, desc.width, desc.height);
+      }
+      break;
+    case GFX_TEXTURE_3D:
+    case GFX_TEXTURE_2D_ARRAY:
+      glTextureStorage3D(texture->id, desc.mips, in_format, desc.width, desc.height, desc.depth);
       break;
     case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
-      glNamedRenderbufferStorage(texture->id, in_format, texture->desc.width, texture->desc.height);
+      if(desc.samples > 1) {
+        glNamedRenderbufferStorageMultisample(texture->id, desc.samples, in_format, desc.width, desc.height);
+      }
+      else {
+        glNamedRenderbufferStorage(texture->id, in_format, desc.width, desc.height);
+      }
       break;
     default:
       break;
   }
 }
 
-static void apply_gl_render_target(GfxContext* gfx, GfxTexture* texture) {
-  switch(texture->desc.type) {
-    case GFX_TEXTURE_RENDER_TARGET:
-      glNamedFramebufferTexture(gfx->framebuffer_id, GL_COLOR_ATTACHMENT0, texture->id, 0);
-      break;
-    case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
-      glNamedFramebufferRenderbuffer(gfx->framebuffer_id, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, texture->id);
-      gfx->framebuffer_clear_bits |= GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
-      break;
-    default:
-      return;
+static void wait_for_fence(GLsync fence) {
+  if(!fence) {
+    return;
+  }
+
+  GLenum result = glClientWaitSync(fence, 0, 0);
+  while(result == GL_TIMEOUT_EXPIRED) {
+    result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+  }
+}
+
+static void release_staging_regions(GfxContext* gfx, const sizei count) {
+  // Uploads finish in order, so waiting on one of them retires every upload before it too
+  wait_for_fence(gfx->staging_regions[count - 1].fence);
+
+  for(sizei i = 0; i < count; i++) {
+    glDeleteSync(gfx->staging_regions[i].fence);
+  }
+
+  for(sizei i = count; i < gfx->staging_regions_count; i++) {
+    gfx->staging_regions[i - count] = gfx->staging_regions[i];
+  }
+
+  gfx->staging_regions_count -= count;
+}
+
+static void destroy_staging_buffer(GfxContext* gfx) {
+  if(!gfx->staging_buffer) {
+    return;
+  }
+
+  // The GPU might still be reading from the old storage
+  if(gfx->staging_regions_count > 0) {
+    release_staging_regions(gfx, gfx->staging_regions_count);
+  }
+
+  glUnmapNamedBuffer(gfx->staging_buffer);
+  glDeleteBuffers(1, &gfx->staging_buffer);
+
+  gfx->staging_buffer = 0;
+  gfx->staging_data   = nullptr;
+  gfx->staging_size   = 0;
+  gfx->staging_head   = 0;
+}
+
+static void create_staging_buffer(GfxContext* gfx, const sizei size) {
+  destroy_staging_buffer(gfx);
+
+  GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; 
+
+  // The storage stays mapped for the whole lifetime of the ring
+  glCreateBuffers(1, &gfx->staging_buffer);
+  glNamedBufferStorage(gfx->staging_buffer, size, nullptr, flags);
+
+  gfx->staging_data = (u8*)glMapNamedBufferRange(gfx->staging_buffer, 0, size, flags);
+  gfx->staging_size = size;
+}
+
+static sizei acquire_staging_range(GfxContext* gfx, const sizei size) {
+  // Keeps every range aligned for any pixel type or compressed block
+  const sizei alignment = 256;
+  sizei aligned_size    = ((size + alignment - 1) / alignment) * alignment;
+
+  // Grow the ring to fit the largest upload so far
+  if(aligned_size > gfx->staging_size) {
+    sizei new_size = gfx->staging_size > 0 ? gfx->staging_size * 2 : STAGING_BUFFER_SIZE;
+    create_staging_buffer(gfx, new_size > aligned_size ? new_size : aligned_size);
+  }
+
+  if((gfx->staging_head + aligned_size) > gfx->staging_size) {
+    gfx->staging_head = 0;
+  }
+
+  sizei offset = gfx->staging_head;
+
+  // Wait on the last upload that is still reading from the range
+  sizei overlapping = 0;
+  for(sizei i = 0; i < gfx->staging_regions_count; i++) {
+    GfxStagingRegion& region = gfx->staging_regions[i];
+
+    if(region.offset < (offset + aligned_size) && offset < (region.offset + region.size)) {
+      overlapping = i + 1;
+    }
+  }
+
+  if(overlapping > 0) {
+    release_staging_regions(gfx, overlapping);
+  }
+
+  // Make room for the fence of this upload
+  if(gfx->staging_regions_count == STAGING_FENCES_MAX) {
+    release_staging_regions(gfx, 1);
+  }
+
+  gfx->staging_head = offset + aligned_size;
+  return offset;
+}
+
+static void fence_staging_range(GfxContext* gfx, const sizei offset, const sizei size) {
+  GfxStagingRegion& region = gfx->staging_regions[gfx->staging_regions_count++];
+
+  region.offset = offset;
+  region.size   = size;
+  region.fence  = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+static void upload_gl_texture_pixels(GfxTexture* texture, GLenum in_format, GLenum gl_format, GLenum gl_pixel_type) {
+  GfxTextureDesc& desc = texture->desc;
+
+  // Render targets get their pixels from draw calls
+  if(!desc.data || desc.type == GFX_TEXTURE_RENDER_TARGET || desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET) {
+    return;
+  }
+
+  u32 levels = desc.data_has_mips ? desc.mips : 1;
+  
+  sizei total_size = 0;
+  for(u32 i = 0; i < levels; i++) {
+    total_size += get_texture_level_size(desc, i);
+  }
+
+  // Staging the pixels in the mapped ring lets the GPU copy them into the 
+  // texture whenever it gets to it, rather than blocking right here until 
+  // the whole upload is done.
+  GfxContext* gfx      = texture->gfx;
+  sizei staging_offset = acquire_staging_range(gfx, total_size);
+  
+  memory_copy(gfx->staging_data + staging_offset, desc.data, total_size);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gfx->staging_buffer);
+
+  // With an unpack buffer bound, the "pixels" are offsets into the buffer
+  sizei offset = staging_offset;
+  for(u32 i = 0; i < levels; i++) {
+    u32 width  = get_mip_dimension(desc.width, i);
+    u32 height = get_mip_dimension(desc.height, i);
+    u32 depth  = get_mip_dimension(desc.depth, i);
+
+    switch(desc.type) {
+      case GFX_TEXTURE_1D: 
+        glTextureSubImage1D(texture->id, i, 0, width, gl_format, gl_pixel_type, (const void*)offset);
+        break;
+      case GFX_TEXTURE_2D:
+        if(is_texture_compressed(desc.format)) {
+          glCompressedTextureSubImage2D(texture->id, i, 0, 0, width, height, in_format, get_texture_level_size(desc, i), (const void*)offset);
+          break;
+        }
+
+        glTextureSubImage2D(texture->id, i, 0, 0, width, height, gl_format, gl_pixel_type, (const void*)offset);
+        break;
+      case GFX_TEXTURE_3D:
+        glTextureSubImage3D(texture->id, i, 0, 0, 0, width, height, depth, gl_format, gl_pixel_type, (const void*)offset);
+        break;
+      case GFX_TEXTURE_2D_ARRAY:
+        if(is_texture_compressed(desc.format)) {
+          glCompressedTextureSubImage3D(texture->id, i, 0, 0, 0, width, height, desc.depth, in_format, get_texture_level_size(desc, i), (const void*)offset);
+          break;
+        }
+
+        glTextureSubImage3D(texture->id, i, 0, 0, 0, width, height, desc.depth, gl_format, gl_pixel_type, (const void*)offset);
+        break;
+      default:
+        break;
+    }
+
+    offset += get_texture_level_size(desc, i);
+  }
+
+  // The range can only be written to again once the transfer is complete
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  fence_staging_range(gfx, staging_offset, total_size);
+
+  // Fill out the rest of the chain if the data did not have it
+  if(!desc.data_has_mips && desc.mips > 1) {
+    glGenerateTextureMipmap(texture->id);
+  }
+}
+
+static void upload_gl_texture_layer(GfxTexture* texture, const u32 layer, const void* data) {
+  GfxTextureDesc& desc = texture->desc;
+
+  GLenum in_format, gl_format, gl_pixel_type;
+  get_texture_gl_format(desc.format, &in_format, &gl_format, &gl_pixel_type);
+
+  // A single layer of level `0`
+  sizei layer_size = get_texture_level_size(desc, 0) / desc.depth;
+
+  GfxContext* gfx = texture->gfx;
+  sizei offset    = acquire_staging_range(gfx, layer_size);
+  
+  memory_copy(gfx->staging_data + offset, data, layer_size);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gfx->staging_buffer);
+
+  if(is_texture_compressed(desc.format)) {
+    glCompressedTextureSubImage3D(texture->id, 0, 0, 0, layer, desc.width, desc.height, 1, in_format, layer_size, (const void*)offset);
+  }
+  else {
+    glTextureSubImage3D(texture->id, 0, 0, 0, layer, desc.width, desc.height, 1, gl_format, gl_pixel_type, (const void*)offset);
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  fence_staging_range(gfx, offset, layer_size);
+
+  if(!desc.data_has_mips && desc.mips > 1) {
+    glGenerateTextureMipmap(texture->id);
+  }
+}
+
+static GfxTexture* create_texture(GfxContext* gfx, const GfxTextureDesc& desc) {
+  GfxTexture* texture = (GfxTexture*)memory_allocate(sizeof(GfxTexture));
+  memory_zero(texture, sizeof(GfxTexture));
+ 
+  texture->desc = desc;
+  texture->gfx  = gfx;
+
+  NIKOLA_ASSERT((!is_texture_compressed(desc.format) || desc.type == GFX_TEXTURE_2D || desc.type == GFX_TEXTURE_2D_ARRAY), 
+                "Block-compressed formats are only supported by GFX_TEXTURE_2D and GFX_TEXTURE_2D_ARRAY");
+  NIKOLA_ASSERT((desc.type != GFX_TEXTURE_2D_ARRAY || desc.depth > 0), "A GFX_TEXTURE_2D_ARRAY needs at least one layer");
+
+  // Figure out the real length of the mip chain
+  resolve_texture_mips(texture->desc);
+  
+  // Getting the appropriate GL pixel format
+  GLenum in_format, gl_format, gl_pixel_type;
+  get_texture_gl_format(desc.format, &in_format, &gl_format, &gl_pixel_type);
+
+  // Creating the texutre based on its type
+  texture->id = create_gl_texture(desc.type, desc.samples);
+
+  // Setting texture parameters
+  set_gl_texture_parameters(texture);
+
+  // Allocating the immutable storage of the whole mip chain
+  allocate_gl_texture_storage(texture, in_format);
+
+  // Filling the texture with the data based on its type
+  upload_gl_texture_pixels(texture, in_format, gl_format, gl_pixel_type);
+
+  return texture;
+}
+
+static void apply_gl_render_target(GfxContext* gfx, GfxTexture* texture) {
+  switch(texture->desc.type) {
+    case GFX_TEXTURE_RENDER_TARGET:
+      glNamedFramebufferTexture(gfx->framebuffer_id, GL_COLOR_ATTACHMENT0, texture->id, 0);
+      break;
+    case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
+      glNamedFramebufferRenderbuffer(gfx->framebuffer_id, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, texture->id);
+      gfx->framebuffer_clear_bits |= GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+      break;
+    default:
+      return;
+  }
+
+  if(glCheckNamedFramebufferStatus(gfx->framebuffer_id, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    NIKOLA_LOG_WARN("GL-ERROR: Framebuffer %i is incomplete", gfx->framebuffer_id);
+  }
+}
+
+/// @NOTE: The `bind_*` and `set_*_mask` functions below go through the state
+/// cache of the context. Any GL call that would set a value that is
+/// already bound gets skipped and counted in `saved_calls` instead.
+
+static void bind_program(GfxContext* gfx, const u32 program) {
+  if(gfx->cache.program == program) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glUseProgram(program);
+  gfx->cache.program = program;
+}
+
+static void bind_vertex_array(GfxContext* gfx, const u32 vao) {
+  if(gfx->cache.vertex_array == vao) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBindVertexArray(vao);
+  gfx->cache.vertex_array = vao;
+}
+
+static void bind_framebuffer(GfxContext* gfx, const u32 framebuffer) {
+  if(gfx->cache.framebuffer == framebuffer) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  gfx->cache.framebuffer = framebuffer;
+}
+
+static void destroy_target_framebuffer(GfxContext* gfx, const sizei index) {
+  GfxTargetFramebuffer& fbo = gfx->target_framebuffers[index];
+
+  // Nothing should keep pointing to the old framebuffer
+  if(gfx->target_framebuffer == fbo.id) {
+    gfx->target_framebuffer = 0;
+  }
+
+  if(gfx->current_framebuffer == fbo.id) {
+    gfx->current_framebuffer = 0;
+  }
+
+  // Deleting a bound framebuffer reverts the binding back to zero
+  if(gfx->cache.framebuffer == fbo.id) {
+    gfx->cache.framebuffer = 0;
+  }
+
+  glDeleteFramebuffers(1, &fbo.id);
+  gfx->target_framebuffers[index] = gfx->target_framebuffers[--gfx->target_framebuffers_count];
+}
+
+static void release_target_framebuffers(GfxContext* gfx, const GfxTexture* texture) {
+  for(sizei i = 0; i < gfx->target_framebuffers_count;) {
+    GfxTargetFramebuffer& fbo = gfx->target_framebuffers[i];
+    
+    bool has_texture = false;
+    for(sizei j = 0; j < fbo.attachments_count; j++) {
+      has_texture = has_texture || (fbo.attachments[j] == texture);
+    }
+
+    // The last framebuffer gets swapped into `i`, so it needs to be checked as well 
+    if(has_texture) {
+      destroy_target_framebuffer(gfx, i);
+      continue;
+    }
+
+    i++;
+  }
+}
+
+static GfxTargetFramebuffer* acquire_target_framebuffer(GfxContext* gfx, GfxTexture** colors, const sizei colors_count, GfxTexture* depth_stencil) {
+  u64 hash = 14695981039346656037ull;
+  hash     = hash_bytes(hash, colors, sizeof(GfxTexture*) * colors_count);
+  hash     = hash_bytes(hash, &depth_stencil, sizeof(GfxTexture*));
+
+  // Any framebuffer with the same set of targets will do
+  for(sizei i = 0; i < gfx->target_framebuffers_count; i++) {
+    if(gfx->target_framebuffers[i].hash == hash) {
+      return &gfx->target_framebuffers[i];
+    }
+  }
+
+  // Make room by getting rid of the framebuffer that was used the longest time ago
+  if(gfx->target_framebuffers_count >= TARGET_FRAMEBUFFERS_MAX) {
+    sizei oldest = 0;
+    for(sizei i = 1; i < gfx->target_framebuffers_count; i++) {
+      if(gfx->target_framebuffers[i].last_frame < gfx->target_framebuffers[oldest].last_frame) {
+        oldest = i;
+      }
+    }
+
+    destroy_target_framebuffer(gfx, oldest);
+  }
+
+  GfxTargetFramebuffer& fbo = gfx->target_framebuffers[gfx->target_framebuffers_count++];
+  fbo                       = {};
+  fbo.hash                  = hash;
+
+  glCreateFramebuffers(1, &fbo.id);
+
+  // Color attachments init
+  GLenum draw_buffers[RENDER_TARGETS_MAX];
+  for(sizei i = 0; i < colors_count; i++) {
+    NIKOLA_ASSERT((colors[i]->desc.type == GFX_TEXTURE_RENDER_TARGET), "Color targets must be of type GFX_TEXTURE_RENDER_TARGET");
+
+    glNamedFramebufferTexture(fbo.id, GL_COLOR_ATTACHMENT0 + i, colors[i]->id, 0);
+    draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+
+    fbo.attachments[fbo.attachments_count++] = colors[i];
+  }
+
+  if(colors_count > 0) {
+    glNamedFramebufferDrawBuffers(fbo.id, colors_count, draw_buffers);
+    fbo.clear_bits |= GL_COLOR_BUFFER_BIT;
+  }
+  else {
+    glNamedFramebufferDrawBuffer(fbo.id, GL_NONE);
+  }
+
+  // Depth-stencil attachment init (only if available)
+  if(depth_stencil) {
+    NIKOLA_ASSERT((depth_stencil->desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET), "Depth targets must be of type GFX_TEXTURE_DEPTH_STENCIL_TARGET");
+    
+    glNamedFramebufferRenderbuffer(fbo.id, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_stencil->id);
+    fbo.clear_bits |= GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+
+    fbo.attachments[fbo.attachments_count++] = depth_stencil;
+  }
+
+  // The viewport will follow the size of the targets
+  fbo.width  = fbo.attachments[0]->desc.width;
+  fbo.height = fbo.attachments[0]->desc.height;
+
+  if(glCheckNamedFramebufferStatus(fbo.id, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    NIKOLA_LOG_WARN("GL-ERROR: Framebuffer %i is incomplete", fbo.id);
+  }
+
+  return &fbo;
+}
+
+static void recycle_transient_targets(GfxContext* gfx) {
+  for(sizei i = 0; i < gfx->transient_targets_count;) {
+    GfxTransientTarget& target = gfx->transient_targets[i];
+    target.in_use              = false;
+
+    // Still being used recently enough to be kept around
+    if((gfx->frame_index - target.last_frame) < TRANSIENT_TARGET_FRAMES) {
+      i++;
+      continue;
+    }
+
+    GfxTexture* texture = target.texture;
+    gfx->transient_targets[i] = gfx->transient_targets[--gfx->transient_targets_count];
+    
+    gfx_texture_destroy(texture);
+  }
+}
+
+static void bind_draw_indirect_buffer(GfxContext* gfx, const u32 buffer) {
+  if(gfx->cache.draw_indirect_buffer == buffer) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+  gfx->cache.draw_indirect_buffer = buffer;
+}
+
+static void bind_dispatch_indirect_buffer(GfxContext* gfx, const u32 buffer) {
+  if(gfx->cache.dispatch_indirect_buffer == buffer) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+  gfx->cache.dispatch_indirect_buffer = buffer;
+}
+
+static void bind_storage_buffer(GfxContext* gfx, const u32 bind_point, const u32 buffer, const sizei offset, const sizei size) {
+  // Bind points past the cached ones still work. They just never get skipped.
+  if(bind_point >= STORAGE_BUFFERS_MAX) {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bind_point, buffer, offset, size);
+    return;
+  }
+
+  GfxBufferBinding& binding = gfx->cache.storage_buffers[bind_point];
+  if(binding.buffer == buffer && binding.offset == offset && binding.size == size) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  if(size == 0) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bind_point, buffer);
+  }
+  else {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bind_point, buffer, offset, size);
+  }
+
+  binding.buffer = buffer;
+  binding.offset = offset;
+  binding.size   = size;
+}
+
+static void bind_textures(GfxContext* gfx, const u32 first, const sizei count, const u32* textures) {
+  if(memcmp(&gfx->cache.texture_units[first], textures, sizeof(u32) * count) == 0) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBindTextures(first, count, textures);
+  memory_copy(&gfx->cache.texture_units[first], textures, sizeof(u32) * count);
+}
+
+static void bind_samplers(GfxContext* gfx, const u32 first, const sizei count, const u32* samplers) {
+  if(memcmp(&gfx->cache.sampler_units[first], samplers, sizeof(u32) * count) == 0) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBindSamplers(first, count, samplers);
+  memory_copy(&gfx->cache.sampler_units[first], samplers, sizeof(u32) * count);
+}
+
+static void set_depth_mask(GfxContext* gfx, const bool mask) {
+  if(gfx->cache.depth_mask == mask) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glDepthMask(mask);
+  gfx->cache.depth_mask = mask;
+}
+
+static void set_stencil_mask(GfxContext* gfx, const u32 mask) {
+  if(gfx->cache.stencil_mask == mask) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glStencilMask(mask);
+  gfx->cache.stencil_mask = mask;
+}
+
+static void set_blend_color(GfxContext* gfx, const f32* color) {
+  if(memcmp(gfx->cache.blend_color, color, sizeof(f32) * 4) == 0) {
+    gfx->cache.saved_calls++;
+    return;
+  }
+
+  glBlendColor(color[0], color[1], color[2], color[3]);
+  memory_copy(gfx->cache.blend_color, color, sizeof(f32) * 4);
+}
+
+static void invalidate_texture_unit(GfxContext* gfx, const u32 texture) {
+  // OpenGL unbinds a deleted texture from every unit and might hand out its
+  // name again, so the cache should not remember it either.
+  for(sizei i = 0; i < TEXTURES_MAX; i++) {
+    if(gfx->cache.texture_units[i] == texture) {
+      gfx->cache.texture_units[i] = 0;
+    }
+  }
+}
+
+static void invalidate_sampler_unit(GfxContext* gfx, const u32 sampler) {
+  for(sizei i = 0; i < TEXTURES_MAX; i++) {
+    if(gfx->cache.sampler_units[i] == sampler) {
+      gfx->cache.sampler_units[i] = 0;
+    }
+  }
+}
+
+static void destroy_gl_texture(GfxTexture* texture) {
+  if(texture->desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET) {
+    glDeleteRenderbuffers(1, &texture->id);
+    return;
+  }
+
+  invalidate_texture_unit(texture->gfx, texture->id);
+  glDeleteTextures(1, &texture->id);
+}
+
+static sizei get_ring_offset(const GfxBuffer* buff) {
+  return ring_partitions_get_offset(buff->ring);
+}
+
+static void create_ring_buffer(GfxBuffer* buff) {
+  // Uniform and storage buffer ranges need to start at an aligned offset
+  ring_partitions_init(buff->ring, buff->desc.size, (sizei)buff->gfx->uniform_alignment);
+
+  sizei total_size = buff->ring.stride * RING_BUFFER_FRAMES;
+  GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT; 
+
+  // The storage stays mapped for the whole lifetime of the buffer
+  glNamedBufferStorage(buff->id, total_size, nullptr, flags);
+  buff->mapped_data = (u8*)glMapNamedBufferRange(buff->id, 0, total_size, flags);
+
+  // Every partition starts off with the initial data (if there is any)
+  if(!buff->desc.data) {
+    return;
+  }
+
+  for(sizei i = 0; i < RING_BUFFER_FRAMES; i++) {
+    memory_copy(buff->mapped_data + (i * buff->ring.stride), buff->desc.data, buff->desc.size);
+  }
+}
+
+static void wait_for_frame(GfxContext* gfx, const sizei frame) {
+  if(ring_frame_is_retired(frame, gfx->frame_index)) {
+    return;
+  }
+
+  wait_for_fence(gfx->frame_fences[frame % RING_BUFFER_FRAMES]);
+}
+
+static void bind_ring_partition(GfxBuffer* buff) {
+  sizei offset = get_ring_offset(buff);
+
+  // Storage bindings are cached, so they have to go through the cache as well
+  if(buff->gl_buff_type == GL_SHADER_STORAGE_BUFFER) {
+    bind_storage_buffer(buff->gfx, buff->bind_point, buff->id, offset, buff->desc.size);
+    return;
+  }
+
+  glBindBufferRange(buff->gl_buff_type, buff->bind_point, buff->id, offset, buff->desc.size);
+}
+
+static void update_ring_buffer(GfxBuffer* buff, const sizei offset, const sizei size, const void* data) {
+  NIKOLA_ASSERT(((offset + size) <= buff->ring.stride), "Cannot write outside the range of a ring buffer");
+
+  GfxContext* gfx = buff->gfx;
+
+  // Moving on to the next partition with the first write of every frame
+  sizei wait_frame;
+  if(ring_partitions_advance(buff->ring, gfx->frame_index, &wait_frame)) {
+    // Make sure the GPU is done with the new partition before writing to it
+    wait_for_frame(gfx, wait_frame);
+
+    // Uniform buffers have to be pointed to the new partition
+    if(buff->bind_point != -1) {
+      bind_ring_partition(buff);
+    }
+  }
+
+  memory_copy(buff->mapped_data + get_ring_offset(buff) + offset, data, size);
+}
+
+static u64 hash_vertex_array(const GfxPipelineDesc& desc, GfxBuffer* instance_buffer) {
+  u64 hash = 14695981039346656037ull;
+
+  // Only the format matters. The names are just semantics for other backends.
+  for(sizei i = 0; i < desc.layout_count; i++) {
+    hash = hash_bytes(hash, &desc.layout[i].type, sizeof(desc.layout[i].type));
+    hash = hash_bytes(hash, &desc.layout[i].instance_rate, sizeof(desc.layout[i].instance_rate));
+  }
+  hash = hash_bytes(hash, &desc.layout_count, sizeof(desc.layout_count));
+  
+  for(sizei i = 0; i < desc.instance_layout_count; i++) {
+    hash = hash_bytes(hash, &desc.instance_layout[i].type, sizeof(desc.instance_layout[i].type));
+    hash = hash_bytes(hash, &desc.instance_layout[i].instance_rate, sizeof(desc.instance_layout[i].instance_rate));
+  }
+  hash = hash_bytes(hash, &desc.instance_layout_count, sizeof(desc.instance_layout_count));
+
+  // The buffers are part of the vertex array state as well
+  u32 buffers[3] = {
+    desc.vertex_buffer->id, 
+    desc.index_buffer ? desc.index_buffer->id : 0, 
+    instance_buffer ? instance_buffer->id : 0,
+  };
+  hash = hash_bytes(hash, buffers, sizeof(buffers));
+
+  return hash;
+}
+
+static GfxVertexArray* acquire_vertex_array(GfxContext* gfx, const GfxPipelineDesc& desc, GfxBuffer* instance_buffer) {
+  // Hand out the same vertex array for the same layouts and buffers
+  u64 hash = hash_vertex_array(desc, instance_buffer);
+  for(sizei i = 0; i < gfx->vertex_arrays_count; i++) {
+    if(gfx->vertex_arrays[i]->hash == hash) {
+      gfx->vertex_arrays[i]->ref_count++;
+      return gfx->vertex_arrays[i];
+    }
+  }
+
+  // Grow the cache when needed
+  if(gfx->vertex_arrays_count >= gfx->vertex_arrays_capacity) {
+    gfx->vertex_arrays_capacity = gfx->vertex_arrays_capacity == 0 ? 32 : (gfx->vertex_arrays_capacity * 2);
+    
+    sizei new_size     = sizeof(GfxVertexArray*) * gfx->vertex_arrays_capacity;
+    gfx->vertex_arrays = (GfxVertexArray**)(gfx->vertex_arrays ? memory_reallocate(gfx->vertex_arrays, new_size) : memory_allocate(new_size));
+  }
+
+  GfxVertexArray* vao = (GfxVertexArray*)memory_allocate(sizeof(GfxVertexArray));
+  memory_zero(vao, sizeof(GfxVertexArray));
+
+  vao->hash      = hash;
+  vao->ref_count = 1;
+
+  glCreateVertexArrays(1, &vao->id);
+
+  // Layout init 
+  sizei attrib_index = 0;
+  vao->vertex_stride = set_buffer_layout(vao->id, desc.layout, desc.layout_count, 0, &attrib_index); 
+  
+  // VBO init
+  vao->vertex_buffer = desc.vertex_buffer; 
+  vao->vertex_offset = vao->vertex_buffer->mapped_data ? get_ring_offset(vao->vertex_buffer) : 0;
+
+  glVertexArrayVertexBuffer(vao->id, 0, vao->vertex_buffer->id, vao->vertex_offset, vao->vertex_stride);
+  glVertexArrayBindingDivisor(vao->id, 0, desc.layout[0].instance_rate);
+
+  // Instance layout init
+  //
+  // @NOTE: The per-instance attributes get the locations right after 
+  // the per-vertex attributes and are all sourced from binding `1`. 
+  if(desc.instance_layout_count > 0) {
+    vao->instance_stride = set_buffer_layout(vao->id, desc.instance_layout, desc.instance_layout_count, 1, &attrib_index);
+    
+    u32 divisor = desc.instance_layout[0].instance_rate;
+    glVertexArrayBindingDivisor(vao->id, 1, divisor > 0 ? divisor : 1);
+  }
+
+  // Instance buffer init (only if available)
+  if(instance_buffer) {
+    vao->instance_buffer = instance_buffer;
+    vao->instance_offset = instance_buffer->mapped_data ? get_ring_offset(instance_buffer) : 0;
+    
+    glVertexArrayVertexBuffer(vao->id, 1, instance_buffer->id, vao->instance_offset, vao->instance_stride);
+  }
+
+  // EBO init
+  if(desc.index_buffer) {
+    vao->index_buffer = desc.index_buffer;
+    glVertexArrayElementBuffer(vao->id, desc.index_buffer->id);
+  }
+
+  gfx->vertex_arrays[gfx->vertex_arrays_count++] = vao;
+  return vao;
+}
+
+static void release_vertex_array(GfxContext* gfx, GfxVertexArray* vao) {
+  // Someone else is still using the vertex array
+  vao->ref_count--;
+  if(vao->ref_count > 0) {
+    return;
+  }
+
+  // Remove the vertex array from the context
+  for(sizei i = 0; i < gfx->vertex_arrays_count; i++) {
+    if(gfx->vertex_arrays[i] == vao) {
+      gfx->vertex_arrays[i] = gfx->vertex_arrays[--gfx->vertex_arrays_count];
+      break;
+    }
+  }
+
+  // Deleting a bound VAO reverts the binding back to zero
+  if(gfx->cache.vertex_array == vao->id) {
+    gfx->cache.vertex_array = 0;
+  }
+
+  glDeleteVertexArrays(1, &vao->id);
+  memory_free(vao);
+}
+
+static void bind_pipeline_state(GfxPipeline* pipeline) {
+  GfxVertexArray* vao = pipeline->vertex_array;
+
+  // Follow any vertex buffers that moved on to a new partition
+  if(vao->vertex_buffer->mapped_data && (get_ring_offset(vao->vertex_buffer) != vao->vertex_offset)) {
+    vao->vertex_offset = get_ring_offset(vao->vertex_buffer);
+    glVertexArrayVertexBuffer(vao->id, 0, vao->vertex_buffer->id, vao->vertex_offset, vao->vertex_stride);
+  }
+  
+  if(vao->instance_buffer && vao->instance_buffer->mapped_data && (get_ring_offset(vao->instance_buffer) != vao->instance_offset)) {
+    vao->instance_offset = get_ring_offset(vao->instance_buffer);
+    glVertexArrayVertexBuffer(vao->id, 1, vao->instance_buffer->id, vao->instance_offset, vao->instance_stride);
+  }
+
+  // Bind the vertex array
+  bind_vertex_array(pipeline->gfx, vao->id);
+
+  // Bind the shader
+  bind_program(pipeline->gfx, pipeline->desc.shader->id);
+  
+  // Bind the cubemaps
+  if(pipeline->cubemaps_count > 0) {
+    bind_textures(pipeline->gfx, 0, pipeline->cubemaps_count, pipeline->cubemaps);
+  } 
+
+  // Bind the textures
+  if(pipeline->textures_count > 0) {
+    bind_textures(pipeline->gfx, 0, pipeline->textures_count, pipeline->textures);
+  }
+
+  // Bind the samplers
+  //
+  // @NOTE: Every used unit gets a sampler (even an empty one), so a sampler 
+  // left over from a previous pipeline never overrides a texture's own parameters.
+  sizei units_count = pipeline->textures_count > pipeline->cubemaps_count ? pipeline->textures_count : pipeline->cubemaps_count;
+  if(units_count > 0) {
+    bind_samplers(pipeline->gfx, 0, units_count, pipeline->samplers);
+  }
+}
+
+static GLenum get_image_access(const GfxImageAccess access) {
+  switch(access) {
+    case GFX_IMAGE_ACCESS_READ:
+      return GL_READ_ONLY;
+    case GFX_IMAGE_ACCESS_WRITE:
+      return GL_WRITE_ONLY;
+    case GFX_IMAGE_ACCESS_READ_WRITE:
+      return GL_READ_WRITE;
   }
+}
 
-  if(glCheckNamedFramebufferStatus(gfx->framebuffer_id, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-    NIKOLA_LOG_WARN("GL-ERROR: Framebuffer %i is incomplete", gfx->framebuffer_id);
+static GLbitfield get_memory_barrier_bits(const u32 barriers) {
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_ALL)) {
+    return GL_ALL_BARRIER_BITS;
+  }
+
+  GLbitfield bits = 0;
+
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_VERTEX_BUFFER)) {
+    bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_INDEX_BUFFER)) {
+    bits |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_UNIFORM_BUFFER)) {
+    bits |= GL_UNIFORM_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_STORAGE_BUFFER)) {
+    bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_TEXTURE_FETCH)) {
+    bits |= GL_TEXTURE_FETCH_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_IMAGE_ACCESS)) {
+    bits |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_COMMAND)) {
+    bits |= GL_COMMAND_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_BUFFER_UPDATE)) {
+    bits |= GL_BUFFER_UPDATE_BARRIER_BIT;
+  }
+  
+  if(IS_BIT_SET(barriers, GFX_MEMORY_BARRIER_TEXTURE_UPDATE)) {
+    bits |= GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+  }
+
+  return bits;
+}
+
+static void bind_compute_state(GfxComputePipeline* pipeline) {
+  GfxContext* gfx              = pipeline->gfx;
+  GfxComputePipelineDesc& desc = pipeline->desc;
+
+  // Bind the shader
+  bind_program(gfx, desc.shader->id);
+
+  // Bind the storage buffers (ring buffers only expose their current partition)
+  for(sizei i = 0; i < desc.storage_buffers_count; i++) {
+    GfxBuffer* buff = desc.storage_buffers[i];
+
+    if(buff->mapped_data) {
+      bind_storage_buffer(gfx, i, buff->id, get_ring_offset(buff), buff->desc.size);
+    }
+    else {
+      bind_storage_buffer(gfx, i, buff->id, 0, 0);
+    }
+  }
+
+  // Bind the images
+  for(sizei i = 0; i < desc.images_count; i++) {
+    GfxImageDesc& image = desc.images[i];
+    NIKOLA_ASSERT(image.texture, "Invalid image texture in compute pipeline");
+    NIKOLA_ASSERT(!is_texture_compressed(image.texture->desc.format), "Cannot use a compressed texture as an image");
+
+    GLenum in_format, gl_format, gl_type;
+    get_texture_gl_format(image.texture->desc.format, &in_format, &gl_format, &gl_type);
+
+    // Layered textures expose every layer to the shader at once
+    GfxTextureType type = image.texture->desc.type;
+    bool is_layered     = (type == GFX_TEXTURE_3D) || (type == GFX_TEXTURE_2D_ARRAY);
+
+    glBindImageTexture(i, image.texture->id, image.mip_level, is_layered, 0, get_image_access(image.access), in_format);
+  }
+
+  // Bind the textures
+  if(desc.textures_count > 0) {
+    for(sizei i = 0; i < desc.textures_count; i++) {
+      pipeline->textures[i] = desc.textures[i]->id;
+    }
+
+    bind_textures(gfx, 0, desc.textures_count, pipeline->textures);
+  }
+}
+
+static void begin_gl_readback(GfxReadback* readback, const u32 width, const u32 height, const GfxTextureFormat format) {
+  // A read that was never polled has nothing to wait for anymore
+  if(readback->fence) {
+    glDeleteSync(readback->fence);
+    readback->fence = nullptr;
+  }
+
+  readback->desc.width  = width;
+  readback->desc.height = height;
+  readback->desc.format = format;
+  readback->desc.size   = (sizei)width * height * get_texture_pixel_size(format);
+
+  // Only grow the storage when the new pixels do not fit
+  if(readback->desc.size > readback->capacity) {
+    readback->capacity = readback->desc.size;
+    glNamedBufferData(readback->id, readback->capacity, nullptr, GL_STREAM_READ);
   }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->id);
+
+  // The size above assumes tightly-packed rows, which might 
+  // not be the case if anything changed the alignment since.
+  glGetIntegerv(GL_PACK_ALIGNMENT, &readback->previous_alignment);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+}
+
+static void end_gl_readback(GfxReadback* readback) {
+  glPixelStorei(GL_PACK_ALIGNMENT, readback->previous_alignment);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  // The copy into the buffer is only queued. The fence marks when it is actually done.
+  readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
 /// Private functions 
@@ -889,6 +2447,39 @@ GfxContext* gfx_context_init(const GfxContextDesc& desc) {
   glDebugMessageCallback(gl_error_callback, nullptr);
 #endif
 
+  // Needed for any offsets into uniform or storage buffers. 
+  // The stricter of the two is used for both to keep ring buffers simple.
+  i32 storage_alignment = 0;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &gfx->uniform_alignment);
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage_alignment);
+
+  if(storage_alignment > gfx->uniform_alignment) {
+    gfx->uniform_alignment = storage_alignment;
+  }
+
+  // Texture rows are packed tightly, regardless of the width or format
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  // Any anisotropy requested by a sampler gets clamped to this
+  glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &gfx->max_anisotropy);
+
+  // Shader program binaries are only usable if the driver exposes at least one format
+  if(gfx->desc.shader_cache_dir) {
+    i32 binary_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binary_formats);
+
+    std::error_code err;
+    std::filesystem::create_directories(gfx->desc.shader_cache_dir, err);
+
+    if(binary_formats == 0 || err) {
+      NIKOLA_LOG_WARN("Shader cache is unavailable. Shaders will always be compiled from source");
+      gfx->desc.shader_cache_dir = nullptr;
+    }
+
+    gfx->driver_hash = get_driver_hash();
+  }
+
   // Framebuffer init
   glCreateFramebuffers(1, &gfx->framebuffer_id); 
   gfx->framebuffer_clear_bits = GL_COLOR_BUFFER_BIT;
@@ -936,6 +2527,47 @@ void gfx_context_shutdown(GfxContext* gfx) {
 
   glDeleteFramebuffers(1, &gfx->framebuffer_id);
 
+  // The pool owns its targets, and the framebuffers go along with them
+  for(sizei i = 0; i < gfx->transient_targets_count; i++) {
+    gfx_texture_destroy(gfx->transient_targets[i].texture);
+  }
+
+  while(gfx->target_framebuffers_count > 0) {
+    destroy_target_framebuffer(gfx, 0);
+  }
+
+  // Samplers are shared, so any left at this point were never released
+  if(gfx->samplers_count > 0) {
+    NIKOLA_LOG_WARN("%zu samplers were never destroyed", gfx->samplers_count);
+  }
+
+  for(sizei i = 0; i < gfx->samplers_count; i++) {
+    glDeleteSamplers(1, &gfx->samplers[i]->id);
+    memory_free(gfx->samplers[i]);
+  }
+
+  // Same goes for any vertex arrays of pipelines that were never destroyed
+  if(gfx->vertex_arrays_count > 0) {
+    NIKOLA_LOG_WARN("%zu vertex arrays were never released", gfx->vertex_arrays_count);
+  }
+
+  for(sizei i = 0; i < gfx->vertex_arrays_count; i++) {
+    glDeleteVertexArrays(1, &gfx->vertex_arrays[i]->id);
+    memory_free(gfx->vertex_arrays[i]);
+  }
+
+  if(gfx->vertex_arrays) {
+    memory_free(gfx->vertex_arrays);
+  }
+
+  for(sizei i = 0; i < RING_BUFFER_FRAMES; i++) {
+    if(gfx->frame_fences[i]) {
+      glDeleteSync(gfx->frame_fences[i]);
+    }
+  }
+
+  destroy_staging_buffer(gfx);
+
   NIKOLA_LOG_INFO("The graphics context was successfully destroyed");
   memory_free(gfx);
 }
@@ -956,9 +2588,9 @@ void gfx_context_clear(GfxContext* gfx, const f32 r, const f32 g, const f32 b, c
  
   set_context_flags(gfx, flags);
 
-  glBindFramebuffer(GL_FRAMEBUFFER, gfx->current_framebuffer);
-  glClear(gfx->current_clear_bits);
+  bind_framebuffer(gfx, gfx->current_framebuffer);
   glClearColor(r, g, b, a);
+  glClear(gfx->current_clear_bits);
 }
 
 void gfx_context_apply_pipeline(GfxContext* gfx, GfxPipeline* pipeline, const GfxPipelineDesc& pipe_desc) {
@@ -983,20 +2615,153 @@ void gfx_context_apply_pipeline(GfxContext* gfx, GfxPipeline* pipeline, const Gf
     pipeline->cubemaps[i] = pipe_desc.cubemaps[i]->id;
   }  
 
-  // Setting the depth mask state of the pipeline 
-  glDepthMask(pipe_desc.depth_mask);
+  // Updating the samplers
+  set_pipeline_samplers(pipeline, pipe_desc);
+
+  // Updating the instance buffer (only if it was switched)
+  //
+  // @NOTE: The vertex array might be shared, so a switch moves the 
+  // pipeline over to the vertex array of the new buffer instead. 
+  if(pipe_desc.instance_buffer && (pipe_desc.instance_buffer != pipeline->instance_buffer)) {
+    GfxVertexArray* old_vao = pipeline->vertex_array;
+
+    pipeline->instance_buffer = pipe_desc.instance_buffer;
+    pipeline->vertex_array    = acquire_vertex_array(gfx, pipe_desc, pipeline->instance_buffer);
+    
+    release_vertex_array(gfx, old_vao);
+  }
+
+  // Setting the depth mask state of the pipeline
+  set_depth_mask(gfx, pipe_desc.depth_mask);
 
   // Setting the stencil mask of the pipeline state
-  glStencilMask(pipe_desc.stencil_ref);
+  set_stencil_mask(gfx, pipe_desc.stencil_ref);
 
   // Setting the blend color of the pipeline state
-  const f32* blend_color = pipe_desc.blend_factor;
-  glBlendColor(blend_color[0], blend_color[1], blend_color[2], blend_color[3]);
+  set_blend_color(gfx, pipe_desc.blend_factor);
 }
 
 void gfx_context_present(GfxContext* gfx) {
   NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  // Mark the end of this frame's commands so the ring buffer 
+  // partitions of this frame can be safely reused later on
+  gfx->frame_fences[gfx->frame_index % RING_BUFFER_FRAMES] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  gfx->frame_index++;
+  
   window_swap_buffers(gfx->desc.window);
+
+  // Every transient target of this frame can be handed out again
+  recycle_transient_targets(gfx);
+
+  // Never let the GPU fall more than `RING_BUFFER_FRAMES` frames behind
+  GLsync* fence = &gfx->frame_fences[gfx->frame_index % RING_BUFFER_FRAMES];
+  if(*fence) {
+    wait_for_fence(*fence);
+    glDeleteSync(*fence);
+    *fence = nullptr;
+  }
+}
+
+const u64 gfx_context_get_saved_calls(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  return gfx->cache.saved_calls;
+}
+
+const sizei gfx_context_get_uniform_alignment(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  return (sizei)gfx->uniform_alignment;
+}
+
+void gfx_context_memory_barrier(GfxContext* gfx, const u32 barriers) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  glMemoryBarrier(get_memory_barrier_bits(barriers));
+}
+
+GfxTexture* gfx_context_acquire_target(GfxContext* gfx, const GfxTextureDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT((desc.type == GFX_TEXTURE_RENDER_TARGET || desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET), 
+                "Can only acquire targets of type GFX_TEXTURE_RENDER_TARGET or GFX_TEXTURE_DEPTH_STENCIL_TARGET");
+
+  // Only what makes up the storage and sampling of the target matters
+  GfxTextureDesc target_desc = {
+    .width     = desc.width, 
+    .height    = desc.height,
+    .depth     = 0,
+    .mips      = 1,
+    .type      = desc.type, 
+    .format    = desc.format, 
+    .filter    = desc.filter, 
+    .wrap_mode = desc.wrap_mode, 
+    .samples   = desc.samples > 1 ? desc.samples : 1,
+  };
+
+  u64 key = 14695981039346656037ull;
+  key     = hash_bytes(key, &target_desc.width, sizeof(target_desc.width));
+  key     = hash_bytes(key, &target_desc.height, sizeof(target_desc.height));
+  key     = hash_bytes(key, &target_desc.type, sizeof(target_desc.type));
+  key     = hash_bytes(key, &target_desc.format, sizeof(target_desc.format));
+  key     = hash_bytes(key, &target_desc.filter, sizeof(target_desc.filter));
+  key     = hash_bytes(key, &target_desc.wrap_mode, sizeof(target_desc.wrap_mode));
+  key     = hash_bytes(key, &target_desc.samples, sizeof(target_desc.samples));
+
+  // Reuse a free target from the previous frames if there is any
+  for(sizei i = 0; i < gfx->transient_targets_count; i++) {
+    GfxTransientTarget& target = gfx->transient_targets[i];
+    
+    if(target.key == key && !target.in_use) {
+      target.in_use     = true;
+      target.last_frame = gfx->frame_index;
+
+      return target.texture;
+    }
+  }
+
+  NIKOLA_ASSERT((gfx->transient_targets_count < TRANSIENT_TARGETS_MAX), "Too many transient targets in use at once");
+
+  // Nothing to reuse, so a new target is needed. 
+  // 
+  // @NOTE: The pool's targets never get attached to the framebuffer of `gfx_texture_create`. 
+  GfxTransientTarget& target = gfx->transient_targets[gfx->transient_targets_count++];
+  target.texture             = create_texture(gfx, target_desc);
+  target.key                 = key;
+  target.in_use              = true;
+  target.last_frame          = gfx->frame_index;
+
+  return target.texture;
+}
+
+void gfx_context_set_targets(GfxContext* gfx, GfxTexture** colors, const sizei colors_count, GfxTexture* depth_stencil) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT((colors_count <= RENDER_TARGETS_MAX), "Cannot set more than RENDER_TARGETS_MAX color targets");
+
+  // Back to the window 
+  if(colors_count == 0 && !depth_stencil) {
+    gfx->target_framebuffer  = 0;
+    gfx->target_clear_bits   = 0;
+    gfx->current_framebuffer = 0;
+
+    bind_framebuffer(gfx, 0);
+
+    i32 width, height;
+    window_get_size(gfx->desc.window, &width, &height);
+    glViewport(0, 0, width, height);
+
+    return;
+  }
+
+  GfxTargetFramebuffer* fbo = acquire_target_framebuffer(gfx, colors, colors_count, depth_stencil);
+  fbo->last_frame           = gfx->frame_index;
+
+  gfx->target_framebuffer  = fbo->id;
+  gfx->target_clear_bits   = fbo->clear_bits;
+  gfx->current_framebuffer = fbo->id;
+
+  bind_framebuffer(gfx, fbo->id);
+  glViewport(0, 0, fbo->width, fbo->height);
 }
 
 /// Context functions 
@@ -1016,7 +2781,19 @@ GfxBuffer* gfx_buffer_create(GfxContext* gfx, const GfxBufferDesc& desc) {
   buff->gl_buff_type  = get_buffer_type(desc.type);
   buff->gl_buff_usage = get_buffer_usage(desc.usage);
 
+  buff->bind_point    = -1;
+
   glCreateBuffers(1, &buff->id);
+
+  // Ring buffers need their own immutable storage
+  if(desc.usage == GFX_BUFFER_USAGE_STREAM_RING) {
+    NIKOLA_ASSERT(((desc.type == GFX_BUFFER_VERTEX) || (desc.type == GFX_BUFFER_UNIFORM) || (desc.type == GFX_BUFFER_SHADER_STORAGE)), 
+                  "Only vertex, uniform, and shader storage buffers can be used as ring buffers");
+    
+    create_ring_buffer(buff);
+    return buff;
+  }
+
   glNamedBufferData(buff->id, desc.size, desc.data, buff->gl_buff_usage);
   
   buff->desc = desc;
@@ -1028,6 +2805,38 @@ void gfx_buffer_destroy(GfxBuffer* buff) {
     return;
   }
 
+  // Deleting a bound buffer reverts the binding back to zero
+  if(buff->gfx->cache.draw_indirect_buffer == buff->id) {
+    buff->gfx->cache.draw_indirect_buffer = 0;
+  }
+  
+  if(buff->gfx->cache.dispatch_indirect_buffer == buff->id) {
+    buff->gfx->cache.dispatch_indirect_buffer = 0;
+  }
+
+  for(sizei i = 0; i < STORAGE_BUFFERS_MAX; i++) {
+    GfxBufferBinding& binding = buff->gfx->cache.storage_buffers[i];
+
+    if(binding.buffer == buff->id) {
+      binding = GfxBufferBinding{};
+    }
+  }
+
+  // The buffer's name can be handed out again, so no new 
+  // pipeline should ever match a vertex array still using it
+  GfxContext* gfx = buff->gfx;
+  for(sizei i = 0; i < gfx->vertex_arrays_count; i++) {
+    GfxVertexArray* vao = gfx->vertex_arrays[i];
+
+    if(vao->vertex_buffer == buff || vao->index_buffer == buff || vao->instance_buffer == buff) {
+      vao->hash = 0;
+    }
+  }
+
+  if(buff->mapped_data) {
+    glUnmapNamedBuffer(buff->id);
+  }
+
   glDeleteBuffers(1, &buff->id);
   memory_free(buff);
 }
@@ -1042,12 +2851,34 @@ void gfx_buffer_update(GfxBuffer* buff, const sizei offset, const sizei size, co
   NIKOLA_ASSERT(buff->gfx, "Invalid GfxContext struct passed");
   NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
 
+  // Ring buffers are written to directly
+  if(buff->mapped_data) {
+    update_ring_buffer(buff, offset, size, data);
+    return;
+  }
+
   buff->desc.size = size;
   buff->desc.data = (void*)data;
 
   glNamedBufferSubData(buff->id, offset, size, data);
 }
 
+void gfx_buffer_bind_range(GfxBuffer* buff, const u32 bind_point, const sizei offset, const sizei size) {
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+  NIKOLA_ASSERT(((buff->desc.type == GFX_BUFFER_UNIFORM) || (buff->desc.type == GFX_BUFFER_SHADER_STORAGE)), 
+                "Can only bind the range of a uniform or shader storage buffer");
+  NIKOLA_ASSERT(((offset % buff->gfx->uniform_alignment) == 0), "Unaligned buffer range offset");
+
+  // Ring buffers are offset by their current partition
+  sizei buff_offset = buff->mapped_data ? get_ring_offset(buff) : 0;
+  if(buff->desc.type == GFX_BUFFER_SHADER_STORAGE) {
+    bind_storage_buffer(buff->gfx, bind_point, buff->id, buff_offset + offset, size);
+    return;
+  }
+
+  glBindBufferRange(buff->gl_buff_type, bind_point, buff->id, buff_offset + offset, size);
+}
+
 /// Buffer functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
@@ -1056,8 +2887,8 @@ void gfx_buffer_update(GfxBuffer* buff, const sizei offset, const sizei size, co
 
 GfxShader* gfx_shader_create(GfxContext* gfx, const GfxShaderDesc& desc) {
   NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
-  NIKOLA_ASSERT(desc.vertex_source, "Invalid Vertex source passed to the shader");
-  NIKOLA_ASSERT(desc.pixel_source, "Invalid Pixel source passed to the shader");
+  NIKOLA_ASSERT((desc.compute_source || desc.vertex_source), "Invalid Vertex source passed to the shader");
+  NIKOLA_ASSERT((desc.compute_source || desc.pixel_source), "Invalid Pixel source passed to the shader");
 
   GfxShader* shader = (GfxShader*)memory_allocate(sizeof(GfxShader));
   memory_zero(shader, sizeof(GfxShader));
@@ -1065,33 +2896,68 @@ GfxShader* gfx_shader_create(GfxContext* gfx, const GfxShaderDesc& desc) {
   shader->gfx  = gfx;
   shader->desc = desc;
 
-  i32 vert_src_len = strlen(shader->desc.vertex_source);
-  i32 frag_src_len = strlen(shader->desc.pixel_source);
+  // Try to skip the compiler entirely with a previously linked binary
+  u64 cache_key = 0;
+  if(gfx->desc.shader_cache_dir) {
+    cache_key = hash_tagged_string(gfx->driver_hash, GFX_SHADER_VERTEX, desc.vertex_source);
+    cache_key = hash_tagged_string(cache_key, GFX_SHADER_PIXEL, desc.pixel_source);
+    cache_key = hash_tagged_string(cache_key, GFX_SHADER_COMPUTE, desc.compute_source);
 
-  // Vertex shader
-  shader->vert_id = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(shader->vert_id, 1, &shader->desc.vertex_source, &vert_src_len); 
-  glCompileShader(shader->vert_id);
-  check_shader_compile_error(shader->vert_id);
-    
-  // Fragment shader
-  shader->frag_id = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(shader->frag_id, 1, &shader->desc.pixel_source, &frag_src_len); 
-  glCompileShader(shader->frag_id);
-  check_shader_compile_error(shader->frag_id);
+    if(load_cached_program(shader, cache_key)) {
+      reflect_shader_uniforms(shader);
+      return shader;
+    }
+  }
 
-  // Linking
   shader->id = glCreateProgram();
-  glAttachShader(shader->id, shader->vert_id);
-  glAttachShader(shader->id, shader->frag_id);
-  glLinkProgram(shader->id);
-  check_shader_linker_error(shader);
+  if(gfx->desc.shader_cache_dir) {
+    glProgramParameteri(shader->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+
+  bool is_linked = false;
+
+  // Compute shaders are linked on their own
+  if(desc.compute_source) {
+    NIKOLA_ASSERT((!desc.vertex_source && !desc.pixel_source), "A compute shader cannot have any other stages");
+
+    shader->comp_id = compile_gl_shader(GL_COMPUTE_SHADER, desc.compute_source);
+
+    glAttachShader(shader->id, shader->comp_id);
+    glLinkProgram(shader->id);
+    is_linked = check_shader_linker_error(shader);
+
+    glDetachShader(shader->id, shader->comp_id);
+    glDeleteShader(shader->comp_id);
+  }
+  else {
+    // Vertex shader
+    shader->vert_id = compile_gl_shader(GL_VERTEX_SHADER, desc.vertex_source);
+    
+    // Fragment shader
+    shader->frag_id = compile_gl_shader(GL_FRAGMENT_SHADER, desc.pixel_source);
+
+    // Linking
+    glAttachShader(shader->id, shader->vert_id);
+    glAttachShader(shader->id, shader->frag_id);
+    glLinkProgram(shader->id);
+    is_linked = check_shader_linker_error(shader);
   
-  // Detaching
-  glDetachShader(shader->id, shader->vert_id);
-  glDetachShader(shader->id, shader->frag_id);
-  glDeleteShader(shader->vert_id);
-  glDeleteShader(shader->frag_id);
+    // Detaching
+    glDetachShader(shader->id, shader->vert_id);
+    glDetachShader(shader->id, shader->frag_id);
+    glDeleteShader(shader->vert_id);
+    glDeleteShader(shader->frag_id);
+  }
+
+  // Save the binary for the next run
+  if(is_linked && gfx->desc.shader_cache_dir) {
+    save_cached_program(shader, cache_key);
+  }
+
+  // Look up all of the active uniforms once rather than every time they are needed
+  if(is_linked) {
+    reflect_shader_uniforms(shader);
+  }
 
   return shader;
 }
@@ -1101,6 +2967,23 @@ void gfx_shader_destroy(GfxShader* shader) {
     return;
   }
   
+  // Never keep a deleted program around in the cache
+  if(shader->gfx->cache.program == shader->id) {
+    shader->gfx->cache.program = 0;
+  }
+
+  if(shader->uniforms) {
+    memory_free(shader->uniforms);
+  }
+  
+  if(shader->blocks) {
+    memory_free(shader->blocks);
+  }
+  
+  if(shader->attributes) {
+    memory_free(shader->attributes);
+  }
+
   glDeleteProgram(shader->id);
   memory_free(shader);
 }
@@ -1112,14 +2995,34 @@ GfxShaderDesc& gfx_shader_get_source(GfxShader* shader) {
 void gfx_shader_attach_uniform(GfxShader* shader, const GfxShaderType type, GfxBuffer* buffer, const u32 bind_point) {
   NIKOLA_ASSERT(shader->gfx, "Invalid GfxContext struct passed");
   NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
-      
+  
+  buffer->bind_point = bind_point;
+
+  // Ring buffers only expose their current partition
+  if(buffer->mapped_data) {
+    glBindBufferRange(GL_UNIFORM_BUFFER, bind_point, buffer->id, get_ring_offset(buffer), buffer->desc.size);
+    return;
+  }
+
   glBindBufferBase(GL_UNIFORM_BUFFER, bind_point, buffer->id);
 }
 
 i32 gfx_glsl_get_uniform_location(GfxShader* shader, const i8* uniform_name) {
   NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
   
-  return glGetUniformLocation(shader->id, uniform_name);
+  return find_shader_uniform(shader->uniforms, shader->uniforms_count, uniform_name);
+}
+
+i32 gfx_glsl_get_uniform_block_binding(GfxShader* shader, const i8* block_name) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+  
+  return find_shader_uniform(shader->blocks, shader->blocks_count, block_name);
+}
+
+i32 gfx_glsl_get_attribute_location(GfxShader* shader, const i8* attribute_name) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+  
+  return find_shader_uniform(shader->attributes, shader->attributes_count, attribute_name);
 }
 
 void gfx_glsl_upload_uniform_array(GfxShader* shader, const i32 location, const sizei count, const GfxLayoutType type, const void* data) {
@@ -1131,7 +3034,7 @@ void gfx_glsl_upload_uniform_array(GfxShader* shader, const i32 location, const
     return;
   }
 
-  glUseProgram(shader->id);
+  bind_program(shader->gfx, shader->id);
 
   switch(type) {
     case GFX_LAYOUT_FLOAT1:
@@ -1179,53 +3082,23 @@ void gfx_glsl_upload_uniform_array(GfxShader* shader, const i32 location, const
     case GFX_LAYOUT_MAT4:
       glUniformMatrix4fv(location, count, GL_FALSE, (f32*)data);
       break;
-  }
-}
-
-void gfx_glsl_upload_uniform(GfxShader* shader, const i32 location, const GfxLayoutType type, const void* data) {
-  gfx_glsl_upload_uniform_array(shader, location, 1, type, data);
-}
-
-/// Shader functions 
-///---------------------------------------------------------------------------------------------------------------------
-
-///---------------------------------------------------------------------------------------------------------------------
-/// Texture functions 
-
-GfxTexture* gfx_texture_create(GfxContext* gfx, const GfxTextureDesc& desc) {
-  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
-
-  GfxTexture* texture = (GfxTexture*)memory_allocate(sizeof(GfxTexture));
-  memory_zero(texture, sizeof(GfxTexture));
- 
-  texture->desc = desc;
-  texture->gfx  = gfx;
-  
-  // Getting the appropriate GL pixel format
-  GLenum in_format, gl_format, gl_pixel_type;
-  get_texture_gl_format(desc.format, &in_format, &gl_format, &gl_pixel_type);
-
-  // Getting the appropriate GL addressing modes
-  GLenum gl_wrap_format = get_texture_gl_wrap(desc.wrap_mode);
-  
-  // Getting the appropriate GL filters
-  GLenum min_filter, mag_filter;
-  get_texture_gl_filter(desc.filter, &min_filter, &mag_filter); 
-  
-  // Creating the texutre based on its type
-  texture->id = create_gl_texture(desc.type);
+  }
+}
 
-  // Setting texture parameters
-  glTextureParameteri(texture->id, GL_TEXTURE_WRAP_S, gl_wrap_format);
-  glTextureParameteri(texture->id, GL_TEXTURE_WRAP_T, gl_wrap_format);
-  glTextureParameteri(texture->id, GL_TEXTURE_MIN_FILTER, min_filter);
-  glTextureParameteri(texture->id, GL_TEXTURE_MAG_FILTER, mag_filter);
+void gfx_glsl_upload_uniform(GfxShader* shader, const i32 location, const GfxLayoutType type, const void* data) {
+  gfx_glsl_upload_uniform_array(shader, location, 1, type, data);
+}
 
-  // Filling the texture with the data based on its type
-  update_gl_texture_storage(texture, in_format, gl_format, gl_pixel_type);
+/// Shader functions 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Texture functions 
 
-  // Generating some mipmaps
-  glGenerateTextureMipmap(texture->id);
+GfxTexture* gfx_texture_create(GfxContext* gfx, const GfxTextureDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxTexture* texture = create_texture(gfx, desc);
 
   // Set the render target texture (if it is so) to the framebuffer 
   apply_gl_render_target(gfx, texture);
@@ -1238,7 +3111,12 @@ void gfx_texture_destroy(GfxTexture* texture) {
     return;
   }
   
-  glDeleteTextures(1, &texture->id);
+  // Any cached framebuffers would be left with a dangling target
+  if(texture->desc.type == GFX_TEXTURE_RENDER_TARGET || texture->desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET) {
+    release_target_framebuffers(texture->gfx, texture);
+  }
+
+  destroy_gl_texture(texture);
   
   if(texture->desc.data) {
     memory_free(texture->desc.data); 
@@ -1254,33 +3132,60 @@ GfxTextureDesc& gfx_texture_get_desc(GfxTexture* texture) {
 }
 
 void gfx_texture_update(GfxTexture* texture, const GfxTextureDesc& desc) {
-  NIKOLA_ASSERT(texture->gfx, "Invalid GfxContext struct passed");
   NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+  NIKOLA_ASSERT(texture->gfx, "Invalid GfxContext struct passed");
  
+  GfxTextureDesc old_desc = texture->desc;
+  
   texture->desc = desc;
+  resolve_texture_mips(texture->desc);
 
   // Updating the formats
   GLenum in_format, gl_format, gl_pixel_type;
   get_texture_gl_format(desc.format, &in_format, &gl_format, &gl_pixel_type);
 
-  // Updating the addressing mode
-  GLenum gl_wrap_format = get_texture_gl_wrap(desc.wrap_mode);
-  
-  // Updating the filters
-  GLenum min_filter, mag_filter;
-  get_texture_gl_filter(desc.filter, &min_filter, &mag_filter); 
+  // The storage of a texture cannot be re-specified once allocated, 
+  // so a new texture has to be created if the layout has changed.
+  bool storage_changed = old_desc.width  != texture->desc.width  || 
+                         old_desc.height != texture->desc.height || 
+                         old_desc.depth  != texture->desc.depth  || 
+                         old_desc.mips   != texture->desc.mips   || 
+                         old_desc.type   != texture->desc.type   || 
+                         old_desc.format != texture->desc.format || 
+                         old_desc.samples != texture->desc.samples;
+
+  if(storage_changed) {
+    // Cached framebuffers still point to the old storage
+    release_target_framebuffers(texture->gfx, texture);
+
+    // The old texture needs its old type to be destroyed correctly
+    texture->desc.type = old_desc.type; 
+    destroy_gl_texture(texture);
+
+    texture->desc.type = desc.type; 
+    texture->id        = create_gl_texture(desc.type, desc.samples);
+    allocate_gl_texture_storage(texture, in_format);
+  }
 
   // Set texture parameters again
-  glTextureParameteri(texture->id, GL_TEXTURE_WRAP_S, gl_wrap_format);
-  glTextureParameteri(texture->id, GL_TEXTURE_WRAP_T, gl_wrap_format);
-  glTextureParameteri(texture->id, GL_TEXTURE_MIN_FILTER, min_filter);
-  glTextureParameteri(texture->id, GL_TEXTURE_MAG_FILTER, mag_filter);
+  set_gl_texture_parameters(texture);
   
-  // updating the whole texture
-  update_gl_texture_storage(texture, in_format, gl_format, gl_pixel_type);
+  // Updating the whole texture
+  upload_gl_texture_pixels(texture, in_format, gl_format, gl_pixel_type);
+
+  // The framebuffer still points to the old render target
+  if(storage_changed) {
+    apply_gl_render_target(texture->gfx, texture);
+  }
+}
+
+void gfx_texture_update(GfxTexture* texture, const u32 layer, const void* data) {
+  NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+  NIKOLA_ASSERT((texture->desc.type == GFX_TEXTURE_2D_ARRAY), "Only a GFX_TEXTURE_2D_ARRAY can be updated per layer");
+  NIKOLA_ASSERT((layer < texture->desc.depth), "Texture layer out of bounds");
+  NIKOLA_ASSERT(data, "Cannot update a texture layer with invalid data");
 
-  // Re-generate some mipmaps
-  glGenerateTextureMipmap(texture->id);
+  upload_gl_texture_layer(texture, layer, data);
 }
 
 /// Texture functions 
@@ -1289,6 +3194,33 @@ void gfx_texture_update(GfxTexture* texture, const GfxTextureDesc& desc) {
 ///---------------------------------------------------------------------------------------------------------------------
 /// Cubemap functions 
 
+static void allocate_gl_cubemap_storage(GfxCubemap* cubemap, GLenum in_format) {
+  GfxCubemapDesc& desc = cubemap->desc;
+
+  glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &cubemap->id);
+  glTextureStorage2D(cubemap->id, get_cubemap_levels(desc), in_format, desc.width, desc.height);
+}
+
+static void upload_gl_cubemap_faces(GfxCubemap* cubemap, GLenum gl_format, GLenum gl_pixel_type) {
+  GfxCubemapDesc& desc = cubemap->desc;
+
+  // Only the base level of each face is given...
+  for(sizei i = 0; i < desc.faces_count; i++) {
+    glTextureSubImage3D(cubemap->id,                 // Texture
+                        0,                           // Level
+                        0, 0, i,                     // Offset (x, y, z)
+                        desc.width, desc.height, 1,  // Size (width, height, depth)
+                        gl_format,                   // Format
+                        gl_pixel_type,               // Type
+                        desc.data[i]);               // Pixels
+  }
+
+  // ...so the rest of the chain has to be generated from it
+  if(get_cubemap_levels(desc) > 1) {
+    glGenerateTextureMipmap(cubemap->id);
+  }
+}
+
 GfxCubemap* gfx_cubemap_create(GfxContext* gfx, const GfxCubemapDesc& desc) {
   NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
 
@@ -1309,7 +3241,7 @@ GfxCubemap* gfx_cubemap_create(GfxContext* gfx, const GfxCubemapDesc& desc) {
   GLenum min_filter, mag_filter;
   get_texture_gl_filter(desc.filter, &min_filter, &mag_filter); 
 
-  glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &cubemap->id);
+  allocate_gl_cubemap_storage(cubemap, in_format);
   
   // Setting some parameters
   glTextureParameteri(cubemap->id, GL_TEXTURE_MIN_FILTER, min_filter);
@@ -1317,19 +3249,9 @@ GfxCubemap* gfx_cubemap_create(GfxContext* gfx, const GfxCubemapDesc& desc) {
   glTextureParameteri(cubemap->id, GL_TEXTURE_WRAP_S, gl_wrap_format);
   glTextureParameteri(cubemap->id, GL_TEXTURE_WRAP_T, gl_wrap_format);
   glTextureParameteri(cubemap->id, GL_TEXTURE_WRAP_R, gl_wrap_format);
-    
-  glTextureStorage2D(cubemap->id, desc.mips, in_format, desc.width, desc.height);
 
   // Set the texture for each face in the cubemap
-  for(sizei i = 0; i < desc.faces_count; i++) {
-    glTextureSubImage3D(cubemap->id,                 // Texture
-                        0,                           // Levels
-                        0, 0, i,                     // Offset (x, y, z)
-                        desc.width, desc.height, 1,  // Size (width, height, depth)
-                        gl_format,                   // Format
-                        gl_pixel_type,               // Type
-                        desc.data[i]);               // Pixels
-  }
+  upload_gl_cubemap_faces(cubemap, gl_format, gl_pixel_type);
 
   return cubemap;
 }
@@ -1339,6 +3261,7 @@ void gfx_cubemap_destroy(GfxCubemap* cubemap) {
     return;
   }
   
+  invalidate_texture_unit(cubemap->gfx, cubemap->id);
   glDeleteTextures(1, &cubemap->id);
   memory_free(cubemap);
 }
@@ -1353,12 +3276,27 @@ void gfx_cubemap_update(GfxCubemap* cubemap, const GfxCubemapDesc& desc) {
   NIKOLA_ASSERT(cubemap->gfx, "Invalid GfxContext struct passed");
   NIKOLA_ASSERT(cubemap, "Invalid GfxCubemap struct passed");
   
-  cubemap->desc = desc;
+  GfxCubemapDesc old_desc = cubemap->desc;
+  cubemap->desc           = desc;
   
   // Updating the format
   GLenum in_format, gl_format, gl_pixel_type;
   get_texture_gl_format(desc.format, &in_format, &gl_format, &gl_pixel_type);
 
+  // Just like textures, the immutable storage can only be replaced 
+  // by a whole new cubemap if the layout has changed.
+  bool storage_changed = old_desc.width  != desc.width  || 
+                         old_desc.height != desc.height || 
+                         old_desc.format != desc.format || 
+                         get_cubemap_levels(old_desc) != get_cubemap_levels(desc);
+
+  if(storage_changed) {
+    invalidate_texture_unit(cubemap->gfx, cubemap->id);
+    glDeleteTextures(1, &cubemap->id);
+
+    allocate_gl_cubemap_storage(cubemap, in_format);
+  }
+
   // Updating the addressing mode
   GLenum gl_wrap_format = get_texture_gl_wrap(desc.wrap_mode);
   
@@ -1373,24 +3311,97 @@ void gfx_cubemap_update(GfxCubemap* cubemap, const GfxCubemapDesc& desc) {
   glTextureParameteri(cubemap->id, GL_TEXTURE_WRAP_T, gl_wrap_format);
   glTextureParameteri(cubemap->id, GL_TEXTURE_WRAP_R, gl_wrap_format);
 
-  // Updating the storage
-  glTextureStorage2D(cubemap->id, desc.mips, in_format, desc.width, desc.height);
-
   // Updating the texture image
-  for(sizei i = 0; i < desc.faces_count; i++) {
-    glTextureSubImage3D(cubemap->id,                 // Texture
-                        desc.mips,                   // Mipmaps 
-                        0, 0, i,                     // Offset (x, y, z)
-                        desc.width, desc.height, 1,  // Size (width, height, depth)
-                        gl_format,                   // Format
-                        gl_pixel_type,               // Type
-                        desc.data[i]);               // Pixels
-  }
+  upload_gl_cubemap_faces(cubemap, gl_format, gl_pixel_type);
 }
 
 /// Cubemap functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Sampler functions 
+
+GfxSampler* gfx_sampler_create(GfxContext* gfx, const GfxSamplerDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  // Hand out the same sampler for the same description
+  u64 hash = hash_sampler_desc(desc);
+  for(sizei i = 0; i < gfx->samplers_count; i++) {
+    if(gfx->samplers[i]->hash == hash) {
+      gfx->samplers[i]->ref_count++;
+      return gfx->samplers[i];
+    }
+  }
+
+  NIKOLA_ASSERT((gfx->samplers_count < SAMPLERS_MAX), "Too many unique samplers in the context");
+
+  GfxSampler* sampler = (GfxSampler*)memory_allocate(sizeof(GfxSampler));
+  memory_zero(sampler, sizeof(GfxSampler));
+
+  sampler->desc      = desc;
+  sampler->gfx       = gfx;
+  sampler->hash      = hash;
+  sampler->ref_count = 1;
+
+  glCreateSamplers(1, &sampler->id);
+
+  // Getting the appropriate GL filters
+  GLenum min_filter, mag_filter;
+  get_texture_gl_filter(desc.filter, &min_filter, &mag_filter); 
+  
+  GLenum gl_wrap_format = get_texture_gl_wrap(desc.wrap_mode);
+  f32 anisotropy        = desc.max_anisotropy < gfx->max_anisotropy ? desc.max_anisotropy : gfx->max_anisotropy;
+
+  glSamplerParameteri(sampler->id, GL_TEXTURE_MIN_FILTER, min_filter);
+  glSamplerParameteri(sampler->id, GL_TEXTURE_MAG_FILTER, mag_filter);
+  glSamplerParameteri(sampler->id, GL_TEXTURE_WRAP_S, gl_wrap_format);
+  glSamplerParameteri(sampler->id, GL_TEXTURE_WRAP_T, gl_wrap_format);
+  glSamplerParameteri(sampler->id, GL_TEXTURE_WRAP_R, gl_wrap_format);
+  glSamplerParameterfv(sampler->id, GL_TEXTURE_BORDER_COLOR, desc.border_color);
+  glSamplerParameterf(sampler->id, GL_TEXTURE_MAX_ANISOTROPY, anisotropy > 1.0f ? anisotropy : 1.0f);
+  glSamplerParameterf(sampler->id, GL_TEXTURE_MIN_LOD, desc.min_lod);
+  glSamplerParameterf(sampler->id, GL_TEXTURE_MAX_LOD, desc.max_lod);
+  glSamplerParameterf(sampler->id, GL_TEXTURE_LOD_BIAS, desc.lod_bias);
+
+  gfx->samplers[gfx->samplers_count++] = sampler;
+  return sampler;
+}
+
+void gfx_sampler_destroy(GfxSampler* sampler) {
+  if(!sampler) {
+    return;
+  }
+
+  // Someone else is still using the sampler
+  sampler->ref_count--;
+  if(sampler->ref_count > 0) {
+    return;
+  }
+
+  // Remove the sampler from the context
+  GfxContext* gfx = sampler->gfx;
+  for(sizei i = 0; i < gfx->samplers_count; i++) {
+    if(gfx->samplers[i] == sampler) {
+      gfx->samplers[i] = gfx->samplers[--gfx->samplers_count];
+      break;
+    }
+  }
+
+  invalidate_sampler_unit(gfx, sampler->id);
+  glDeleteSamplers(1, &sampler->id);
+
+  memory_free(sampler);
+}
+
+const GfxSamplerDesc& gfx_sampler_get_desc(GfxSampler* sampler) {
+  NIKOLA_ASSERT(sampler, "Invalid GfxSampler struct passed");
+
+  return sampler->desc;
+}
+
+/// Sampler functions 
+///---------------------------------------------------------------------------------------------------------------------
+
 ///---------------------------------------------------------------------------------------------------------------------
 /// Pipeline functions 
 
@@ -1403,26 +3414,17 @@ GfxPipeline* gfx_pipeline_create(GfxContext* gfx, const GfxPipelineDesc& desc) {
   pipe->desc = desc;
   pipe->gfx  = gfx;
 
-  // VAO init
-  glCreateVertexArrays(1, &pipe->vertex_array);
-
-  // Layout init 
-  sizei stride = set_buffer_layout(pipe->vertex_array, desc.layout, desc.layout_count); 
   NIKOLA_ASSERT(desc.vertex_buffer, "Must have a vertex buffer to create a GfxPipeline struct");
 
-  // VBO init
-  pipe->vertex_buffer = desc.vertex_buffer; 
-  pipe->vertex_count  = desc.vertices_count; 
-
-  glVertexArrayVertexBuffer(pipe->vertex_array, 0, pipe->vertex_buffer->id, 0, stride);
-
-  // EBO init
-  if(desc.index_buffer) {
-    pipe->index_buffer = desc.index_buffer;
-    pipe->index_count  = desc.indices_count;
+  // Buffers init
+  pipe->vertex_buffer   = desc.vertex_buffer; 
+  pipe->vertex_count    = desc.vertices_count; 
+  pipe->index_buffer    = desc.index_buffer;
+  pipe->index_count     = desc.indices_count;
+  pipe->instance_buffer = desc.instance_buffer;
 
-    glVertexArrayElementBuffer(pipe->vertex_array, pipe->index_buffer->id);
-  }
+  // VAO init
+  pipe->vertex_array = acquire_vertex_array(gfx, desc, desc.instance_buffer);
   
   // Shader init 
   pipe->shader = desc.shader; 
@@ -1441,6 +3443,9 @@ GfxPipeline* gfx_pipeline_create(GfxContext* gfx, const GfxPipelineDesc& desc) {
   for(sizei i = 0; i < desc.cubemaps_count; i++) {
     pipe->cubemaps[i] = desc.cubemaps[i]->id;
   }  
+
+  // Samplers init
+  set_pipeline_samplers(pipe, desc);
     
   return pipe;
 }
@@ -1448,8 +3453,8 @@ GfxPipeline* gfx_pipeline_create(GfxContext* gfx, const GfxPipelineDesc& desc) {
 void gfx_pipeline_destroy(GfxPipeline* pipeline) {
   NIKOLA_ASSERT(pipeline, "Attempting to free an invalid GfxPipeline");
 
-  // Deleting the buffers
-  glDeleteVertexArrays(1, &pipeline->vertex_array);
+  // Let go of the (possibly shared) vertex array
+  release_vertex_array(pipeline->gfx, pipeline->vertex_array);
 
   // Free the pipeline
   memory_free(pipeline);
@@ -1466,63 +3471,266 @@ void gfx_pipeline_draw_vertex(GfxPipeline* pipeline) {
   NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
   NIKOLA_ASSERT(pipeline->vertex_buffer, "Must have a valid vertex buffer to draw");
 
-  // Bind the vertex array
-  glBindVertexArray(pipeline->vertex_array);
+  // Bind the vertex array, shader, and textures
+  bind_pipeline_state(pipeline);
 
-  // Bind the shader
-  glUseProgram(pipeline->desc.shader->id);
-  
-  // Draw the cubemaps
-  if(pipeline->cubemaps_count > 0) {
-    glBindTextures(0, pipeline->cubemaps_count, pipeline->cubemaps);
-  } 
+  // Draw the vertices
+  GLenum draw_mode = get_draw_mode(pipeline->desc.draw_mode); 
+  glDrawArrays(draw_mode, pipeline->desc.vertices_offset, pipeline->desc.vertices_count);
+}
 
-  // Draw the textures
-  if(pipeline->textures_count > 0) {
-    glBindTextures(0, pipeline->textures_count, pipeline->textures);
-  }
+void gfx_pipeline_draw_index(GfxPipeline* pipeline) {
+  NIKOLA_ASSERT(pipeline->gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(pipeline->vertex_buffer, "Must have a valid vertex buffer to draw");
+  NIKOLA_ASSERT(pipeline->index_buffer, "Must have a valid index buffer to draw");
 
-  // Draw the vertices
+  // Bind the vertex array, shader, and textures
+  bind_pipeline_state(pipeline);
+
+  // Draw the indices
   GLenum draw_mode = get_draw_mode(pipeline->desc.draw_mode); 
-  glDrawArrays(draw_mode, 0, pipeline->desc.vertices_count);
+  glDrawElementsBaseVertex(draw_mode, 
+                           pipeline->desc.indices_count, 
+                           GL_UNSIGNED_INT, 
+                           (void*)(pipeline->desc.indices_offset * sizeof(u32)), 
+                           pipeline->desc.vertices_offset);
+}
+
+void gfx_pipeline_draw_vertex_instanced(GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance) {
+  NIKOLA_ASSERT(pipeline->gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(pipeline->vertex_buffer, "Must have a valid vertex buffer to draw");
 
-  // Unbind the vertex array for debugging purposes
-  glBindVertexArray(0);
+  // Bind the vertex array, shader, and textures
+  bind_pipeline_state(pipeline);
+
+  // Draw the vertices for each instance
+  GLenum draw_mode = get_draw_mode(pipeline->desc.draw_mode); 
+  glDrawArraysInstancedBaseInstance(draw_mode, pipeline->desc.vertices_offset, pipeline->desc.vertices_count, instance_count, base_instance);
 }
 
-void gfx_pipeline_draw_index(GfxPipeline* pipeline) {
+void gfx_pipeline_draw_index_instanced(GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance) {
   NIKOLA_ASSERT(pipeline->gfx, "Invalid GfxContext struct passed");
   NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
   NIKOLA_ASSERT(pipeline->vertex_buffer, "Must have a valid vertex buffer to draw");
   NIKOLA_ASSERT(pipeline->index_buffer, "Must have a valid index buffer to draw");
 
-  // Bind the vertex array
-  glBindVertexArray(pipeline->vertex_array);
+  // Bind the vertex array, shader, and textures
+  bind_pipeline_state(pipeline);
 
-  // Bind the shader
-  glUseProgram(pipeline->desc.shader->id);
+  // Draw the indices for each instance
+  GLenum draw_mode = get_draw_mode(pipeline->desc.draw_mode); 
+  glDrawElementsInstancedBaseVertexBaseInstance(draw_mode, 
+                                                pipeline->desc.indices_count, 
+                                                GL_UNSIGNED_INT, 
+                                                (void*)(pipeline->desc.indices_offset * sizeof(u32)), 
+                                                instance_count, 
+                                                pipeline->desc.vertices_offset, 
+                                                base_instance);
+}
 
-  // Draw the cubemaps
-  if(pipeline->cubemaps_count > 0) {
-    glBindTextures(0, pipeline->cubemaps_count, pipeline->cubemaps);
-  } 
+void gfx_pipeline_draw_indirect(GfxPipeline* pipeline, GfxBuffer* indirect_buffer, const sizei count) {
+  NIKOLA_ASSERT(pipeline->gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(pipeline->index_buffer, "Must have a valid index buffer to draw");
+  NIKOLA_ASSERT(indirect_buffer, "Must have a valid indirect buffer to draw");
+  NIKOLA_ASSERT((indirect_buffer->desc.type == GFX_BUFFER_DRAW_INDIRECT), "Invalid indirect buffer type");
 
-  // Draw the textures
-  if(pipeline->textures_count > 0) {
-    glBindTextures(0, pipeline->textures_count, pipeline->textures);
-  }
+  // Bind the vertex array, shader, and textures
+  bind_pipeline_state(pipeline);
 
-  // Draw the indices
+  // Bind the commands buffer
+  bind_draw_indirect_buffer(pipeline->gfx, indirect_buffer->id);
+
+  // Draw every command in the buffer
   GLenum draw_mode = get_draw_mode(pipeline->desc.draw_mode); 
-  glDrawElements(draw_mode, pipeline->desc.indices_count, GL_UNSIGNED_INT, 0);
-  
-  // Unbind the vertex array for debugging purposes
-  glBindVertexArray(0);
+  glMultiDrawElementsIndirect(draw_mode, GL_UNSIGNED_INT, 0, count, sizeof(GfxDrawIndirectCommand));
 }
 
 /// Pipeline functions 
 ///---------------------------------------------------------------------------------------------------------------------
 
+///---------------------------------------------------------------------------------------------------------------------
+/// Compute pipeline functions 
+
+GfxComputePipeline* gfx_compute_pipeline_create(GfxContext* gfx, const GfxComputePipelineDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(desc.shader, "Must have a valid compute shader in a compute pipeline");
+  NIKOLA_ASSERT(desc.shader->desc.compute_source, "Cannot use a non-compute shader in a compute pipeline");
+  NIKOLA_ASSERT((desc.storage_buffers_count <= STORAGE_BUFFERS_MAX), "Too many storage buffers in a compute pipeline");
+  NIKOLA_ASSERT((desc.images_count <= IMAGES_MAX), "Too many images in a compute pipeline");
+  NIKOLA_ASSERT((desc.textures_count <= TEXTURES_MAX), "Too many textures in a compute pipeline");
+
+  for(sizei i = 0; i < desc.storage_buffers_count; i++) {
+    NIKOLA_ASSERT(desc.storage_buffers[i], "Invalid storage buffer in a compute pipeline");
+    NIKOLA_ASSERT((desc.storage_buffers[i]->desc.type == GFX_BUFFER_SHADER_STORAGE), "Invalid storage buffer type");
+  }
+
+  GfxComputePipeline* pipeline = (GfxComputePipeline*)memory_allocate(sizeof(GfxComputePipeline));
+  memory_zero(pipeline, sizeof(GfxComputePipeline));
+
+  pipeline->desc = desc;
+  pipeline->gfx  = gfx;
+
+  return pipeline;
+}
+
+void gfx_compute_pipeline_destroy(GfxComputePipeline* pipeline) {
+  if(!pipeline) {
+    return;
+  }
+
+  memory_free(pipeline);
+}
+
+GfxComputePipelineDesc& gfx_compute_pipeline_get_desc(GfxComputePipeline* pipeline) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxComputePipeline struct passed");
+
+  return pipeline->desc;
+}
+
+void gfx_compute_dispatch(GfxComputePipeline* pipeline, const u32 groups_x, const u32 groups_y, const u32 groups_z) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxComputePipeline struct passed");
+
+  // Bind the shader, buffers, images, and textures
+  bind_compute_state(pipeline);
+
+  glDispatchCompute(groups_x, groups_y, groups_z);
+}
+
+void gfx_compute_dispatch_indirect(GfxComputePipeline* pipeline, GfxBuffer* indirect_buffer, const sizei offset) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxComputePipeline struct passed");
+  NIKOLA_ASSERT(indirect_buffer, "Must have a valid indirect buffer to dispatch");
+  NIKOLA_ASSERT((indirect_buffer->desc.type == GFX_BUFFER_DISPATCH_INDIRECT), "Invalid indirect buffer type");
+  NIKOLA_ASSERT(((offset % 4) == 0), "Unaligned indirect dispatch offset");
+
+  // Bind the shader, buffers, images, and textures
+  bind_compute_state(pipeline);
+
+  // Bind the commands buffer
+  bind_dispatch_indirect_buffer(pipeline->gfx, indirect_buffer->id);
+
+  glDispatchComputeIndirect((GLintptr)offset);
+}
+
+/// Compute pipeline functions 
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Readback functions 
+
+GfxReadback* gfx_readback_create(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxReadback* readback = (GfxReadback*)memory_allocate(sizeof(GfxReadback));
+  memory_zero(readback, sizeof(GfxReadback));
+
+  readback->gfx = gfx;
+  glCreateBuffers(1, &readback->id);
+
+  return readback;
+}
+
+void gfx_readback_destroy(GfxReadback* readback) {
+  if(!readback) {
+    return;
+  }
+
+  if(readback->fence) {
+    glDeleteSync(readback->fence);
+  }
+
+  glDeleteBuffers(1, &readback->id);
+  memory_free(readback);
+}
+
+const GfxReadbackDesc& gfx_readback_get_desc(GfxReadback* readback) {
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  return readback->desc;
+}
+
+const bool gfx_readback_is_pending(GfxReadback* readback) {
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  return readback->fence != nullptr;
+}
+
+const bool gfx_readback_poll(GfxReadback* readback, void* data) {
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+  NIKOLA_ASSERT(data, "Invalid data passed to a readback poll");
+
+  if(!readback->fence) {
+    return false;
+  }
+
+  // Never wait here. Flushing makes sure the fence will be signaled eventually.
+  GLenum result = glClientWaitSync(readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  if(result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+    return false;
+  }
+
+  glDeleteSync(readback->fence);
+  readback->fence = nullptr;
+
+  glGetNamedBufferSubData(readback->id, 0, readback->desc.size, data);
+  return true;
+}
+
+void gfx_texture_read_async(GfxTexture* texture, GfxReadback* readback) {
+  NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+  NIKOLA_ASSERT((texture->desc.type != GFX_TEXTURE_DEPTH_STENCIL_TARGET), "Cannot read back a depth stencil target");
+  NIKOLA_ASSERT(!is_texture_compressed(texture->desc.format), "Cannot read back a compressed texture");
+
+  GLenum in_format, gl_format, gl_type;
+  get_texture_gl_format(texture->desc.format, &in_format, &gl_format, &gl_type);
+
+  begin_gl_readback(readback, texture->desc.width, texture->desc.height, texture->desc.format);
+
+  // With a pack buffer bound, the "pixels" pointer is an offset into the buffer
+  glGetTextureImage(texture->id, 0, gl_format, gl_type, readback->desc.size, nullptr);
+
+  end_gl_readback(readback);
+}
+
+void gfx_context_read_async(GfxContext* gfx, GfxReadback* readback) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  // The viewport always follows the size of the framebuffer
+  i32 viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  GLenum in_format, gl_format, gl_type;
+  get_texture_gl_format(gfx->desc.pixel_format, &in_format, &gl_format, &gl_type);
+
+  begin_gl_readback(readback, viewport[2], viewport[3], gfx->desc.pixel_format);
+  
+  bind_framebuffer(gfx, gfx->current_framebuffer);
+  glReadPixels(0, 0, viewport[2], viewport[3], gl_format, gl_type, nullptr);
+
+  end_gl_readback(readback);
+}
+
+void gfx_buffer_read_async(GfxBuffer* buff, GfxReadback* readback) {
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  // Buffers are just one long row of bytes
+  begin_gl_readback(readback, (u32)buff->desc.size, 1, GFX_TEXTURE_FORMAT_R8);
+
+  // Ring buffers are offset by their current partition
+  sizei offset = buff->mapped_data ? get_ring_offset(buff) : 0;
+  glCopyNamedBufferSubData(buff->id, readback->id, offset, 0, readback->desc.size);
+
+  end_gl_readback(readback);
+}
+
+/// Readback functions 
+///---------------------------------------------------------------------------------------------------------------------
+
 /// *** Graphics ***
 /// ---------------------------------------------------------------------
 
@@ -0,0 +1,880 @@
+#include "nikola/nikola_core.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+#ifdef NIKOLA_GFX_CONTEXT_NULL  // Null check
+
+namespace nikola { // Start of nikola
+
+/// ---------------------------------------------------------------------
+/// *** Graphics ***
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Consts
+
+/// The initial amount of records the call log can hold before growing.
+const sizei CALL_LOG_INITIAL_CAPACITY = 1024;
+
+/// Most drivers report this alignment for uniform buffer offsets
+const sizei NULL_UNIFORM_ALIGNMENT    = 256;
+
+/// Consts
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxContext
+struct GfxContext {
+  GfxContextDesc desc = {};
+  u32 states          = 0;
+
+  u32 next_id         = 0;
+  sizei live_objects  = 0;
+
+  bool is_recording   = false;
+
+  GfxCallRecord* calls  = nullptr;
+  sizei calls_count     = 0;
+  sizei calls_capacity  = 0;
+
+  sizei frame_index     = 0;
+
+  GfxTexture* transient_targets[TRANSIENT_TARGETS_MAX]  = {};
+  sizei transient_frames[TRANSIENT_TARGETS_MAX]         = {};
+  bool transient_in_use[TRANSIENT_TARGETS_MAX]          = {};
+  sizei transient_targets_count                         = 0;
+};
+/// GfxContext
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxBuffer
+struct GfxBuffer {
+  GfxBufferDesc desc = {};
+  GfxContext* gfx    = nullptr;
+
+  u32 id;
+};
+/// GfxBuffer
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxShader
+struct GfxShader {
+  GfxShaderDesc desc = {};
+  GfxContext* gfx    = nullptr;
+
+  u32 id;
+};
+/// GfxShader
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxTexture
+struct GfxTexture {
+  GfxTextureDesc desc = {};
+  GfxContext* gfx     = nullptr;
+
+  u32 id;
+};
+/// GfxTexture
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxCubemap
+struct GfxCubemap {
+  GfxCubemapDesc desc = {};
+  GfxContext* gfx     = nullptr;
+
+  u32 id;
+};
+/// GfxCubemap
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxSampler
+struct GfxSampler {
+  GfxSamplerDesc desc = {};
+  GfxContext* gfx     = nullptr;
+
+  u32 id;
+};
+/// GfxSampler
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxPipeline
+struct GfxPipeline {
+  GfxPipelineDesc desc = {};
+  GfxContext* gfx      = nullptr;
+
+  u32 id;
+};
+/// GfxPipeline
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxComputePipeline
+struct GfxComputePipeline {
+  GfxComputePipelineDesc desc = {};
+  GfxContext* gfx             = nullptr;
+
+  u32 id;
+};
+/// GfxComputePipeline
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// GfxReadback
+struct GfxReadback {
+  GfxReadbackDesc desc = {};
+  GfxContext* gfx      = nullptr;
+
+  u32 id;
+  bool is_pending;
+};
+/// GfxReadback
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Private functions
+
+static void record_call(GfxContext* gfx, const GfxCallType type, const u32 object_id, const u64 arg0 = 0, const u64 arg1 = 0) {
+  if(!gfx->is_recording) {
+    return;
+  }
+
+  // Grow the log when needed
+  if(gfx->calls_count >= gfx->calls_capacity) {
+    gfx->calls_capacity = gfx->calls_capacity == 0 ? CALL_LOG_INITIAL_CAPACITY : (gfx->calls_capacity * 2);
+
+    if(!gfx->calls) {
+      gfx->calls = (GfxCallRecord*)memory_allocate(sizeof(GfxCallRecord) * gfx->calls_capacity);
+    }
+    else {
+      gfx->calls = (GfxCallRecord*)memory_reallocate(gfx->calls, sizeof(GfxCallRecord) * gfx->calls_capacity);
+    }
+  }
+
+  GfxCallRecord& record = gfx->calls[gfx->calls_count++];
+  record.type      = type;
+  record.object_id = object_id;
+  record.args[0]   = arg0;
+  record.args[1]   = arg1;
+}
+
+static u32 track_object(GfxContext* gfx) {
+  gfx->live_objects++;
+  return ++gfx->next_id;
+}
+
+static void untrack_object(GfxContext* gfx) {
+  NIKOLA_ASSERT((gfx->live_objects > 0), "Destroying more graphics objects than were ever created");
+  gfx->live_objects--;
+}
+
+static sizei get_readback_size(const u32 width, const u32 height, const GfxTextureFormat format) {
+  sizei pixel_size = 4;
+
+  switch(format) {
+    case GFX_TEXTURE_FORMAT_R8:
+      pixel_size = 1;
+      break;
+    case GFX_TEXTURE_FORMAT_R16:
+    case GFX_TEXTURE_FORMAT_RG8:
+      pixel_size = 2;
+      break;
+    case GFX_TEXTURE_FORMAT_RGBA16:
+      pixel_size = 8;
+      break;
+    default:
+      break;
+  }
+
+  return (sizei)width * height * pixel_size;
+}
+
+/// Private functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Context functions
+
+GfxContext* gfx_context_init(const GfxContextDesc& desc) {
+  GfxContext* gfx = (GfxContext*)memory_allocate(sizeof(GfxContext));
+  memory_zero(gfx, sizeof(GfxContext));
+
+  gfx->desc   = desc;
+  gfx->states = desc.states;
+
+  NIKOLA_LOG_INFO("A null graphics context was successfully initialized");
+  return gfx;
+}
+
+void gfx_context_shutdown(GfxContext* gfx) {
+  if(!gfx) {
+    return;
+  }
+
+  // The pool owns its targets
+  for(sizei i = 0; i < gfx->transient_targets_count; i++) {
+    gfx_texture_destroy(gfx->transient_targets[i]);
+  }
+
+  if(gfx->live_objects > 0) {
+    NIKOLA_LOG_WARN("Null graphics context was shutdown with %zu objects still alive", gfx->live_objects);
+  }
+
+  if(gfx->calls) {
+    memory_free(gfx->calls);
+  }
+
+  memory_free(gfx);
+  NIKOLA_LOG_INFO("The null graphics context was successfully destroyed");
+}
+
+GfxContextDesc& gfx_context_get_desc(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  return gfx->desc;
+}
+
+void gfx_context_set_state(GfxContext* gfx, const GfxStates state, const bool value) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  gfx->states = value ? (gfx->states | state) : (gfx->states & ~state);
+  record_call(gfx, GFX_CALL_CONTEXT_SET_STATE, 0, state, value);
+}
+
+void gfx_context_clear(GfxContext* gfx, const f32 r, const f32 g, const f32 b, const f32 a, const u32 flags) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  record_call(gfx, GFX_CALL_CONTEXT_CLEAR, 0, flags);
+}
+
+void gfx_context_apply_pipeline(GfxContext* gfx, GfxPipeline* pipeline, const GfxPipelineDesc& pipe_desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  pipeline->desc = pipe_desc;
+  record_call(gfx, GFX_CALL_CONTEXT_APPLY_PIPELINE, pipeline->id, pipe_desc.textures_count, pipe_desc.cubemaps_count);
+}
+
+void gfx_context_present(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  // There is no swapchain to present to
+  record_call(gfx, GFX_CALL_CONTEXT_PRESENT, 0);
+  gfx->frame_index++;
+
+  // Give back every transient target, and let go of the ones unused for too long
+  for(sizei i = 0; i < gfx->transient_targets_count;) {
+    gfx->transient_in_use[i] = false;
+
+    if((gfx->frame_index - gfx->transient_frames[i]) < TRANSIENT_TARGET_FRAMES) {
+      i++;
+      continue;
+    }
+
+    gfx_texture_destroy(gfx->transient_targets[i]);
+    
+    gfx->transient_targets_count--;
+    gfx->transient_targets[i] = gfx->transient_targets[gfx->transient_targets_count];
+    gfx->transient_frames[i]  = gfx->transient_frames[gfx->transient_targets_count];
+    gfx->transient_in_use[i]  = gfx->transient_in_use[gfx->transient_targets_count];
+  }
+}
+
+const u64 gfx_context_get_saved_calls(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  return 0;
+}
+
+const sizei gfx_context_get_uniform_alignment(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  return NULL_UNIFORM_ALIGNMENT;
+}
+
+void gfx_context_memory_barrier(GfxContext* gfx, const u32 barriers) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  record_call(gfx, GFX_CALL_CONTEXT_MEMORY_BARRIER, 0, barriers);
+}
+
+GfxTexture* gfx_context_acquire_target(GfxContext* gfx, const GfxTextureDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT((desc.type == GFX_TEXTURE_RENDER_TARGET || desc.type == GFX_TEXTURE_DEPTH_STENCIL_TARGET), 
+                "Can only acquire targets of type GFX_TEXTURE_RENDER_TARGET or GFX_TEXTURE_DEPTH_STENCIL_TARGET");
+
+  u32 samples = desc.samples > 1 ? desc.samples : 1;
+
+  // Reuse a free target from the previous frames if there is any
+  for(sizei i = 0; i < gfx->transient_targets_count; i++) {
+    const GfxTextureDesc& target_desc = gfx->transient_targets[i]->desc;
+    
+    bool matches = target_desc.width     == desc.width     && 
+                   target_desc.height    == desc.height    && 
+                   target_desc.type      == desc.type      && 
+                   target_desc.format    == desc.format    && 
+                   target_desc.filter    == desc.filter    && 
+                   target_desc.wrap_mode == desc.wrap_mode && 
+                   target_desc.samples   == samples;
+
+    if(matches && !gfx->transient_in_use[i]) {
+      gfx->transient_in_use[i] = true;
+      gfx->transient_frames[i] = gfx->frame_index;
+
+      record_call(gfx, GFX_CALL_CONTEXT_ACQUIRE_TARGET, gfx->transient_targets[i]->id, desc.width, desc.height);
+      return gfx->transient_targets[i];
+    }
+  }
+
+  NIKOLA_ASSERT((gfx->transient_targets_count < TRANSIENT_TARGETS_MAX), "Too many transient targets in use at once");
+
+  GfxTextureDesc target_desc = desc;
+  target_desc.mips           = 1;
+  target_desc.samples        = samples;
+  target_desc.data           = nullptr;
+
+  sizei index                   = gfx->transient_targets_count++;
+  gfx->transient_targets[index] = gfx_texture_create(gfx, target_desc);
+  gfx->transient_in_use[index]  = true;
+  gfx->transient_frames[index]  = gfx->frame_index;
+
+  record_call(gfx, GFX_CALL_CONTEXT_ACQUIRE_TARGET, gfx->transient_targets[index]->id, desc.width, desc.height);
+  return gfx->transient_targets[index];
+}
+
+void gfx_context_set_targets(GfxContext* gfx, GfxTexture** colors, const sizei colors_count, GfxTexture* depth_stencil) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT((colors_count <= RENDER_TARGETS_MAX), "Cannot set more than RENDER_TARGETS_MAX color targets");
+
+  record_call(gfx, GFX_CALL_CONTEXT_SET_TARGETS, colors_count > 0 ? colors[0]->id : 0, colors_count, depth_stencil ? depth_stencil->id : 0);
+}
+
+void gfx_context_set_recording(GfxContext* gfx, const bool record) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  gfx->is_recording = record;
+}
+
+const GfxCallRecord* gfx_context_get_call_log(GfxContext* gfx, sizei* count) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  *count = gfx->calls_count;
+  return gfx->calls;
+}
+
+void gfx_context_clear_call_log(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  // Keep the memory around for the next frame
+  gfx->calls_count = 0;
+}
+
+const sizei gfx_context_get_live_objects(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  return gfx->live_objects;
+}
+
+/// Context functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Buffer functions
+
+GfxBuffer* gfx_buffer_create(GfxContext* gfx, const GfxBufferDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxBuffer* buff = (GfxBuffer*)memory_allocate(sizeof(GfxBuffer));
+  memory_zero(buff, sizeof(GfxBuffer));
+
+  buff->desc = desc;
+  buff->gfx  = gfx;
+  buff->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_BUFFER_CREATE, buff->id, desc.size, desc.type);
+  return buff;
+}
+
+void gfx_buffer_destroy(GfxBuffer* buff) {
+  if(!buff) {
+    return;
+  }
+
+  untrack_object(buff->gfx);
+  record_call(buff->gfx, GFX_CALL_BUFFER_DESTROY, buff->id);
+
+  memory_free(buff);
+}
+
+GfxBufferDesc& gfx_buffer_get_desc(GfxBuffer* buffer) {
+  NIKOLA_ASSERT(buffer, "Invalid GfxBuffer struct passed");
+
+  return buffer->desc;
+}
+
+void gfx_buffer_update(GfxBuffer* buff, const sizei offset, const sizei size, const void* data) {
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+  NIKOLA_ASSERT(((offset + size) <= buff->desc.size), "Updating a buffer out of its bounds");
+
+  record_call(buff->gfx, GFX_CALL_BUFFER_UPDATE, buff->id, offset, size);
+}
+
+void gfx_buffer_bind_range(GfxBuffer* buff, const u32 bind_point, const sizei offset, const sizei size) {
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+  NIKOLA_ASSERT(((offset % NULL_UNIFORM_ALIGNMENT) == 0), "Buffer range offset must follow the uniform alignment");
+
+  record_call(buff->gfx, GFX_CALL_BUFFER_BIND_RANGE, buff->id, bind_point, offset);
+}
+
+/// Buffer functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Shader functions
+
+GfxShader* gfx_shader_create(GfxContext* gfx, const GfxShaderDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT((desc.compute_source || desc.vertex_source), "Invalid Vertex source passed to the shader");
+  NIKOLA_ASSERT((desc.compute_source || desc.pixel_source), "Invalid Pixel source passed to the shader");
+
+  GfxShader* shader = (GfxShader*)memory_allocate(sizeof(GfxShader));
+  memory_zero(shader, sizeof(GfxShader));
+
+  shader->gfx  = gfx;
+  shader->desc = desc;
+  shader->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_SHADER_CREATE, shader->id);
+  return shader;
+}
+
+void gfx_shader_destroy(GfxShader* shader) {
+  if(!shader) {
+    return;
+  }
+
+  untrack_object(shader->gfx);
+  record_call(shader->gfx, GFX_CALL_SHADER_DESTROY, shader->id);
+
+  memory_free(shader);
+}
+
+GfxShaderDesc& gfx_shader_get_source(GfxShader* shader) {
+  return shader->desc;
+}
+
+void gfx_shader_attach_uniform(GfxShader* shader, const GfxShaderType type, GfxBuffer* buffer, const u32 bind_point) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+  NIKOLA_ASSERT(buffer, "Invalid GfxBuffer struct passed");
+
+  record_call(shader->gfx, GFX_CALL_SHADER_ATTACH_UNIFORM, shader->id, buffer->id, bind_point);
+}
+
+i32 gfx_glsl_get_uniform_location(GfxShader* shader, const i8* uniform_name) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+
+  // There is no program to query. Every uniform is treated as missing.
+  return -1;
+}
+
+i32 gfx_glsl_get_uniform_block_binding(GfxShader* shader, const i8* block_name) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+
+  // Same goes for the uniform blocks
+  return -1;
+}
+
+i32 gfx_glsl_get_attribute_location(GfxShader* shader, const i8* attribute_name) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+
+  // And the vertex attributes
+  return -1;
+}
+
+void gfx_glsl_upload_uniform_array(GfxShader* shader, const i32 location, const sizei count, const GfxLayoutType type, const void* data) {
+  NIKOLA_ASSERT(shader, "Invalid GfxShader struct passed");
+
+  record_call(shader->gfx, GFX_CALL_SHADER_UPLOAD_UNIFORM, shader->id, location, count);
+}
+
+void gfx_glsl_upload_uniform(GfxShader* shader, const i32 location, const GfxLayoutType type, const void* data) {
+  gfx_glsl_upload_uniform_array(shader, location, 1, type, data);
+}
+
+/// Shader functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Texture functions
+
+GfxTexture* gfx_texture_create(GfxContext* gfx, const GfxTextureDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxTexture* texture = (GfxTexture*)memory_allocate(sizeof(GfxTexture));
+  memory_zero(texture, sizeof(GfxTexture));
+
+  texture->desc = desc;
+  texture->gfx  = gfx;
+  texture->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_TEXTURE_CREATE, texture->id, desc.width, desc.height);
+  return texture;
+}
+
+void gfx_texture_destroy(GfxTexture* texture) {
+  if(!texture) {
+    return;
+  }
+
+  untrack_object(texture->gfx);
+  record_call(texture->gfx, GFX_CALL_TEXTURE_DESTROY, texture->id);
+
+  // Same ownership rules as the other backends
+  if(texture->desc.data) {
+    memory_free(texture->desc.data);
+  }
+
+  memory_free(texture);
+}
+
+GfxTextureDesc& gfx_texture_get_desc(GfxTexture* texture) {
+  NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+
+  return texture->desc;
+}
+
+void gfx_texture_update(GfxTexture* texture, const GfxTextureDesc& desc) {
+  NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+
+  texture->desc = desc;
+  record_call(texture->gfx, GFX_CALL_TEXTURE_UPDATE, texture->id, desc.width, desc.height);
+}
+
+void gfx_texture_update(GfxTexture* texture, const u32 layer, const void* data) {
+  NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+  NIKOLA_ASSERT((texture->desc.type == GFX_TEXTURE_2D_ARRAY), "Only a GFX_TEXTURE_2D_ARRAY can be updated per layer");
+  NIKOLA_ASSERT((layer < texture->desc.depth), "Texture layer out of bounds");
+
+  record_call(texture->gfx, GFX_CALL_TEXTURE_UPDATE_LAYER, texture->id, layer);
+}
+
+/// Texture functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Cubemap functions
+
+GfxCubemap* gfx_cubemap_create(GfxContext* gfx, const GfxCubemapDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxCubemap* cubemap = (GfxCubemap*)memory_allocate(sizeof(GfxCubemap));
+  memory_zero(cubemap, sizeof(GfxCubemap));
+
+  cubemap->gfx  = gfx;
+  cubemap->desc = desc;
+  cubemap->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_CUBEMAP_CREATE, cubemap->id, desc.width, desc.height);
+  return cubemap;
+}
+
+void gfx_cubemap_destroy(GfxCubemap* cubemap) {
+  if(!cubemap) {
+    return;
+  }
+
+  untrack_object(cubemap->gfx);
+  record_call(cubemap->gfx, GFX_CALL_CUBEMAP_DESTROY, cubemap->id);
+
+  memory_free(cubemap);
+}
+
+GfxCubemapDesc& gfx_cubemap_get_desc(GfxCubemap* cubemap) {
+  NIKOLA_ASSERT(cubemap, "Invalid GfxCubemap struct passed");
+
+  return cubemap->desc;
+}
+
+void gfx_cubemap_update(GfxCubemap* cubemap, const GfxCubemapDesc& desc) {
+  NIKOLA_ASSERT(cubemap, "Invalid GfxCubemap struct passed");
+
+  cubemap->desc = desc;
+  record_call(cubemap->gfx, GFX_CALL_CUBEMAP_UPDATE, cubemap->id, desc.width, desc.height);
+}
+
+/// Cubemap functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Sampler functions
+
+GfxSampler* gfx_sampler_create(GfxContext* gfx, const GfxSamplerDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  // @NOTE: No deduplication happens here, so every create shows up in the call log.
+  GfxSampler* sampler = (GfxSampler*)memory_allocate(sizeof(GfxSampler));
+  memory_zero(sampler, sizeof(GfxSampler));
+
+  sampler->gfx  = gfx;
+  sampler->desc = desc;
+  sampler->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_SAMPLER_CREATE, sampler->id, desc.filter, desc.wrap_mode);
+  return sampler;
+}
+
+void gfx_sampler_destroy(GfxSampler* sampler) {
+  if(!sampler) {
+    return;
+  }
+
+  untrack_object(sampler->gfx);
+  record_call(sampler->gfx, GFX_CALL_SAMPLER_DESTROY, sampler->id);
+
+  memory_free(sampler);
+}
+
+const GfxSamplerDesc& gfx_sampler_get_desc(GfxSampler* sampler) {
+  NIKOLA_ASSERT(sampler, "Invalid GfxSampler struct passed");
+
+  return sampler->desc;
+}
+
+/// Sampler functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Pipeline functions
+
+GfxPipeline* gfx_pipeline_create(GfxContext* gfx, const GfxPipelineDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(desc.vertex_buffer, "Invalid vertex buffer passed to the pipeline");
+
+  GfxPipeline* pipe = (GfxPipeline*)memory_allocate(sizeof(GfxPipeline));
+  memory_zero(pipe, sizeof(GfxPipeline));
+
+  pipe->desc = desc;
+  pipe->gfx  = gfx;
+  pipe->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_PIPELINE_CREATE, pipe->id, desc.layout_count, desc.instance_layout_count);
+  return pipe;
+}
+
+void gfx_pipeline_destroy(GfxPipeline* pipeline) {
+  if(!pipeline) {
+    return;
+  }
+
+  untrack_object(pipeline->gfx);
+  record_call(pipeline->gfx, GFX_CALL_PIPELINE_DESTROY, pipeline->id);
+
+  memory_free(pipeline);
+}
+
+GfxPipelineDesc& gfx_pipeline_get_desc(GfxPipeline* pipeline) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  return pipeline->desc;
+}
+
+void gfx_pipeline_draw_vertex(GfxPipeline* pipeline) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  record_call(pipeline->gfx, GFX_CALL_PIPELINE_DRAW_VERTEX, pipeline->id, pipeline->desc.vertices_count, 1);
+}
+
+void gfx_pipeline_draw_index(GfxPipeline* pipeline) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(pipeline->desc.index_buffer, "Cannot draw using an invalid index buffer");
+
+  record_call(pipeline->gfx, GFX_CALL_PIPELINE_DRAW_INDEX, pipeline->id, pipeline->desc.indices_count, 1);
+}
+
+void gfx_pipeline_draw_vertex_instanced(GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+
+  record_call(pipeline->gfx, GFX_CALL_PIPELINE_DRAW_VERTEX, pipeline->id, pipeline->desc.vertices_count, instance_count);
+}
+
+void gfx_pipeline_draw_index_instanced(GfxPipeline* pipeline, const sizei instance_count, const u32 base_instance) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(pipeline->desc.index_buffer, "Cannot draw using an invalid index buffer");
+
+  record_call(pipeline->gfx, GFX_CALL_PIPELINE_DRAW_INDEX, pipeline->id, pipeline->desc.indices_count, instance_count);
+}
+
+void gfx_pipeline_draw_indirect(GfxPipeline* pipeline, GfxBuffer* indirect_buffer, const sizei count) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxPipeline struct passed");
+  NIKOLA_ASSERT(indirect_buffer, "Invalid indirect buffer passed");
+  NIKOLA_ASSERT((indirect_buffer->desc.type == GFX_BUFFER_DRAW_INDIRECT), "The indirect buffer must be of type GFX_BUFFER_DRAW_INDIRECT");
+
+  record_call(pipeline->gfx, GFX_CALL_PIPELINE_DRAW_INDIRECT, pipeline->id, indirect_buffer->id, count);
+}
+
+/// Pipeline functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Compute pipeline functions
+
+GfxComputePipeline* gfx_compute_pipeline_create(GfxContext* gfx, const GfxComputePipelineDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(desc.shader, "Invalid shader passed to the compute pipeline");
+
+  GfxComputePipeline* pipe = (GfxComputePipeline*)memory_allocate(sizeof(GfxComputePipeline));
+  memory_zero(pipe, sizeof(GfxComputePipeline));
+
+  pipe->desc = desc;
+  pipe->gfx  = gfx;
+  pipe->id   = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_COMPUTE_CREATE, pipe->id, desc.storage_buffers_count, desc.images_count);
+  return pipe;
+}
+
+void gfx_compute_pipeline_destroy(GfxComputePipeline* pipeline) {
+  if(!pipeline) {
+    return;
+  }
+
+  untrack_object(pipeline->gfx);
+  record_call(pipeline->gfx, GFX_CALL_COMPUTE_DESTROY, pipeline->id);
+
+  memory_free(pipeline);
+}
+
+GfxComputePipelineDesc& gfx_compute_pipeline_get_desc(GfxComputePipeline* pipeline) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxComputePipeline struct passed");
+
+  return pipeline->desc;
+}
+
+void gfx_compute_dispatch(GfxComputePipeline* pipeline, const u32 groups_x, const u32 groups_y, const u32 groups_z) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxComputePipeline struct passed");
+
+  record_call(pipeline->gfx, GFX_CALL_COMPUTE_DISPATCH, pipeline->id, (u64)groups_x * groups_y * groups_z, groups_x);
+}
+
+void gfx_compute_dispatch_indirect(GfxComputePipeline* pipeline, GfxBuffer* indirect_buffer, const sizei offset) {
+  NIKOLA_ASSERT(pipeline, "Invalid GfxComputePipeline struct passed");
+  NIKOLA_ASSERT(indirect_buffer, "Invalid indirect buffer passed");
+  NIKOLA_ASSERT((indirect_buffer->desc.type == GFX_BUFFER_DISPATCH_INDIRECT), "The indirect buffer must be of type GFX_BUFFER_DISPATCH_INDIRECT");
+
+  record_call(pipeline->gfx, GFX_CALL_COMPUTE_DISPATCH_INDIRECT, pipeline->id, indirect_buffer->id, offset);
+}
+
+/// Compute pipeline functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Readback functions
+
+GfxReadback* gfx_readback_create(GfxContext* gfx) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  GfxReadback* readback = (GfxReadback*)memory_allocate(sizeof(GfxReadback));
+  memory_zero(readback, sizeof(GfxReadback));
+
+  readback->gfx = gfx;
+  readback->id  = track_object(gfx);
+
+  record_call(gfx, GFX_CALL_READBACK_CREATE, readback->id);
+  return readback;
+}
+
+void gfx_readback_destroy(GfxReadback* readback) {
+  if(!readback) {
+    return;
+  }
+
+  untrack_object(readback->gfx);
+  record_call(readback->gfx, GFX_CALL_READBACK_DESTROY, readback->id);
+
+  memory_free(readback);
+}
+
+const GfxReadbackDesc& gfx_readback_get_desc(GfxReadback* readback) {
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  return readback->desc;
+}
+
+const bool gfx_readback_is_pending(GfxReadback* readback) {
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  return readback->is_pending;
+}
+
+const bool gfx_readback_poll(GfxReadback* readback, void* data) {
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+  NIKOLA_ASSERT(data, "Invalid data passed to a readback poll");
+
+  if(!readback->is_pending) {
+    return false;
+  }
+
+  // There is no GPU to wait on, so every read is done right away (and blank)
+  memory_zero(data, readback->desc.size);
+  readback->is_pending = false;
+
+  return true;
+}
+
+void gfx_texture_read_async(GfxTexture* texture, GfxReadback* readback) {
+  NIKOLA_ASSERT(texture, "Invalid GfxTexture struct passed");
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  readback->desc.width  = texture->desc.width;
+  readback->desc.height = texture->desc.height;
+  readback->desc.format = texture->desc.format;
+  readback->desc.size   = get_readback_size(texture->desc.width, texture->desc.height, texture->desc.format);
+  readback->is_pending  = true;
+
+  record_call(texture->gfx, GFX_CALL_TEXTURE_READ_ASYNC, texture->id, readback->id, readback->desc.size);
+}
+
+void gfx_context_read_async(GfxContext* gfx, GfxReadback* readback) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  i32 width, height;
+  window_get_size(gfx->desc.window, &width, &height);
+
+  readback->desc.width  = width;
+  readback->desc.height = height;
+  readback->desc.format = gfx->desc.pixel_format;
+  readback->desc.size   = get_readback_size(width, height, gfx->desc.pixel_format);
+  readback->is_pending  = true;
+
+  record_call(gfx, GFX_CALL_CONTEXT_READ_ASYNC, 0, readback->id, readback->desc.size);
+}
+
+void gfx_buffer_read_async(GfxBuffer* buff, GfxReadback* readback) {
+  NIKOLA_ASSERT(buff, "Invalid GfxBuffer struct passed");
+  NIKOLA_ASSERT(readback, "Invalid GfxReadback struct passed");
+
+  readback->desc.width  = (u32)buff->desc.size;
+  readback->desc.height = 1;
+  readback->desc.format = GFX_TEXTURE_FORMAT_R8;
+  readback->desc.size   = buff->desc.size;
+  readback->is_pending  = true;
+
+  record_call(buff->gfx, GFX_CALL_BUFFER_READ_ASYNC, buff->id, readback->id, readback->desc.size);
+}
+
+/// Readback functions
+///---------------------------------------------------------------------------------------------------------------------
+
+/// *** Graphics ***
+/// ---------------------------------------------------------------------
+
+} // End of nikola
+
+#endif // Null check
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,56 @@
+#include "ring_buffer.hpp"
+
+#include "nikola/nikola_core.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Ring partitions functions
+
+void ring_partitions_init(RingPartitions& ring, const sizei size, const sizei alignment) {
+  NIKOLA_ASSERT(alignment > 0, "Cannot align ring partitions to zero");
+
+  // Every partition has to start at an aligned offset
+  ring.stride  = ((size + alignment - 1) / alignment) * alignment;
+  ring.current = 0;
+  ring.frame   = 0;
+
+  for(sizei i = 0; i < RING_BUFFER_FRAMES; i++) {
+    ring.frames[i] = 0;
+  }
+}
+
+const sizei ring_partitions_get_offset(const RingPartitions& ring) {
+  return ring.current * ring.stride;
+}
+
+const bool ring_partitions_advance(RingPartitions& ring, const sizei frame_index, sizei* wait_frame) {
+  // Only the first write of every frame moves on to the next partition
+  if(ring.frame == frame_index) {
+    return false;
+  }
+
+  // The old partition might have been read by this frame's commands up until now
+  ring.frames[ring.current] = frame_index;
+
+  ring.current = (ring.current + 1) % RING_BUFFER_FRAMES;
+  ring.frame   = frame_index;
+
+  // The GPU has to be done with the last frame that read the new partition before it gets written to
+  *wait_frame = ring.frames[ring.current];
+  return true;
+}
+
+const bool ring_frame_is_retired(const sizei frame, const sizei frame_index) {
+  // Anything older than the frames in flight is already done
+  return (frame + RING_BUFFER_FRAMES) <= frame_index;
+}
+
+/// Ring partitions functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
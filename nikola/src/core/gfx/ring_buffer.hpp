@@ -0,0 +1,35 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// RingPartitions
+struct RingPartitions {
+  /// The aligned size of a single partition.
+  sizei stride  = 0;
+
+  /// The partition being written to, as well as the frame it was picked in.
+  sizei current = 0;
+  sizei frame   = 0;
+
+  /// The last frame each partition could have been read in by the GPU.
+  sizei frames[RING_BUFFER_FRAMES] = {};
+};
+/// RingPartitions
+/// ----------------------------------------------------------------------
+
+void ring_partitions_init(RingPartitions& ring, const sizei size, const sizei alignment);
+
+const sizei ring_partitions_get_offset(const RingPartitions& ring);
+
+const bool ring_partitions_advance(RingPartitions& ring, const sizei frame_index, sizei* wait_frame);
+
+const bool ring_frame_is_retired(const sizei frame, const sizei frame_index);
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -222,9 +222,10 @@ const sizei file_tell_read(File& file) {
 const sizei file_get_size(File& file) {
   NIKOLA_ASSERT(file.is_open(), "Cannot perform an operation on an unopened file");
   
-  file_seek_read(file, std::ios::end);
+  // The seek directions have to be given relative to an offset, not as positions
+  file.seekg(0, std::ios::end);
   sizei size = file_tell_read(file);
-  file_seek_read(file, std::ios::beg);
+  file.seekg(0, std::ios::beg);
 
   return size;
 }
@@ -73,7 +73,7 @@ const Mat4 mat4_perspective(const f32 fov, const f32 aspect_ratio, const f32 nea
 }
 
 const Mat4 mat4_ortho(const f32 left, const f32 right, const f32 bottom, const f32 top) {
-  return glm::ortho(left, right, bottom, left);
+  return glm::ortho(left, right, bottom, top);
 }
 
 const Mat4 mat4_look_at(const Vec3& eye, const Vec3& center, const Vec3& up) {
@@ -0,0 +1,537 @@
+#include "batch_renderer.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Shaders
+
+#define BATCH_SAMPLE_CASE(index) \
+  "    case " #index ": return texture(u_textures[" #index "], coords);\n"
+
+static const i8* s_batch_vertex_source =
+  "#version 460 core\n"
+  "\n"
+  "// Layouts\n"
+  "layout (location = 0) in vec2 aPos;\n"
+  "layout (location = 1) in vec4 aColor;\n"
+  "layout (location = 2) in vec2 aTextureCoords;\n"
+  "layout (location = 3) in vec2 aParams;\n"
+  "\n"
+  "// Outputs\n"
+  "out VS_OUT {\n"
+  "  vec4 color;\n"
+  "  vec2 tex_coords;\n"
+  "  flat int texture_index;\n"
+  "  flat int shape;\n"
+  "} vs_out;\n"
+  "\n"
+  "// Uniforms\n"
+  "uniform mat4 u_projection;\n"
+  "\n"
+  "void main() {\n"
+  "  vs_out.color         = aColor;\n"
+  "  vs_out.tex_coords    = aTextureCoords;\n"
+  "  vs_out.texture_index = int(aParams.x + 0.5);\n"
+  "  vs_out.shape         = int(aParams.y + 0.5);\n"
+  "\n"
+  "  gl_Position = u_projection * vec4(aPos, 0.0, 1.0);\n"
+  "}\n";
+
+/// @NOTE: The textures are indexed through a `switch` since the index
+/// is not the same across a whole draw call.
+static const i8* s_batch_pixel_source =
+  "#version 460 core\n"
+  "\n"
+  "// Outputs\n"
+  "layout (location = 0) out vec4 frag_color;\n"
+  "\n"
+  "// Inputs\n"
+  "in VS_OUT {\n"
+  "  vec4 color;\n"
+  "  vec2 tex_coords;\n"
+  "  flat int texture_index;\n"
+  "  flat int shape;\n"
+  "} fs_in;\n"
+  "\n"
+  "// Uniforms\n"
+  "layout (binding = 0) uniform sampler2D u_textures[16];\n"
+  "\n"
+  "vec4 sample_texture(int index, vec2 coords) {\n"
+  "  switch(index) {\n"
+  BATCH_SAMPLE_CASE(0)  BATCH_SAMPLE_CASE(1)  BATCH_SAMPLE_CASE(2)  BATCH_SAMPLE_CASE(3)
+  BATCH_SAMPLE_CASE(4)  BATCH_SAMPLE_CASE(5)  BATCH_SAMPLE_CASE(6)  BATCH_SAMPLE_CASE(7)
+  BATCH_SAMPLE_CASE(8)  BATCH_SAMPLE_CASE(9)  BATCH_SAMPLE_CASE(10) BATCH_SAMPLE_CASE(11)
+  BATCH_SAMPLE_CASE(12) BATCH_SAMPLE_CASE(13) BATCH_SAMPLE_CASE(14) BATCH_SAMPLE_CASE(15)
+  "  }\n"
+  "\n"
+  "  return vec4(1.0);\n"
+  "}\n"
+  "\n"
+  "void main() {\n"
+  "  vec4 texel = sample_texture(fs_in.texture_index, fs_in.tex_coords);\n"
+  "  vec4 color = fs_in.color;\n"
+  "\n"
+  "  // Glyphs only keep their distance to the edge in the red channel, with the edge at 0.5\n"
+  "  if(fs_in.shape == 2) {\n"
+  "    float width = max(fwidth(texel.r), 0.0001);\n"
+  "    color.a    *= smoothstep(0.5 - width, 0.5 + width, texel.r);\n"
+  "  }\n"
+  "  else {\n"
+  "    color *= texel;\n"
+  "  }\n"
+  "\n"
+  "  // Circles are quads that fade out right at their edge\n"
+  "  if(fs_in.shape == 1) {\n"
+  "    float dist = length(fs_in.tex_coords * 2.0 - 1.0);\n"
+  "    color.a   *= 1.0 - smoothstep(1.0 - fwidth(dist), 1.0, dist);\n"
+  "  }\n"
+  "\n"
+  "  if(color.a <= 0.0) {\n"
+  "    discard;\n"
+  "  }\n"
+  "\n"
+  "  frag_color = color;\n"
+  "}\n";
+
+static_assert(BATCH_TEXTURES_MAX == 16, "The size of `u_textures` in the batch shader must match BATCH_TEXTURES_MAX");
+
+/// Shaders
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The shapes the pixel shader can tell apart.
+const f32 BATCH_SHAPE_QUAD   = 0.0f;
+const f32 BATCH_SHAPE_CIRCLE = 1.0f;
+const f32 BATCH_SHAPE_GLYPH  = 2.0f;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// BatchVertex
+struct BatchVertex {
+  Vec2 position;
+  Vec4 color;
+  Vec2 texture_coords;
+
+  /// x = texture slot, y = shape
+  Vec2 params;
+};
+/// BatchVertex
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// BatchPage
+
+/// A vertex buffer of `BATCH_QUADS_MAX` quads and the pipeline drawing from it.
+struct BatchPage {
+  GfxBuffer* vertex_buffer = nullptr;
+  GfxPipeline* pipe        = nullptr;
+};
+/// BatchPage
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// BatchRenderer
+struct BatchRenderer {
+  GfxContext* gfx              = nullptr;
+  GfxCommandList* command_list = nullptr;
+
+  GfxShader* shader        = nullptr;
+  i32 projection_location  = -1;
+
+  GfxBuffer* index_buffer   = nullptr;
+  GfxPipelineDesc pipe_desc = {};
+
+  /// Frames with more quads than one page can hold move on to the next page.
+  DynamicArray<BatchPage> pages;
+  sizei current_page = 0;
+
+  GfxTexture* white_texture = nullptr;
+  Mat4 projection;
+
+  /// The vertices of the current batch.
+  DynamicArray<BatchVertex> vertices;
+
+  /// The textures of the current batch, where the first is always the white texture.
+  GfxTexture* textures[BATCH_TEXTURES_MAX];
+  sizei textures_count = 0;
+
+  /// Each flush writes right after the last one in the same page and frame,
+  /// since the GPU might still be reading the earlier vertices.
+  sizei frame_vertices = 0;
+};
+
+static BatchRenderer s_batch;
+/// BatchRenderer
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void reset_batch() {
+  s_batch.vertices.clear();
+
+  s_batch.textures[0]    = s_batch.white_texture;
+  s_batch.textures_count = 1;
+}
+
+static f32 get_texture_slot(GfxTexture* texture) {
+  for(sizei i = 0; i < s_batch.textures_count; i++) {
+    if(s_batch.textures[i] == texture) {
+      return (f32)i;
+    }
+  }
+
+  // Out of slots, so the current batch has to go first
+  if(s_batch.textures_count == BATCH_TEXTURES_MAX) {
+    batch_renderer_flush();
+  }
+
+  s_batch.textures[s_batch.textures_count] = texture;
+  return (f32)s_batch.textures_count++;
+}
+
+static void push_batch_page() {
+  GfxBufferDesc vert_desc = {
+    .data  = nullptr,
+    .size  = sizeof(BatchVertex) * BATCH_QUADS_MAX * 4,
+    .type  = GFX_BUFFER_VERTEX,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+
+  BatchPage page;
+  page.vertex_buffer = gfx_buffer_create(s_batch.gfx, vert_desc);
+
+  s_batch.pipe_desc.vertex_buffer = page.vertex_buffer;
+  page.pipe                       = gfx_pipeline_create(s_batch.gfx, s_batch.pipe_desc);
+
+  s_batch.pages.push_back(page);
+}
+
+static BatchPage& acquire_batch_page(const sizei vertices_count) {
+  // The current page still has room left this frame
+  if((s_batch.frame_vertices + vertices_count) <= (BATCH_QUADS_MAX * 4)) {
+    return s_batch.pages[s_batch.current_page];
+  }
+
+  // Move on to the next page, and only create it if no earlier frame needed it yet
+  s_batch.current_page++;
+  s_batch.frame_vertices = 0;
+
+  if(s_batch.current_page == s_batch.pages.size()) {
+    push_batch_page();
+  }
+
+  return s_batch.pages[s_batch.current_page];
+}
+
+static void ensure_batch_capacity(const sizei quads_count) {
+  // The index buffer only covers `BATCH_QUADS_MAX` quads per draw call. 
+  // Flushing resets the texture slots, so this has to happen before any slot gets looked up.
+  if((s_batch.vertices.size() + (quads_count * 4)) > (BATCH_QUADS_MAX * 4)) {
+    batch_renderer_flush();
+  }
+}
+
+static void push_quad(const Vec2 corners[4], const Vec4& color, const Vec4& texture_rect, const f32 slot, const f32 shape) {
+  NIKOLA_ASSERT(((s_batch.vertices.size() + 4) <= (BATCH_QUADS_MAX * 4)), "The capacity of the batch must be ensured before pushing a quad");
+
+  // Top-left, top-right, bottom-right, bottom-left
+  Vec2 coords[4] = {
+    Vec2(texture_rect.x, texture_rect.y),
+    Vec2(texture_rect.x + texture_rect.z, texture_rect.y),
+    Vec2(texture_rect.x + texture_rect.z, texture_rect.y + texture_rect.w),
+    Vec2(texture_rect.x, texture_rect.y + texture_rect.w),
+  };
+
+  for(sizei i = 0; i < 4; i++) {
+    s_batch.vertices.push_back(BatchVertex{corners[i], color, coords[i], Vec2(slot, shape)});
+  }
+}
+
+static void push_rect(const Vec2& position, const Vec2& size, const Vec4& color, const Vec4& texture_rect, const f32 slot, const f32 shape) {
+  Vec2 corners[4] = {
+    position,
+    Vec2(position.x + size.x, position.y),
+    Vec2(position.x + size.x, position.y + size.y),
+    Vec2(position.x, position.y + size.y),
+  };
+
+  push_quad(corners, color, texture_rect, slot, shape);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Batch renderer private functions
+
+void batch_renderer_init(GfxContext* gfx) {
+  s_batch.gfx          = gfx;
+  s_batch.command_list = gfx_command_list_create(gfx);
+
+  GfxShaderDesc shader_desc = {
+    .vertex_source = s_batch_vertex_source,
+    .pixel_source  = s_batch_pixel_source,
+  };
+  s_batch.shader              = gfx_shader_create(gfx, shader_desc);
+  s_batch.projection_location = gfx_glsl_get_uniform_location(s_batch.shader, "u_projection");
+
+  // Every quad uses the same pattern of indices, so they never have to change
+  DynamicArray<u32> indices(BATCH_QUADS_MAX * 6);
+  for(sizei i = 0; i < BATCH_QUADS_MAX; i++) {
+    u32 vertex = (u32)(i * 4);
+
+    indices[(i * 6) + 0] = vertex + 0;
+    indices[(i * 6) + 1] = vertex + 1;
+    indices[(i * 6) + 2] = vertex + 2;
+    indices[(i * 6) + 3] = vertex + 2;
+    indices[(i * 6) + 4] = vertex + 3;
+    indices[(i * 6) + 5] = vertex + 0;
+  }
+
+  GfxBufferDesc index_desc = {
+    .data  = indices.data(),
+    .size  = sizeof(u32) * indices.size(),
+    .type  = GFX_BUFFER_INDEX,
+    .usage = GFX_BUFFER_USAGE_STATIC_DRAW,
+  };
+  s_batch.index_buffer = gfx_buffer_create(gfx, index_desc);
+
+  // Pipeline init
+  s_batch.pipe_desc.index_buffer  = s_batch.index_buffer;
+  s_batch.pipe_desc.shader        = s_batch.shader;
+
+  s_batch.pipe_desc.layout[0]    = {"POSITION", GFX_LAYOUT_FLOAT2, 0};
+  s_batch.pipe_desc.layout[1]    = {"COLOR", GFX_LAYOUT_FLOAT4, 0};
+  s_batch.pipe_desc.layout[2]    = {"TEX", GFX_LAYOUT_FLOAT2, 0};
+  s_batch.pipe_desc.layout[3]    = {"PARAMS", GFX_LAYOUT_FLOAT2, 0};
+  s_batch.pipe_desc.layout_count = 4;
+
+  s_batch.pipe_desc.draw_mode  = GFX_DRAW_MODE_TRIANGLE;
+  s_batch.pipe_desc.depth_mask = false;
+
+  // Most frames never need more than the first page
+  push_batch_page();
+
+  // Untextured shapes sample a white texture, so every shape can share a draw call.
+  // The texture takes ownership of its pixels, so they have to be allocated.
+  u32* white_pixel = (u32*)memory_allocate(sizeof(u32));
+  *white_pixel     = 0xffffffff;
+
+  GfxTextureDesc tex_desc = {};
+  tex_desc.width          = 1;
+  tex_desc.height         = 1;
+  tex_desc.mips           = 1;
+  tex_desc.type           = GFX_TEXTURE_2D;
+  tex_desc.format         = GFX_TEXTURE_FORMAT_RGBA8;
+  tex_desc.filter         = GFX_TEXTURE_FILTER_MIN_MAG_NEAREST;
+  tex_desc.wrap_mode      = GFX_TEXTURE_WRAP_CLAMP;
+  tex_desc.data           = white_pixel;
+  s_batch.white_texture   = gfx_texture_create(gfx, tex_desc);
+
+  s_batch.vertices.reserve(BATCH_QUADS_MAX * 4);
+  reset_batch();
+}
+
+void batch_renderer_shutdown() {
+  if(!s_batch.gfx) {
+    return;
+  }
+
+  gfx_texture_destroy(s_batch.white_texture);
+
+  for(auto& page : s_batch.pages) {
+    gfx_pipeline_destroy(page.pipe);
+    gfx_buffer_destroy(page.vertex_buffer);
+  }
+
+  gfx_buffer_destroy(s_batch.index_buffer);
+
+  gfx_shader_destroy(s_batch.shader);
+  gfx_command_list_destroy(s_batch.command_list);
+
+  s_batch = {};
+}
+
+void batch_renderer_next_frame() {
+  s_batch.current_page   = 0;
+  s_batch.frame_vertices = 0;
+}
+
+/// Batch renderer private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Batch renderer functions
+
+void batch_renderer_begin() {
+  i32 width, height;
+  window_get_size(gfx_context_get_desc(s_batch.gfx).window, &width, &height);
+
+  batch_renderer_begin(mat4_ortho(0.0f, (f32)width, (f32)height, 0.0f));
+}
+
+void batch_renderer_begin(const Mat4& view_projection) {
+  s_batch.projection = view_projection;
+  reset_batch();
+}
+
+void batch_renderer_flush() {
+  if(s_batch.vertices.empty()) {
+    reset_batch();
+    return;
+  }
+
+  // Append the batch right after anything else flushed this frame
+  BatchPage& page     = acquire_batch_page(s_batch.vertices.size());
+  sizei vertices_size = sizeof(BatchVertex) * s_batch.vertices.size();
+  gfx_buffer_update(page.vertex_buffer, sizeof(BatchVertex) * s_batch.frame_vertices, vertices_size, s_batch.vertices.data());
+
+  s_batch.pipe_desc.vertex_buffer   = page.vertex_buffer;
+  s_batch.pipe_desc.vertices_offset = s_batch.frame_vertices;
+  s_batch.pipe_desc.vertices_count  = s_batch.vertices.size();
+  s_batch.pipe_desc.indices_count   = (s_batch.vertices.size() / 4) * 6;
+
+  s_batch.pipe_desc.textures_count = s_batch.textures_count;
+  for(sizei i = 0; i < s_batch.textures_count; i++) {
+    s_batch.pipe_desc.textures[i] = s_batch.textures[i];
+  }
+
+  GfxCommandList* list = s_batch.command_list;
+  gfx_command_list_reset(list);
+  gfx_command_list_apply_pipeline(list, page.pipe, s_batch.pipe_desc);
+  gfx_command_list_upload_uniform(list, s_batch.shader, s_batch.projection_location, GFX_LAYOUT_MAT4, mat4_raw_data(s_batch.projection));
+  gfx_command_list_draw_index(list, page.pipe);
+
+  // 2D shapes are drawn over everything in order, blending with whatever is below them
+  u32 states = gfx_context_get_desc(s_batch.gfx).states;
+
+  gfx_context_set_state(s_batch.gfx, GFX_STATE_DEPTH, false);
+  gfx_context_set_state(s_batch.gfx, GFX_STATE_BLEND, true);
+
+  gfx_context_submit(s_batch.gfx, list);
+
+  gfx_context_set_state(s_batch.gfx, GFX_STATE_DEPTH, (states & GFX_STATE_DEPTH) != 0);
+  gfx_context_set_state(s_batch.gfx, GFX_STATE_BLEND, (states & GFX_STATE_BLEND) != 0);
+
+  s_batch.frame_vertices += s_batch.vertices.size();
+  reset_batch();
+}
+
+void batch_renderer_quad(const Vec2& position, const Vec2& size, const Vec4& color) {
+  ensure_batch_capacity(1);
+  push_rect(position, size, color, Vec4(0.0f, 0.0f, 1.0f, 1.0f), 0.0f, BATCH_SHAPE_QUAD);
+}
+
+void batch_renderer_textured_quad(const Vec2& position, const Vec2& size, GfxTexture* texture, const Vec4& tint, const Vec4& texture_rect) {
+  NIKOLA_ASSERT(texture, "Cannot batch a quad with an invalid texture");
+
+  ensure_batch_capacity(1);
+  f32 slot = get_texture_slot(texture);
+  push_rect(position, size, tint, texture_rect, slot, BATCH_SHAPE_QUAD);
+}
+
+void batch_renderer_rect(const Vec2& position, const Vec2& size, const f32 thickness, const Vec4& color) {
+  Vec4 full_rect = Vec4(0.0f, 0.0f, 1.0f, 1.0f);
+  ensure_batch_capacity(4);
+
+  // The edges are kept inside the rectangle, with the sides in between the top and bottom
+  push_rect(position, Vec2(size.x, thickness), color, full_rect, 0.0f, BATCH_SHAPE_QUAD);
+  push_rect(Vec2(position.x, position.y + size.y - thickness), Vec2(size.x, thickness), color, full_rect, 0.0f, BATCH_SHAPE_QUAD);
+
+  push_rect(Vec2(position.x, position.y + thickness), Vec2(thickness, size.y - (thickness * 2.0f)), color, full_rect, 0.0f, BATCH_SHAPE_QUAD);
+  push_rect(Vec2(position.x + size.x - thickness, position.y + thickness), Vec2(thickness, size.y - (thickness * 2.0f)), color, full_rect, 0.0f, BATCH_SHAPE_QUAD);
+}
+
+void batch_renderer_circle(const Vec2& center, const f32 radius, const Vec4& color) {
+  ensure_batch_capacity(1);
+  push_rect(Vec2(center.x - radius, center.y - radius), Vec2(radius * 2.0f), color, Vec4(0.0f, 0.0f, 1.0f, 1.0f), 0.0f, BATCH_SHAPE_CIRCLE);
+}
+
+void batch_renderer_line(const Vec2& start, const Vec2& end, const f32 thickness, const Vec4& color) {
+  f32 dir_x  = end.x - start.x;
+  f32 dir_y  = end.y - start.y;
+  f32 length = sqrtf((dir_x * dir_x) + (dir_y * dir_y));
+
+  if(length <= 0.0f) {
+    return;
+  }
+
+  // Extend the line out to both sides by half of its thickness
+  f32 half_thickness = thickness * 0.5f;
+  Vec2 normal        = Vec2((-dir_y / length) * half_thickness, (dir_x / length) * half_thickness);
+
+  Vec2 corners[4] = {
+    Vec2(start.x + normal.x, start.y + normal.y),
+    Vec2(end.x + normal.x, end.y + normal.y),
+    Vec2(end.x - normal.x, end.y - normal.y),
+    Vec2(start.x - normal.x, start.y - normal.y),
+  };
+
+  ensure_batch_capacity(1);
+  push_quad(corners, color, Vec4(0.0f, 0.0f, 1.0f, 1.0f), 0.0f, BATCH_SHAPE_QUAD);
+}
+
+void batch_renderer_text(const Font* font, const String& text, const Vec2& position, const f32 size, const Vec4& color) {
+  NIKOLA_ASSERT(font, "Cannot batch text with an invalid font");
+
+  f32 scale       = size / font->base_size;
+  f32 line_height = (font->ascent - font->descent + font->line_gap) * scale;
+
+  // The pen starts on the baseline of the first line
+  Vec2 pen     = Vec2(position.x, position.y + (font->ascent * scale));
+  i32 previous = 0;
+
+  for(auto& ch : text) {
+    i32 codepoint = (u8)ch;
+
+    if(codepoint == '\n') {
+      pen.x    = position.x;
+      pen.y   += line_height;
+      previous = 0;
+      continue;
+    }
+
+    // Only the printable ASCII range gets baked, so anything else (like the 
+    // bytes of a UTF-8 sequence) is dropped rather than drawn as a `?` each
+    if(!font_has_glyph(font, codepoint)) {
+      continue;
+    }
+
+    const Font::Glyph& glyph = font_get_glyph(font, codepoint);
+    pen.x                   += font_get_kerning(font, previous, codepoint) * scale;
+    previous                 = codepoint;
+
+    // Whitespace only moves the pen
+    if(glyph.size.x > 0.0f) {
+      Vec2 glyph_pos  = Vec2(pen.x + (glyph.offset.x * scale), pen.y + (glyph.offset.y * scale));
+      Vec2 glyph_size = Vec2(glyph.size.x * scale, glyph.size.y * scale);
+
+      // Long text can flush the batch halfway through, which resets the slots 
+      ensure_batch_capacity(1);
+      f32 slot = get_texture_slot(font->atlas);
+
+      push_rect(glyph_pos, glyph_size, color, glyph.texture_rect, slot, BATCH_SHAPE_GLYPH);
+    }
+
+    pen.x += glyph.advance_x * scale;
+  }
+}
+
+/// Batch renderer functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+void batch_renderer_init(GfxContext* gfx);
+
+void batch_renderer_shutdown();
+
+void batch_renderer_next_frame();
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,416 @@
+#include "clustered_lights.hpp"
+#include "worker_pool.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define NIKOLA_CLUSTER_SSE 1
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The amount of clusters along each axis of the grid.
+/// The screen is split into tiles along X and Y, and the view depth into exponential slices along Z.
+const u32 CLUSTERS_X           = 16;
+const u32 CLUSTERS_Y           = 9;
+const u32 CLUSTERS_Z           = 24;
+const sizei CLUSTERS_COUNT     = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+/// Any more lights touching a single cluster than this get dropped.
+const sizei CLUSTER_LIGHTS_MAX = 128;
+
+/// The size of the light index list shared by all of the clusters.
+/// Any indices past it are dropped, with a warning the first time it happens.
+const sizei CLUSTER_INDICES_MAX = CLUSTERS_COUNT * 32;
+
+/// The amount of lights tested at once by the kernel.
+const sizei CLUSTER_LANES       = 4;
+
+/// Anything less than this many lights is not worth waking up a worker.
+const sizei CLUSTER_THREAD_MIN  = 64;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// SliceLights
+struct SliceLights {
+  /// The view-space spheres of the lights touching a single depth slice, in SoA form.
+  DynamicArray<f32> center_x, center_y, center_z;
+  DynamicArray<f32> radius_sq;
+
+  DynamicArray<u32> indices;
+};
+/// SliceLights
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// ClusteredLights
+struct ClusteredLights {
+  GfxContext* gfx = nullptr;
+
+  GfxBuffer* clusters_buffer = nullptr;
+  GfxBuffer* indices_buffer  = nullptr;
+
+  /// The view-space bounds of every cluster, only rebuilt when the projection changes.
+  DynamicArray<f32> min_x, min_y, min_z;
+  DynamicArray<f32> max_x, max_y, max_z;
+  Mat4 projection;
+  bool has_bounds = false;
+
+  /// The view depth at the start of every slice, plus the end of the last one.
+  f32 slice_depths[CLUSTERS_Z + 1];
+
+  /// The view-space spheres of the lights in the current frame.
+  DynamicArray<f32> light_x, light_y, light_z, light_radius;
+  u32 index_offset = 0;
+
+  /// Every cluster gets its own fixed range of slots, so the threads never share any writes.
+  DynamicArray<u32> slots;
+  DynamicArray<u32> slots_count;
+
+  /// The compacted offset and count of every cluster followed by their light indices.
+  DynamicArray<u32> clusters;
+  DynamicArray<u32> indices;
+  bool has_overflowed = false;
+
+  Vec4 scale;
+};
+
+static ClusteredLights s_clusters;
+/// ClusteredLights
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static Vec3 tile_point(const Mat4& inverse_projection, const f32 ndc_x, const f32 ndc_y, const f32 depth) {
+  // Any point on the ray of the tile corner, scaled out to the given view depth
+  Vec4 point = inverse_projection * Vec4(ndc_x, ndc_y, -1.0f, 1.0f);
+  Vec3 ray   = Vec3(point.x, point.y, point.z) / point.w;
+
+  return ray * (depth / -ray.z);
+}
+
+static void build_cluster_bounds(const Camera& cam) {
+  Mat4 inverse_projection = mat4_inverse(cam.projection);
+
+  for(sizei z = 0; z <= CLUSTERS_Z; z++) {
+    s_clusters.slice_depths[z] = cam.near * powf(cam.far / cam.near, (f32)z / (f32)CLUSTERS_Z);
+  }
+
+  for(u32 z = 0; z < CLUSTERS_Z; z++) {
+    for(u32 y = 0; y < CLUSTERS_Y; y++) {
+      for(u32 x = 0; x < CLUSTERS_X; x++) {
+        f32 ndc_min_x = -1.0f + ((2.0f * x) / CLUSTERS_X);
+        f32 ndc_min_y = -1.0f + ((2.0f * y) / CLUSTERS_Y);
+        f32 ndc_max_x = -1.0f + ((2.0f * (x + 1)) / CLUSTERS_X);
+        f32 ndc_max_y = -1.0f + ((2.0f * (y + 1)) / CLUSTERS_Y);
+
+        // The bounds have to enclose the corners of the tile at both ends of the slice
+        Vec3 corners[8];
+        for(sizei i = 0; i < 2; i++) {
+          f32 depth = s_clusters.slice_depths[z + i];
+
+          corners[(i * 4) + 0] = tile_point(inverse_projection, ndc_min_x, ndc_min_y, depth);
+          corners[(i * 4) + 1] = tile_point(inverse_projection, ndc_max_x, ndc_min_y, depth);
+          corners[(i * 4) + 2] = tile_point(inverse_projection, ndc_min_x, ndc_max_y, depth);
+          corners[(i * 4) + 3] = tile_point(inverse_projection, ndc_max_x, ndc_max_y, depth);
+        }
+
+        Vec3 min = corners[0];
+        Vec3 max = corners[0];
+        for(sizei i = 1; i < 8; i++) {
+          min = Vec3(fminf(min.x, corners[i].x), fminf(min.y, corners[i].y), fminf(min.z, corners[i].z));
+          max = Vec3(fmaxf(max.x, corners[i].x), fmaxf(max.y, corners[i].y), fmaxf(max.z, corners[i].z));
+        }
+
+        sizei cluster = x + (y * CLUSTERS_X) + (z * CLUSTERS_X * CLUSTERS_Y);
+
+        s_clusters.min_x[cluster] = min.x;
+        s_clusters.min_y[cluster] = min.y;
+        s_clusters.min_z[cluster] = min.z;
+
+        s_clusters.max_x[cluster] = max.x;
+        s_clusters.max_y[cluster] = max.y;
+        s_clusters.max_z[cluster] = max.z;
+      }
+    }
+  }
+
+  s_clusters.projection = cam.projection;
+  s_clusters.has_bounds = true;
+}
+
+static void gather_slice_lights(const sizei slice, SliceLights& slice_lights) {
+  slice_lights.center_x.clear();
+  slice_lights.center_y.clear();
+  slice_lights.center_z.clear();
+  slice_lights.radius_sq.clear();
+  slice_lights.indices.clear();
+
+  f32 slice_near = s_clusters.slice_depths[slice];
+  f32 slice_far  = s_clusters.slice_depths[slice + 1];
+
+  // Most lights can be thrown away for a whole slice by their depth alone
+  for(sizei i = 0; i < s_clusters.light_x.size(); i++) {
+    f32 depth  = -s_clusters.light_z[i];
+    f32 radius = s_clusters.light_radius[i];
+
+    if((depth + radius) < slice_near || (depth - radius) > slice_far) {
+      continue;
+    }
+
+    slice_lights.center_x.push_back(s_clusters.light_x[i]);
+    slice_lights.center_y.push_back(s_clusters.light_y[i]);
+    slice_lights.center_z.push_back(s_clusters.light_z[i]);
+    slice_lights.radius_sq.push_back(radius * radius);
+    slice_lights.indices.push_back(s_clusters.index_offset + (u32)i);
+  }
+
+  // Pad to a whole amount of lanes with spheres that can never touch anything
+  while((slice_lights.indices.size() % CLUSTER_LANES) != 0) {
+    slice_lights.center_x.push_back(0.0f);
+    slice_lights.center_y.push_back(0.0f);
+    slice_lights.center_z.push_back(0.0f);
+    slice_lights.radius_sq.push_back(-1.0f);
+    slice_lights.indices.push_back(0);
+  }
+}
+
+#if NIKOLA_CLUSTER_SSE
+
+static void cull_cluster(const sizei cluster, const SliceLights& slice_lights) {
+  u32* slots = &s_clusters.slots[cluster * CLUSTER_LIGHTS_MAX];
+  u32 count  = 0;
+
+  __m128 zero  = _mm_setzero_ps();
+  __m128 min_x = _mm_set1_ps(s_clusters.min_x[cluster]);
+  __m128 min_y = _mm_set1_ps(s_clusters.min_y[cluster]);
+  __m128 min_z = _mm_set1_ps(s_clusters.min_z[cluster]);
+  __m128 max_x = _mm_set1_ps(s_clusters.max_x[cluster]);
+  __m128 max_y = _mm_set1_ps(s_clusters.max_y[cluster]);
+  __m128 max_z = _mm_set1_ps(s_clusters.max_z[cluster]);
+
+  for(sizei i = 0; i < slice_lights.indices.size(); i += CLUSTER_LANES) {
+    __m128 center_x = _mm_loadu_ps(&slice_lights.center_x[i]);
+    __m128 center_y = _mm_loadu_ps(&slice_lights.center_y[i]);
+    __m128 center_z = _mm_loadu_ps(&slice_lights.center_z[i]);
+
+    // The distance from each center to the closest point of the box along every axis
+    __m128 dist_x = _mm_max_ps(_mm_max_ps(_mm_sub_ps(min_x, center_x), _mm_sub_ps(center_x, max_x)), zero);
+    __m128 dist_y = _mm_max_ps(_mm_max_ps(_mm_sub_ps(min_y, center_y), _mm_sub_ps(center_y, max_y)), zero);
+    __m128 dist_z = _mm_max_ps(_mm_max_ps(_mm_sub_ps(min_z, center_z), _mm_sub_ps(center_z, max_z)), zero);
+
+    __m128 dist_sq = _mm_mul_ps(dist_x, dist_x);
+    dist_sq        = _mm_add_ps(dist_sq, _mm_mul_ps(dist_y, dist_y));
+    dist_sq        = _mm_add_ps(dist_sq, _mm_mul_ps(dist_z, dist_z));
+
+    i32 mask = _mm_movemask_ps(_mm_cmple_ps(dist_sq, _mm_loadu_ps(&slice_lights.radius_sq[i])));
+    for(sizei lane = 0; lane < CLUSTER_LANES && mask != 0; lane++) {
+      if(((mask >> lane) & 1) && count < CLUSTER_LIGHTS_MAX) {
+        slots[count++] = slice_lights.indices[i + lane];
+      }
+    }
+  }
+
+  s_clusters.slots_count[cluster] = count;
+}
+
+#else
+
+static void cull_cluster(const sizei cluster, const SliceLights& slice_lights) {
+  u32* slots = &s_clusters.slots[cluster * CLUSTER_LIGHTS_MAX];
+  u32 count  = 0;
+
+  for(sizei i = 0; i < slice_lights.indices.size() && count < CLUSTER_LIGHTS_MAX; i++) {
+    f32 dist_x = fmaxf(fmaxf(s_clusters.min_x[cluster] - slice_lights.center_x[i], slice_lights.center_x[i] - s_clusters.max_x[cluster]), 0.0f);
+    f32 dist_y = fmaxf(fmaxf(s_clusters.min_y[cluster] - slice_lights.center_y[i], slice_lights.center_y[i] - s_clusters.max_y[cluster]), 0.0f);
+    f32 dist_z = fmaxf(fmaxf(s_clusters.min_z[cluster] - slice_lights.center_z[i], slice_lights.center_z[i] - s_clusters.max_z[cluster]), 0.0f);
+
+    f32 dist_sq = (dist_x * dist_x) + (dist_y * dist_y) + (dist_z * dist_z);
+    if(dist_sq <= slice_lights.radius_sq[i]) {
+      slots[count++] = slice_lights.indices[i];
+    }
+  }
+
+  s_clusters.slots_count[cluster] = count;
+}
+
+#endif
+
+static void cull_slices(void* user_data, const sizei first, const sizei last) {
+  SliceLights slice_lights;
+  sizei slice_size = CLUSTERS_X * CLUSTERS_Y;
+
+  for(sizei z = first; z < last; z++) {
+    gather_slice_lights(z, slice_lights);
+
+    for(sizei i = 0; i < slice_size; i++) {
+      cull_cluster((z * slice_size) + i, slice_lights);
+    }
+  }
+}
+
+static void compact_clusters() {
+  u32 offset          = 0;
+  sizei dropped_count = 0;
+
+  for(sizei i = 0; i < CLUSTERS_COUNT; i++) {
+    u32 count = s_clusters.slots_count[i];
+
+    // Whatever does not fit into the index list anymore gets dropped
+    if((offset + count) > CLUSTER_INDICES_MAX) {
+      dropped_count += (offset + count) - CLUSTER_INDICES_MAX;
+      count          = (u32)CLUSTER_INDICES_MAX - offset;
+    }
+
+    s_clusters.clusters[(i * 2) + 0] = offset;
+    s_clusters.clusters[(i * 2) + 1] = count;
+
+    if(count > 0) {
+      memory_copy(&s_clusters.indices[offset], &s_clusters.slots[i * CLUSTER_LIGHTS_MAX], sizeof(u32) * count);
+    }
+
+    offset += count;
+  }
+
+  // Only complain once, since the same scene would keep on overflowing every frame 
+  if(dropped_count > 0 && !s_clusters.has_overflowed) {
+    NIKOLA_LOG_WARN("The light index list of the clusters overflowed by %zu indices. Some lights will not be shaded", dropped_count);
+    s_clusters.has_overflowed = true;
+  }
+
+  gfx_buffer_update(s_clusters.clusters_buffer, 0, sizeof(u32) * s_clusters.clusters.size(), s_clusters.clusters.data());
+
+  // Ring buffers have to be written every frame, even when there is nothing in them
+  sizei indices_size = sizeof(u32) * (offset > 0 ? offset : 1);
+  gfx_buffer_update(s_clusters.indices_buffer, 0, indices_size, s_clusters.indices.data());
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Clustered lights functions
+
+void clustered_lights_init(GfxContext* gfx) {
+  s_clusters.gfx = gfx;
+
+  s_clusters.min_x.resize(CLUSTERS_COUNT);
+  s_clusters.min_y.resize(CLUSTERS_COUNT);
+  s_clusters.min_z.resize(CLUSTERS_COUNT);
+
+  s_clusters.max_x.resize(CLUSTERS_COUNT);
+  s_clusters.max_y.resize(CLUSTERS_COUNT);
+  s_clusters.max_z.resize(CLUSTERS_COUNT);
+
+  s_clusters.slots.resize(CLUSTERS_COUNT * CLUSTER_LIGHTS_MAX);
+  s_clusters.slots_count.resize(CLUSTERS_COUNT);
+
+  s_clusters.clusters.resize(CLUSTERS_COUNT * 2);
+  s_clusters.indices.resize(CLUSTER_INDICES_MAX);
+
+  GfxBufferDesc clusters_desc = {
+    .data  = nullptr,
+    .size  = sizeof(u32) * s_clusters.clusters.size(),
+    .type  = GFX_BUFFER_SHADER_STORAGE,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+  s_clusters.clusters_buffer = gfx_buffer_create(gfx, clusters_desc);
+
+  GfxBufferDesc indices_desc = {
+    .data  = nullptr,
+    .size  = sizeof(u32) * s_clusters.indices.size(),
+    .type  = GFX_BUFFER_SHADER_STORAGE,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+  s_clusters.indices_buffer = gfx_buffer_create(gfx, indices_desc);
+}
+
+void clustered_lights_shutdown() {
+  if(!s_clusters.gfx) {
+    return;
+  }
+
+  gfx_buffer_destroy(s_clusters.indices_buffer);
+  gfx_buffer_destroy(s_clusters.clusters_buffer);
+
+  s_clusters = {};
+}
+
+void clustered_lights_build(const Camera& cam, const IVec2& viewport, const Light* lights, const sizei lights_count, const u32 index_offset, const u32 threads_count) {
+  // The bounds only depend on the projection, so they can be kept around otherwise
+  if(!s_clusters.has_bounds || s_clusters.projection != cam.projection) {
+    build_cluster_bounds(cam);
+  }
+
+  // Mapping pixels and view depths to clusters
+  f32 log_range    = logf(cam.far / cam.near);
+  s_clusters.scale = Vec4((f32)CLUSTERS_X / (f32)viewport.x,
+                          (f32)CLUSTERS_Y / (f32)viewport.y,
+                          (f32)CLUSTERS_Z / log_range,
+                          -((f32)CLUSTERS_Z * logf(cam.near)) / log_range);
+
+  // Every light is tested in view space as a sphere.
+  // Spot lights are bounded by the whole sphere of their radius.
+  s_clusters.light_x.resize(lights_count);
+  s_clusters.light_y.resize(lights_count);
+  s_clusters.light_z.resize(lights_count);
+  s_clusters.light_radius.resize(lights_count);
+  s_clusters.index_offset = index_offset;
+
+  for(sizei i = 0; i < lights_count; i++) {
+    Vec4 view_pos = cam.view * Vec4(lights[i].position, 1.0f);
+
+    s_clusters.light_x[i]      = view_pos.x;
+    s_clusters.light_y[i]      = view_pos.y;
+    s_clusters.light_z[i]      = view_pos.z;
+    s_clusters.light_radius[i] = lights[i].radius;
+  }
+
+  // Each worker gets its own slices, but only if there are enough lights to make it worth it
+  u32 threads = lights_count >= CLUSTER_THREAD_MIN ? threads_count : 1;
+  worker_pool_dispatch(cull_slices, nullptr, CLUSTERS_Z, 1, threads);
+
+  compact_clusters();
+}
+
+void clustered_lights_bind(GfxCommandList* list) {
+  gfx_command_list_bind_range(list, s_clusters.clusters_buffer, MATERIAL_CLUSTERS_BUFFER_INDEX, 0, sizeof(u32) * s_clusters.clusters.size());
+  gfx_command_list_bind_range(list, s_clusters.indices_buffer, MATERIAL_LIGHT_INDICES_BUFFER_INDEX, 0, sizeof(u32) * s_clusters.indices.size());
+}
+
+const IVec4 clustered_lights_get_grid() {
+  return IVec4(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z, 0);
+}
+
+const Vec4 clustered_lights_get_scale() {
+  return s_clusters.scale;
+}
+
+const u32* clustered_lights_get_cluster(const IVec3& cell, u32* count) {
+  NIKOLA_ASSERT(((cell.x >= 0 && cell.x < CLUSTERS_X) && (cell.y >= 0 && cell.y < CLUSTERS_Y) && (cell.z >= 0 && cell.z < CLUSTERS_Z)), 
+                "Cluster cell out of the bounds of the grid");
+
+  sizei cluster = cell.x + (cell.y * CLUSTERS_X) + (cell.z * CLUSTERS_X * CLUSTERS_Y);
+  *count        = s_clusters.clusters[(cluster * 2) + 1];
+
+  return &s_clusters.indices[s_clusters.clusters[(cluster * 2) + 0]];
+}
+
+/// Clustered lights functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+void clustered_lights_init(GfxContext* gfx);
+
+void clustered_lights_shutdown();
+
+void clustered_lights_build(const Camera& cam, const IVec2& viewport, const Light* lights, const sizei lights_count, const u32 index_offset, const u32 threads_count);
+
+void clustered_lights_bind(GfxCommandList* list);
+
+const IVec4 clustered_lights_get_grid();
+
+const Vec4 clustered_lights_get_scale();
+
+const u32* clustered_lights_get_cluster(const IVec3& cell, u32* count);
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
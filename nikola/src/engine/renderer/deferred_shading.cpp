@@ -0,0 +1,446 @@
+#include "deferred_shading.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Shaders
+
+/// @NOTE: Only the head of the `Lighting` block is declared here, which
+/// is enough since std140 blocks are laid out the same way regardless.
+#define GBUFFER_VERTEX_SOURCE(tex_location, instance_location)                     \
+  "#version 460 core\n"                                                             \
+  "\n"                                                                              \
+  "// Layouts\n"                                                                    \
+  "layout (location = 0) in vec3 aPos;\n"                                           \
+  "layout (location = 1) in vec3 aNormal;\n"                                        \
+  "layout (location = " #tex_location ") in vec2 aTextureCoords;\n"                 \
+  "layout (location = " #instance_location ") in mat4 aInstanceModel;\n"            \
+  "\n"                                                                              \
+  "// Outputs\n"                                                                    \
+  "out VS_OUT {\n"                                                                  \
+  "  vec2 tex_coords;\n"                                                            \
+  "  vec3 normal;\n"                                                                \
+  "  float depth;\n"                                                                \
+  "} vs_out;\n"                                                                     \
+  "\n"                                                                              \
+  "layout (std140, binding = 0) uniform Matrices {\n"                               \
+  "  mat4 u_view;\n"                                                                \
+  "  mat4 u_projection;\n"                                                          \
+  "};\n"                                                                            \
+  "\n"                                                                              \
+  "layout (std140, binding = 1) uniform Lighting {\n"                               \
+  "  mat4 u_inverse_view_projection;\n"                                             \
+  "  vec4 u_camera_position;\n"                                                     \
+  "  vec4 u_camera_front;\n"                                                        \
+  "};\n"                                                                            \
+  "\n"                                                                              \
+  "void main() {\n"                                                                 \
+  "  vec4 view_pos = u_view * aInstanceModel * vec4(aPos, 1.0);\n"                  \
+  "\n"                                                                              \
+  "  vs_out.tex_coords = aTextureCoords;\n"                                         \
+  "  vs_out.normal     = transpose(inverse(mat3(aInstanceModel))) * aNormal;\n"     \
+  "  vs_out.depth      = (-view_pos.z - u_camera_position.w) / (u_camera_front.w - u_camera_position.w);\n" \
+  "\n"                                                                              \
+  "  gl_Position = u_projection * view_pos;\n"                                      \
+  "}\n"
+
+#define GBUFFER_PIXEL_SOURCE(sampler_type, sample_coords)                          \
+  "#version 460 core\n"                                                             \
+  "\n"                                                                              \
+  "// Outputs\n"                                                                    \
+  "layout (location = 0) out vec4 g_albedo;\n"                                      \
+  "layout (location = 1) out vec4 g_normal;\n"                                      \
+  "layout (location = 2) out vec4 g_material;\n"                                    \
+  "\n"                                                                              \
+  "// Inputs\n"                                                                     \
+  "in VS_OUT {\n"                                                                   \
+  "  vec2 tex_coords;\n"                                                            \
+  "  vec3 normal;\n"                                                                \
+  "  float depth;\n"                                                                \
+  "} fs_in;\n"                                                                      \
+  "\n"                                                                              \
+  "layout (std140, binding = 2) uniform DrawData {\n"                               \
+  "  mat4 u_model;\n"                                                               \
+  "  vec4 u_ambient_color;\n"                                                       \
+  "  vec4 u_diffuse_color;\n"                                                       \
+  "  vec4 u_specular_color;\n"                                                      \
+  "};\n"                                                                            \
+  "\n"                                                                              \
+  "// Uniforms\n"                                                                   \
+  "layout (binding = 0) uniform " sampler_type " u_texture;\n"                      \
+  "uniform int u_diffuse_layer;\n"                                                  \
+  "\n"                                                                              \
+  "void main() {\n"                                                                 \
+  "  g_albedo   = texture(u_texture, " sample_coords ") * u_diffuse_color;\n"       \
+  "  g_normal   = vec4(normalize(fs_in.normal) * 0.5 + 0.5, fs_in.depth);\n"        \
+  "  g_material = vec4(u_specular_color.rgb, 1.0);\n"                               \
+  "}\n"
+
+static const i8* s_screen_vertex_source =
+  "#version 460 core\n"
+  "\n"
+  "// Layouts\n"
+  "layout (location = 0) in vec2 aPos;\n"
+  "\n"
+  "// Outputs\n"
+  "out VS_OUT {\n"
+  "  vec2 tex_coords;\n"
+  "} vs_out;\n"
+  "\n"
+  "void main() {\n"
+  "  vs_out.tex_coords = aPos * 0.5 + 0.5;\n"
+  "  gl_Position       = vec4(aPos, 0.0, 1.0);\n"
+  "}\n";
+
+static const i8* s_lighting_pixel_source =
+  "#version 460 core\n"
+  "\n"
+  "// Outputs\n"
+  "layout (location = 0) out vec4 frag_color;\n"
+  "\n"
+  "// Inputs\n"
+  "in VS_OUT {\n"
+  "  vec2 tex_coords;\n"
+  "} fs_in;\n"
+  "\n"
+  "struct Light {\n"
+  "  vec4 position_radius;\n"
+  "  vec4 direction_type;\n"
+  "  vec4 color_intensity;\n"
+  "  vec4 cone;\n"
+  "};\n"
+  "\n"
+  "layout (std140, binding = 1) uniform Lighting {\n"
+  "  mat4 u_inverse_view_projection;\n"
+  "  vec4 u_camera_position;\n"
+  "  vec4 u_camera_front;\n"
+  "  vec4 u_ambient_light;\n"
+  "  ivec4 u_lights_count;\n"
+  "  ivec4 u_cluster_grid;\n"
+  "  vec4 u_cluster_scale;\n"
+  "};\n"
+  "\n"
+  "layout (std430, binding = 0) readonly buffer Lights {\n"
+  "  Light u_lights[];\n"
+  "};\n"
+  "\n"
+  "layout (std430, binding = 1) readonly buffer Clusters {\n"
+  "  uvec2 u_clusters[];\n"
+  "};\n"
+  "\n"
+  "layout (std430, binding = 2) readonly buffer LightIndices {\n"
+  "  uint u_light_indices[];\n"
+  "};\n"
+  "\n"
+  "// Uniforms\n"
+  "layout (binding = 0) uniform sampler2D u_albedo;\n"
+  "layout (binding = 1) uniform sampler2D u_normal;\n"
+  "layout (binding = 2) uniform sampler2D u_material;\n"
+  "\n"
+  "vec3 shade_light(Light light, vec3 position, vec3 normal, vec3 view_dir, vec3 albedo, vec3 specular) {\n"
+  "  vec3 light_dir   = -light.direction_type.xyz;\n"
+  "  float falloff    = 1.0;\n"
+  "\n"
+  "  // Anything but directional lights fades out over its radius\n"
+  "  if(light.direction_type.w < 2.0) {\n"
+  "    vec3 to_light = light.position_radius.xyz - position;\n"
+  "    float dist    = length(to_light);\n"
+  "    float radius  = light.position_radius.w;\n"
+  "\n"
+  "    if(dist >= radius) {\n"
+  "      return vec3(0.0);\n"
+  "    }\n"
+  "\n"
+  "    light_dir = to_light / dist;\n"
+  "    falloff   = (1.0 - dist / radius) * (1.0 - dist / radius);\n"
+  "  }\n"
+  "\n"
+  "  // Spot lights fade out between their inner and outer cones\n"
+  "  if(light.direction_type.w == 1.0) {\n"
+  "    float theta = dot(-light_dir, light.direction_type.xyz);\n"
+  "    falloff    *= clamp((theta - light.cone.y) / max(light.cone.x - light.cone.y, 0.0001), 0.0, 1.0);\n"
+  "  }\n"
+  "\n"
+  "  vec3 halfway   = normalize(light_dir + view_dir);\n"
+  "  vec3 radiance  = light.color_intensity.rgb * light.color_intensity.w * falloff;\n"
+  "\n"
+  "  float diff = max(dot(normal, light_dir), 0.0);\n"
+  "  float spec = pow(max(dot(normal, halfway), 0.0), 32.0);\n"
+  "\n"
+  "  return ((albedo * diff) + (specular * spec)) * radiance;\n"
+  "}\n"
+  "\n"
+  "void main() {\n"
+  "  vec4 normal_depth = texture(u_normal, fs_in.tex_coords);\n"
+  "\n"
+  "  // Nothing was drawn here\n"
+  "  if(normal_depth.w >= 1.0) {\n"
+  "    discard;\n"
+  "  }\n"
+  "\n"
+  "  // Walk along the ray of the pixel until the stored view depth\n"
+  "  vec4 far_point   = u_inverse_view_projection * vec4(fs_in.tex_coords * 2.0 - 1.0, 1.0, 1.0);\n"
+  "  vec3 ray         = (far_point.xyz / far_point.w) - u_camera_position.xyz;\n"
+  "  float view_depth = mix(u_camera_position.w, u_camera_front.w, normal_depth.w);\n"
+  "  vec3 position    = u_camera_position.xyz + ray * (view_depth / dot(ray, u_camera_front.xyz));\n"
+  "\n"
+  "  vec3 normal   = normalize(normal_depth.xyz * 2.0 - 1.0);\n"
+  "  vec3 albedo   = texture(u_albedo, fs_in.tex_coords).rgb;\n"
+  "  vec3 specular = texture(u_material, fs_in.tex_coords).rgb;\n"
+  "  vec3 view_dir = normalize(u_camera_position.xyz - position);\n"
+  "\n"
+  "  vec3 color = albedo * u_ambient_light.rgb;\n"
+  "  for(int i = 0; i < u_lights_count.y; i++) {\n"
+  "    color += shade_light(u_lights[i], position, normal, view_dir, albedo, specular);\n"
+  "  }\n"
+  "\n"
+  "  // Only the lights of the cluster the pixel falls in\n"
+  "  ivec3 cell     = ivec3(gl_FragCoord.xy * u_cluster_scale.xy, log(view_depth) * u_cluster_scale.z + u_cluster_scale.w);\n"
+  "  cell           = clamp(cell, ivec3(0), u_cluster_grid.xyz - 1);\n"
+  "  uvec2 cluster  = u_clusters[cell.x + (cell.y * u_cluster_grid.x) + (cell.z * u_cluster_grid.x * u_cluster_grid.y)];\n"
+  "\n"
+  "  for(uint i = 0; i < cluster.y; i++) {\n"
+  "    color += shade_light(u_lights[u_light_indices[cluster.x + i]], position, normal, view_dir, albedo, specular);\n"
+  "  }\n"
+  "\n"
+  "  frag_color = vec4(color, 1.0);\n"
+  "}\n";
+
+static const i8* s_composite_pixel_source =
+  "#version 460 core\n"
+  "\n"
+  "// Outputs\n"
+  "layout (location = 0) out vec4 frag_color;\n"
+  "\n"
+  "// Inputs\n"
+  "in VS_OUT {\n"
+  "  vec2 tex_coords;\n"
+  "} fs_in;\n"
+  "\n"
+  "// Uniforms\n"
+  "layout (binding = 0) uniform sampler2D u_texture;\n"
+  "\n"
+  "void main() {\n"
+  "  frag_color = texture(u_texture, fs_in.tex_coords);\n"
+  "}\n";
+
+/// The G-buffer shaders of every supported vertex layout, with plain and array textures.
+/// The instance model matrix always comes right after the attributes of the mesh.
+static const i8* s_geometry_vertex_sources[2] = {
+  GBUFFER_VERTEX_SOURCE(2, 3), // VERTEX_TYPE_PNUV
+  GBUFFER_VERTEX_SOURCE(3, 4), // VERTEX_TYPE_PNCUV
+};
+
+static const i8* s_geometry_pixel_sources[2] = {
+  GBUFFER_PIXEL_SOURCE("sampler2D", "fs_in.tex_coords"),
+  GBUFFER_PIXEL_SOURCE("sampler2DArray", "vec3(fs_in.tex_coords, u_diffuse_layer)"),
+};
+
+/// Shaders
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// DeferredShading
+struct DeferredShading {
+  GfxContext* gfx = nullptr;
+
+  GfxShader* geometry_shaders[2][2];
+  GfxShader* lighting_shader  = nullptr;
+  GfxShader* composite_shader = nullptr;
+
+  GfxBuffer* screen_buffer = nullptr;
+
+  GfxPipeline* lighting_pipe         = nullptr;
+  GfxPipelineDesc lighting_pipe_desc = {};
+
+  GfxPipeline* composite_pipe         = nullptr;
+  GfxPipelineDesc composite_pipe_desc = {};
+
+  GfxTexture* default_texture = nullptr;
+};
+
+static DeferredShading s_deferred;
+/// DeferredShading
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static GfxPipelineDesc create_screen_pipe_desc(GfxShader* shader) {
+  GfxPipelineDesc desc = {};
+
+  desc.vertex_buffer  = s_deferred.screen_buffer;
+  desc.vertices_count = 3;
+  desc.shader         = shader;
+
+  desc.layout[0]    = {"POSITION", GFX_LAYOUT_FLOAT2, 0};
+  desc.layout_count = 1;
+
+  desc.draw_mode  = GFX_DRAW_MODE_TRIANGLE;
+  desc.depth_mask = false;
+
+  return desc;
+}
+
+static GfxTextureDesc create_target_desc(const i32 width, const i32 height, const GfxTextureType type, const GfxTextureFormat format) {
+  GfxTextureDesc desc = {};
+
+  desc.width     = (u32)width;
+  desc.height    = (u32)height;
+  desc.mips      = 1;
+  desc.type      = type;
+  desc.format    = format;
+  desc.filter    = GFX_TEXTURE_FILTER_MIN_MAG_NEAREST;
+  desc.wrap_mode = GFX_TEXTURE_WRAP_CLAMP;
+
+  return desc;
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Deferred shading functions
+
+void deferred_shading_init(GfxContext* gfx) {
+  s_deferred.gfx = gfx;
+
+  // Shaders init
+  for(sizei i = 0; i < 2; i++) {
+    for(sizei j = 0; j < 2; j++) {
+      GfxShaderDesc shader_desc = {
+        .vertex_source = s_geometry_vertex_sources[i],
+        .pixel_source  = s_geometry_pixel_sources[j],
+      };
+      s_deferred.geometry_shaders[i][j] = gfx_shader_create(gfx, shader_desc);
+    }
+  }
+
+  GfxShaderDesc lighting_desc = {
+    .vertex_source = s_screen_vertex_source,
+    .pixel_source  = s_lighting_pixel_source,
+  };
+  s_deferred.lighting_shader = gfx_shader_create(gfx, lighting_desc);
+
+  GfxShaderDesc composite_desc = {
+    .vertex_source = s_screen_vertex_source,
+    .pixel_source  = s_composite_pixel_source,
+  };
+  s_deferred.composite_shader = gfx_shader_create(gfx, composite_desc);
+
+  // A single triangle covering the whole screen
+  f32 vertices[] = {
+    -1.0f, -1.0f,
+     3.0f, -1.0f,
+    -1.0f,  3.0f,
+  };
+
+  GfxBufferDesc buff_desc = {
+    .data  = vertices,
+    .size  = sizeof(vertices),
+    .type  = GFX_BUFFER_VERTEX,
+    .usage = GFX_BUFFER_USAGE_STATIC_DRAW,
+  };
+  s_deferred.screen_buffer = gfx_buffer_create(gfx, buff_desc);
+
+  // Pipelines init
+  s_deferred.lighting_pipe_desc = create_screen_pipe_desc(s_deferred.lighting_shader);
+  s_deferred.lighting_pipe      = gfx_pipeline_create(gfx, s_deferred.lighting_pipe_desc);
+
+  s_deferred.composite_pipe_desc = create_screen_pipe_desc(s_deferred.composite_shader);
+  s_deferred.composite_pipe      = gfx_pipeline_create(gfx, s_deferred.composite_pipe_desc);
+
+  // Materials without a diffuse map still need something to sample. 
+  // The texture takes ownership of its pixels, so they have to be allocated.
+  u32* white_pixel = (u32*)memory_allocate(sizeof(u32));
+  *white_pixel     = 0xffffffff;
+
+  GfxTextureDesc tex_desc    = create_target_desc(1, 1, GFX_TEXTURE_2D, GFX_TEXTURE_FORMAT_RGBA8);
+  tex_desc.data              = white_pixel;
+  s_deferred.default_texture = gfx_texture_create(gfx, tex_desc);
+}
+
+void deferred_shading_shutdown() {
+  if(!s_deferred.gfx) {
+    return;
+  }
+
+  gfx_texture_destroy(s_deferred.default_texture);
+
+  gfx_pipeline_destroy(s_deferred.composite_pipe);
+  gfx_pipeline_destroy(s_deferred.lighting_pipe);
+  gfx_buffer_destroy(s_deferred.screen_buffer);
+
+  gfx_shader_destroy(s_deferred.composite_shader);
+  gfx_shader_destroy(s_deferred.lighting_shader);
+
+  for(sizei i = 0; i < 2; i++) {
+    for(sizei j = 0; j < 2; j++) {
+      gfx_shader_destroy(s_deferred.geometry_shaders[i][j]);
+    }
+  }
+
+  s_deferred = {};
+}
+
+void deferred_shading_acquire_targets(GfxContext* gfx, GBuffer& gbuffer) {
+  i32 width, height;
+  window_get_size(gfx_context_get_desc(gfx).window, &width, &height);
+
+  gbuffer.targets[GBUFFER_TARGET_ALBEDO]   = gfx_context_acquire_target(gfx, create_target_desc(width, height, GFX_TEXTURE_RENDER_TARGET, GFX_TEXTURE_FORMAT_RGBA8));
+  gbuffer.targets[GBUFFER_TARGET_NORMAL]   = gfx_context_acquire_target(gfx, create_target_desc(width, height, GFX_TEXTURE_RENDER_TARGET, GFX_TEXTURE_FORMAT_RGBA16));
+  gbuffer.targets[GBUFFER_TARGET_MATERIAL] = gfx_context_acquire_target(gfx, create_target_desc(width, height, GFX_TEXTURE_RENDER_TARGET, GFX_TEXTURE_FORMAT_RGBA8));
+
+  gbuffer.depth_stencil = gfx_context_acquire_target(gfx, create_target_desc(width, height, GFX_TEXTURE_DEPTH_STENCIL_TARGET, GFX_TEXTURE_FORMAT_DEPTH_STENCIL_24_8));
+  gbuffer.lit           = gfx_context_acquire_target(gfx, create_target_desc(width, height, GFX_TEXTURE_RENDER_TARGET, GFX_TEXTURE_FORMAT_RGBA8));
+}
+
+const bool deferred_shading_supports_mesh(const Mesh* mesh) {
+  // Only `VERTEX_TYPE_PNUV` and `VERTEX_TYPE_PNCUV` have a normal right after the position
+  return mesh->pipe_desc.layout_count >= 3 && mesh->pipe_desc.layout[1].type == GFX_LAYOUT_FLOAT3;
+}
+
+GfxShader* deferred_shading_get_geometry_shader(const Mesh* mesh, GfxTexture* diffuse_map) {
+  sizei layout_index  = mesh->pipe_desc.layout_count == 4 ? 1 : 0;
+  sizei texture_index = gfx_texture_get_desc(diffuse_map).type == GFX_TEXTURE_2D_ARRAY ? 1 : 0;
+
+  return s_deferred.geometry_shaders[layout_index][texture_index];
+}
+
+GfxTexture* deferred_shading_get_default_texture() {
+  return s_deferred.default_texture;
+}
+
+void deferred_shading_light(GfxCommandList* list, const GBuffer& gbuffer) {
+  GfxPipelineDesc& desc = s_deferred.lighting_pipe_desc;
+
+  for(sizei i = 0; i < GBUFFER_TARGETS_COUNT; i++) {
+    desc.textures[i] = gbuffer.targets[i];
+  }
+  desc.textures_count = GBUFFER_TARGETS_COUNT;
+
+  gfx_command_list_apply_pipeline(list, s_deferred.lighting_pipe, desc);
+  gfx_command_list_draw_vertex(list, s_deferred.lighting_pipe);
+}
+
+void deferred_shading_composite(GfxCommandList* list, const GBuffer& gbuffer) {
+  GfxPipelineDesc& desc = s_deferred.composite_pipe_desc;
+
+  desc.textures[0]    = gbuffer.lit;
+  desc.textures_count = 1;
+
+  gfx_command_list_apply_pipeline(list, s_deferred.composite_pipe, desc);
+  gfx_command_list_draw_vertex(list, s_deferred.composite_pipe);
+}
+
+/// Deferred shading functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
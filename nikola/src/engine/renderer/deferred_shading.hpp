@@ -0,0 +1,57 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// GBufferTarget
+enum GBufferTarget {
+  /// The diffuse color of the surface.
+  GBUFFER_TARGET_ALBEDO = 0,
+
+  /// The world-space normal (RGB) and the linear view depth (A) of the surface.
+  GBUFFER_TARGET_NORMAL,
+
+  /// The specular color of the surface.
+  GBUFFER_TARGET_MATERIAL,
+
+  GBUFFER_TARGETS_COUNT,
+};
+/// GBufferTarget
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// GBuffer
+struct GBuffer {
+  GfxTexture* targets[GBUFFER_TARGETS_COUNT];
+  GfxTexture* depth_stencil;
+
+  /// The target the lighting pass and any forward commands get rendered into.
+  GfxTexture* lit;
+};
+/// GBuffer
+/// ----------------------------------------------------------------------
+
+void deferred_shading_init(GfxContext* gfx);
+
+void deferred_shading_shutdown();
+
+void deferred_shading_acquire_targets(GfxContext* gfx, GBuffer& gbuffer);
+
+const bool deferred_shading_supports_mesh(const Mesh* mesh);
+
+GfxShader* deferred_shading_get_geometry_shader(const Mesh* mesh, GfxTexture* diffuse_map);
+
+GfxTexture* deferred_shading_get_default_texture();
+
+void deferred_shading_light(GfxCommandList* list, const GBuffer& gbuffer);
+
+void deferred_shading_composite(GfxCommandList* list, const GBuffer& gbuffer);
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,434 @@
+#include "frame_capture.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The first 8 bytes of every PNG file
+const u8 PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+/// The maximum size of a single stored (uncompressed) deflate block
+const sizei DEFLATE_BLOCK_MAX = 65535;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// CaptureFrame
+struct CaptureFrame {
+  u8* pixels = nullptr;
+  GfxReadbackDesc desc;
+
+  u64 index = 0;
+};
+/// CaptureFrame
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// CaptureSlot
+struct CaptureSlot {
+  GfxReadback* readback = nullptr;
+  CaptureFrame frame;
+};
+/// CaptureSlot
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// FrameCapture
+struct FrameCapture {
+  GfxContext* gfx = nullptr;
+  CaptureDesc desc;
+
+  CaptureSlot slots[RING_BUFFER_FRAMES];
+  u64 frames_issued  = 0;
+  u64 frames_dropped = 0;
+
+  bool is_active    = false;
+  bool is_capturing = false;
+
+  std::thread worker;
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  DynamicArray<CaptureFrame> queue;
+  bool is_stopping = false;
+};
+
+static FrameCapture s_capture;
+static u32 s_crc_table[256];
+/// FrameCapture
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void build_crc_table() {
+  for(u32 i = 0; i < 256; i++) {
+    u32 crc = i;
+
+    for(u32 j = 0; j < 8; j++) {
+      crc = (crc & 1) ? (0xedb88320 ^ (crc >> 1)) : (crc >> 1);
+    }
+
+    s_crc_table[i] = crc;
+  }
+}
+
+static u32 calc_crc(u32 crc, const u8* data, const sizei size) {
+  for(sizei i = 0; i < size; i++) {
+    crc = s_crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+
+  return crc;
+}
+
+static void write_u32_be(DynamicArray<u8>& out, const u32 value) {
+  out.push_back((value >> 24) & 0xff);
+  out.push_back((value >> 16) & 0xff);
+  out.push_back((value >> 8) & 0xff);
+  out.push_back(value & 0xff);
+}
+
+static void write_png_chunk(DynamicArray<u8>& out, const i8* type, const u8* data, const sizei size) {
+  write_u32_be(out, (u32)size);
+
+  // The CRC covers both the type and the data of the chunk
+  sizei type_start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data, data + size);
+
+  u32 crc = calc_crc(0xffffffff, &out[type_start], size + 4);
+  write_u32_be(out, crc ^ 0xffffffff);
+}
+
+static bool get_png_format(const GfxTextureFormat format, u8* color_type, u8* bit_depth) {
+  switch(format) {
+    case GFX_TEXTURE_FORMAT_R8:
+      *color_type = 0; // Grayscale
+      *bit_depth  = 8;
+      return true;
+    case GFX_TEXTURE_FORMAT_R16:
+      *color_type = 0;
+      *bit_depth  = 16;
+      return true;
+    case GFX_TEXTURE_FORMAT_RG8:
+      *color_type = 4; // Grayscale + alpha
+      *bit_depth  = 8;
+      return true;
+    case GFX_TEXTURE_FORMAT_RG16:
+      *color_type = 4;
+      *bit_depth  = 16;
+      return true;
+    case GFX_TEXTURE_FORMAT_RGBA8:
+      *color_type = 6; // RGBA
+      *bit_depth  = 8;
+      return true;
+    case GFX_TEXTURE_FORMAT_RGBA16:
+      *color_type = 6;
+      *bit_depth  = 16;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void copy_flipped_row(const CaptureFrame& frame, const u32 row, u8* dest) {
+  // The GPU hands the rows back from the bottom up
+  sizei row_size = frame.desc.size / frame.desc.height;
+  memory_copy(dest, frame.pixels + ((frame.desc.height - 1 - row) * row_size), row_size);
+}
+
+static void encode_png(const CaptureFrame& frame, DynamicArray<u8>& out) {
+  u8 color_type, bit_depth;
+  get_png_format(frame.desc.format, &color_type, &bit_depth);
+
+  sizei row_size = frame.desc.size / frame.desc.height;
+
+  // Every scanline starts with its filter type (always none here)
+  DynamicArray<u8> scanlines((row_size + 1) * frame.desc.height);
+  for(u32 y = 0; y < frame.desc.height; y++) {
+    u8* line = &scanlines[y * (row_size + 1)];
+    line[0]  = 0;
+
+    copy_flipped_row(frame, y, line + 1);
+
+    // PNG samples are big-endian
+    if(bit_depth == 16) {
+      for(sizei i = 1; i < row_size; i += 2) {
+        u8 temp     = line[i];
+        line[i]     = line[i + 1];
+        line[i + 1] = temp;
+      }
+    }
+  }
+
+  // A zlib stream of stored deflate blocks.
+  //
+  // @NOTE: Nothing gets compressed. The worker thread only has to keep up with
+  // the frame rate, and the files can always be re-compressed later on.
+  DynamicArray<u8> zlib;
+  zlib.reserve(scanlines.size() + ((scanlines.size() / DEFLATE_BLOCK_MAX) + 1) * 5 + 6);
+  zlib.push_back(0x78);
+  zlib.push_back(0x01);
+
+  u32 adler_a = 1, adler_b = 0;
+  for(sizei offset = 0; offset < scanlines.size(); offset += DEFLATE_BLOCK_MAX) {
+    sizei block_size = scanlines.size() - offset;
+    block_size       = block_size > DEFLATE_BLOCK_MAX ? DEFLATE_BLOCK_MAX : block_size;
+    bool is_final    = (offset + block_size) == scanlines.size();
+
+    zlib.push_back(is_final ? 1 : 0);
+    zlib.push_back(block_size & 0xff);
+    zlib.push_back((block_size >> 8) & 0xff);
+    zlib.push_back(~block_size & 0xff);
+    zlib.push_back((~block_size >> 8) & 0xff);
+    zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + block_size);
+
+    for(sizei i = offset; i < (offset + block_size); i++) {
+      adler_a = (adler_a + scanlines[i]) % 65521;
+      adler_b = (adler_b + adler_a) % 65521;
+    }
+  }
+  write_u32_be(zlib, (adler_b << 16) | adler_a);
+
+  // Header
+  u8 header[13];
+  header[0]  = (frame.desc.width >> 24) & 0xff;
+  header[1]  = (frame.desc.width >> 16) & 0xff;
+  header[2]  = (frame.desc.width >> 8) & 0xff;
+  header[3]  = frame.desc.width & 0xff;
+  header[4]  = (frame.desc.height >> 24) & 0xff;
+  header[5]  = (frame.desc.height >> 16) & 0xff;
+  header[6]  = (frame.desc.height >> 8) & 0xff;
+  header[7]  = frame.desc.height & 0xff;
+  header[8]  = bit_depth;
+  header[9]  = color_type;
+  header[10] = 0; // Compression
+  header[11] = 0; // Filter
+  header[12] = 0; // Interlace
+
+  out.insert(out.end(), PNG_SIGNATURE, PNG_SIGNATURE + 8);
+  write_png_chunk(out, "IHDR", header, sizeof(header));
+  write_png_chunk(out, "IDAT", zlib.data(), zlib.size());
+  write_png_chunk(out, "IEND", nullptr, 0);
+}
+
+static void encode_raw(const CaptureFrame& frame, DynamicArray<u8>& out) {
+  sizei row_size = frame.desc.size / frame.desc.height;
+  out.resize(frame.desc.size);
+
+  for(u32 y = 0; y < frame.desc.height; y++) {
+    copy_flipped_row(frame, y, &out[y * row_size]);
+  }
+}
+
+static void write_frame(const CaptureFrame& frame) {
+  // A minimized window has nothing to show
+  if(frame.desc.size == 0) {
+    return;
+  }
+
+  u8 color_type, bit_depth;
+  bool is_png = (s_capture.desc.format == CAPTURE_FORMAT_PNG) && get_png_format(frame.desc.format, &color_type, &bit_depth);
+
+  DynamicArray<u8> data;
+  if(is_png) {
+    encode_png(frame, data);
+  }
+  else {
+    encode_raw(frame, data);
+  }
+
+  // Frames are numbered by the order they were captured in
+  i8 name[64];
+  snprintf(name, sizeof(name), "frame_%06llu.%s", (unsigned long long)frame.index, is_png ? "png" : "raw");
+
+  FilePath path = filepath_append(s_capture.desc.output_dir, name);
+
+  File file;
+  if(!file_open(&file, path, (i32)(FILE_OPEN_WRITE | FILE_OPEN_BINARY))) {
+    NIKOLA_LOG_WARN("Could not write captured frame at \'%s\'", path.c_str());
+    return;
+  }
+
+  file_write_bytes(file, data.data(), data.size());
+  file_close(file);
+}
+
+static void capture_worker() {
+  DynamicArray<CaptureFrame> frames;
+
+  while(true) {
+    // Take every queued frame at once so the render thread is never held up for long
+    {
+      std::unique_lock<std::mutex> lock(s_capture.mutex);
+      s_capture.condition.wait(lock, []() { return !s_capture.queue.empty() || s_capture.is_stopping; });
+
+      if(s_capture.queue.empty() && s_capture.is_stopping) {
+        return;
+      }
+
+      frames.swap(s_capture.queue);
+    }
+
+    for(auto& frame : frames) {
+      write_frame(frame);
+      memory_free(frame.pixels);
+    }
+
+    frames.clear();
+  }
+}
+
+static void push_frame(CaptureFrame& frame) {
+  {
+    std::lock_guard<std::mutex> lock(s_capture.mutex);
+    s_capture.queue.push_back(frame);
+  }
+
+  s_capture.condition.notify_one();
+  frame.pixels = nullptr;
+}
+
+static void poll_slots() {
+  for(auto& slot : s_capture.slots) {
+    if(!gfx_readback_is_pending(slot.readback)) {
+      continue;
+    }
+
+    if(gfx_readback_poll(slot.readback, slot.frame.pixels)) {
+      push_frame(slot.frame);
+    }
+  }
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Frame capture functions
+
+void frame_capture_begin(GfxContext* gfx, const CaptureDesc& desc) {
+  NIKOLA_ASSERT(gfx, "Invalid GfxContext struct passed");
+
+  // Finish up any previous capture first
+  frame_capture_end();
+
+  std::error_code err;
+  std::filesystem::create_directories(desc.output_dir, err);
+  if(err) {
+    NIKOLA_LOG_WARN("Could not create the capture directory \'%s\'", desc.output_dir.c_str());
+    return;
+  }
+
+  s_capture.gfx            = gfx;
+  s_capture.desc           = desc;
+  s_capture.frames_issued  = 0;
+  s_capture.frames_dropped = 0;
+
+  for(auto& slot : s_capture.slots) {
+    slot.readback = gfx_readback_create(gfx);
+  }
+
+  build_crc_table();
+
+  s_capture.is_stopping  = false;
+  s_capture.worker       = std::thread(capture_worker);
+  s_capture.is_active    = true;
+  s_capture.is_capturing = true;
+
+  NIKOLA_LOG_INFO("Started capturing frames into \'%s\'", desc.output_dir.c_str());
+}
+
+void frame_capture_update() {
+  if(!s_capture.is_active) {
+    return;
+  }
+
+  // Hand off any reads from the previous frames that are done by now
+  poll_slots();
+
+  if(!s_capture.is_capturing) {
+    return;
+  }
+
+  // The slot is only still busy if the GPU is running more than `RING_BUFFER_FRAMES` frames behind
+  CaptureSlot& slot = s_capture.slots[s_capture.frames_issued % RING_BUFFER_FRAMES];
+  if(gfx_readback_is_pending(slot.readback)) {
+    s_capture.frames_dropped++;
+    return;
+  }
+
+  gfx_context_read_async(s_capture.gfx, slot.readback);
+
+  slot.frame.desc   = gfx_readback_get_desc(slot.readback);
+  slot.frame.index  = s_capture.frames_issued++;
+  slot.frame.pixels = (u8*)memory_allocate(slot.frame.desc.size);
+
+  // Stop capturing once enough frames were issued. The rest will still be polled.
+  if(s_capture.desc.frames_count != 0 && s_capture.frames_issued >= s_capture.desc.frames_count) {
+    s_capture.is_capturing = false;
+  }
+}
+
+void frame_capture_end() {
+  if(!s_capture.is_active) {
+    return;
+  }
+
+  s_capture.is_capturing = false;
+
+  // Drain the reads that are still in flight
+  bool has_pending = true;
+  while(has_pending) {
+    poll_slots();
+
+    has_pending = false;
+    for(auto& slot : s_capture.slots) {
+      has_pending = has_pending || gfx_readback_is_pending(slot.readback);
+    }
+  }
+
+  // Let the worker finish writing everything it has before shutting down
+  {
+    std::lock_guard<std::mutex> lock(s_capture.mutex);
+    s_capture.is_stopping = true;
+  }
+
+  s_capture.condition.notify_one();
+  s_capture.worker.join();
+
+  for(auto& slot : s_capture.slots) {
+    gfx_readback_destroy(slot.readback);
+    slot.readback = nullptr;
+  }
+
+  if(s_capture.frames_dropped > 0) {
+    NIKOLA_LOG_WARN("%llu frames were dropped while capturing", (unsigned long long)s_capture.frames_dropped);
+  }
+
+  s_capture.is_active = false;
+  NIKOLA_LOG_INFO("Captured %llu frames into \'%s\'", (unsigned long long)s_capture.frames_issued, s_capture.desc.output_dir.c_str());
+}
+
+const bool frame_capture_is_active() {
+  return s_capture.is_capturing;
+}
+
+/// Frame capture functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
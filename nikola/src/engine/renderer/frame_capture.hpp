@@ -0,0 +1,20 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+void frame_capture_begin(GfxContext* gfx, const CaptureDesc& desc);
+
+void frame_capture_update();
+
+void frame_capture_end();
+
+const bool frame_capture_is_active();
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
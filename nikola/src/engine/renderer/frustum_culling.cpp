@@ -0,0 +1,301 @@
+#include "frustum_culling.hpp"
+#include "worker_pool.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define NIKOLA_CULL_SSE 1
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The amount of bounds tested at once by the kernel. 
+const sizei CULL_LANES       = 4;
+
+/// Anything less than this many bounds per thread is not worth waking up a worker.
+const sizei CULL_THREAD_MIN  = 1024;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Frustum
+struct Frustum {
+  /// The planes in SoA form as well (left, right, bottom, top, near, far).
+  f32 normal_x[6], normal_y[6], normal_z[6];
+  f32 distance[6];
+  
+  /// The length of every plane normal, since the planes are never normalized.
+  f32 normal_length[6];
+};
+/// Frustum
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// CullJob
+struct CullJob {
+  const Frustum* frustum = nullptr;
+  
+  CullBounds* bounds   = nullptr;
+  CullSpheres* spheres = nullptr;
+};
+/// CullJob
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void extract_frustum(const Mat4& view_projection, Frustum& frustum) {
+  // Each plane is the last row of the matrix plus or minus one of the other rows
+  for(sizei i = 0; i < 6; i++) {
+    sizei row  = i / 2; 
+    f32 sign   = (i % 2) == 0 ? 1.0f : -1.0f;
+
+    frustum.normal_x[i] = view_projection[0][3] + (sign * view_projection[0][row]);
+    frustum.normal_y[i] = view_projection[1][3] + (sign * view_projection[1][row]);
+    frustum.normal_z[i] = view_projection[2][3] + (sign * view_projection[2][row]);
+    frustum.distance[i] = view_projection[3][3] + (sign * view_projection[3][row]);
+
+    frustum.normal_length[i] = sqrtf((frustum.normal_x[i] * frustum.normal_x[i]) + 
+                                     (frustum.normal_y[i] * frustum.normal_y[i]) + 
+                                     (frustum.normal_z[i] * frustum.normal_z[i]));
+  }
+}
+
+#if NIKOLA_CULL_SSE 
+
+static void cull_range(const Frustum& frustum, CullBounds& bounds, const sizei first, const sizei last) {
+  __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+  for(sizei i = first; i < last; i += CULL_LANES) {
+    __m128 center_x = _mm_loadu_ps(&bounds.center_x[i]);
+    __m128 center_y = _mm_loadu_ps(&bounds.center_y[i]);
+    __m128 center_z = _mm_loadu_ps(&bounds.center_z[i]);
+    
+    __m128 extent_x = _mm_loadu_ps(&bounds.extent_x[i]);
+    __m128 extent_y = _mm_loadu_ps(&bounds.extent_y[i]);
+    __m128 extent_z = _mm_loadu_ps(&bounds.extent_z[i]);
+
+    // The box is outside if it is completely behind any of the planes
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for(sizei p = 0; p < 6; p++) {
+      __m128 normal_x = _mm_set1_ps(frustum.normal_x[p]);
+      __m128 normal_y = _mm_set1_ps(frustum.normal_y[p]);
+      __m128 normal_z = _mm_set1_ps(frustum.normal_z[p]);
+      
+      // Signed distance of the centers to the plane
+      __m128 dist = _mm_add_ps(_mm_mul_ps(normal_x, center_x), _mm_set1_ps(frustum.distance[p]));
+      dist        = _mm_add_ps(dist, _mm_mul_ps(normal_y, center_y));
+      dist        = _mm_add_ps(dist, _mm_mul_ps(normal_z, center_z));
+
+      // How far the boxes reach along the normal of the plane
+      __m128 radius = _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_x), extent_x);
+      radius        = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_y), extent_y));
+      radius        = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_z), extent_z));
+
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+    }
+
+    i32 mask = _mm_movemask_ps(inside);
+    for(sizei lane = 0; lane < CULL_LANES; lane++) {
+      bounds.visible[i + lane] = (mask >> lane) & 1;
+    }
+  }
+}
+
+static void cull_sphere_range(const Frustum& frustum, CullSpheres& spheres, const sizei first, const sizei last) {
+  for(sizei i = first; i < last; i += CULL_LANES) {
+    __m128 center_x = _mm_loadu_ps(&spheres.center_x[i]);
+    __m128 center_y = _mm_loadu_ps(&spheres.center_y[i]);
+    __m128 center_z = _mm_loadu_ps(&spheres.center_z[i]);
+    __m128 radius   = _mm_loadu_ps(&spheres.radius[i]);
+
+    // The sphere is outside if its center is further behind any of the planes than its radius
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for(sizei p = 0; p < 6; p++) {
+      __m128 dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frustum.normal_x[p]), center_x), _mm_set1_ps(frustum.distance[p]));
+      dist        = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(frustum.normal_y[p]), center_y));
+      dist        = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(frustum.normal_z[p]), center_z));
+      
+      // The planes are not normalized, so the radius has to be scaled by the length of the normal 
+      __m128 scaled_radius = _mm_mul_ps(radius, _mm_set1_ps(frustum.normal_length[p]));
+      inside               = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, scaled_radius), _mm_setzero_ps()));
+    }
+
+    i32 mask = _mm_movemask_ps(inside);
+    for(sizei lane = 0; lane < CULL_LANES; lane++) {
+      spheres.visible[i + lane] = (mask >> lane) & 1;
+    }
+  }
+}
+
+#else
+
+static void cull_range(const Frustum& frustum, CullBounds& bounds, const sizei first, const sizei last) {
+  for(sizei i = first; i < last; i++) {
+    bool inside = true;
+
+    for(sizei p = 0; p < 6 && inside; p++) {
+      // Summed up in the same order as the SSE kernel, so both give the same results
+      f32 dist  = (frustum.normal_x[p] * bounds.center_x[i]) + frustum.distance[p];
+      dist     += frustum.normal_y[p] * bounds.center_y[i];
+      dist     += frustum.normal_z[p] * bounds.center_z[i];
+
+      f32 radius  = fabsf(frustum.normal_x[p]) * bounds.extent_x[i];
+      radius     += fabsf(frustum.normal_y[p]) * bounds.extent_y[i];
+      radius     += fabsf(frustum.normal_z[p]) * bounds.extent_z[i];
+
+      inside = (dist + radius) >= 0.0f;
+    }
+
+    bounds.visible[i] = inside;
+  }
+}
+
+static void cull_sphere_range(const Frustum& frustum, CullSpheres& spheres, const sizei first, const sizei last) {
+  for(sizei i = first; i < last; i++) {
+    bool inside = true;
+
+    for(sizei p = 0; p < 6 && inside; p++) {
+      f32 dist  = (frustum.normal_x[p] * spheres.center_x[i]) + frustum.distance[p];
+      dist     += frustum.normal_y[p] * spheres.center_y[i];
+      dist     += frustum.normal_z[p] * spheres.center_z[i];
+
+      inside = (dist + (spheres.radius[i] * frustum.normal_length[p])) >= 0.0f;
+    }
+
+    spheres.visible[i] = inside;
+  }
+}
+
+#endif
+
+static void cull_bounds_job(void* user_data, const sizei first, const sizei last) {
+  CullJob* job = (CullJob*)user_data;
+  cull_range(*job->frustum, *job->bounds, first, last);
+}
+
+static void cull_spheres_job(void* user_data, const sizei first, const sizei last) {
+  CullJob* job = (CullJob*)user_data;
+  cull_sphere_range(*job->frustum, *job->spheres, first, last);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Frustum culling functions
+
+void cull_bounds_clear(CullBounds& bounds) {
+  bounds.center_x.clear();
+  bounds.center_y.clear();
+  bounds.center_z.clear();
+  
+  bounds.extent_x.clear();
+  bounds.extent_y.clear();
+  bounds.extent_z.clear();
+
+  bounds.visible.clear();
+  bounds.count = 0;
+}
+
+void cull_bounds_push(CullBounds& bounds, const Vec3& center, const Vec3& extents) {
+  bounds.center_x.push_back(center.x);
+  bounds.center_y.push_back(center.y);
+  bounds.center_z.push_back(center.z);
+  
+  bounds.extent_x.push_back(extents.x);
+  bounds.extent_y.push_back(extents.y);
+  bounds.extent_z.push_back(extents.z);
+
+  bounds.count++;
+}
+
+void cull_spheres_clear(CullSpheres& spheres) {
+  spheres.center_x.clear();
+  spheres.center_y.clear();
+  spheres.center_z.clear();
+  spheres.radius.clear();
+
+  spheres.visible.clear();
+  spheres.count = 0;
+}
+
+void cull_spheres_push(CullSpheres& spheres, const Vec3& center, const f32 radius) {
+  spheres.center_x.push_back(center.x);
+  spheres.center_y.push_back(center.y);
+  spheres.center_z.push_back(center.z);
+  spheres.radius.push_back(radius);
+
+  spheres.count++;
+}
+
+void frustum_cull(const Mat4& view_projection, CullBounds& bounds, const u32 threads_count) {
+  if(bounds.count == 0) {
+    return;
+  }
+
+  Frustum frustum;
+  extract_frustum(view_projection, frustum);
+
+  // Pad the arrays to a whole amount of lanes so the kernel never reads past them
+  sizei padded_count = ((bounds.count + CULL_LANES - 1) / CULL_LANES) * CULL_LANES;
+  
+  bounds.center_x.resize(padded_count, 0.0f);
+  bounds.center_y.resize(padded_count, 0.0f);
+  bounds.center_z.resize(padded_count, 0.0f);
+  
+  bounds.extent_x.resize(padded_count, 0.0f);
+  bounds.extent_y.resize(padded_count, 0.0f);
+  bounds.extent_z.resize(padded_count, 0.0f);
+  
+  bounds.visible.resize(padded_count, 0);
+
+  // Every worker gets a whole amount of `CULL_THREAD_MIN` bounds, which are whole lanes as well
+  CullJob job = {
+    .frustum = &frustum, 
+    .bounds  = &bounds,
+  };
+  worker_pool_dispatch(cull_bounds_job, &job, padded_count, CULL_THREAD_MIN, threads_count);
+}
+
+void frustum_cull_spheres(const Mat4& view_projection, CullSpheres& spheres, const u32 threads_count) {
+  if(spheres.count == 0) {
+    return;
+  }
+
+  Frustum frustum;
+  extract_frustum(view_projection, frustum);
+
+  // Pad the arrays to a whole amount of lanes so the kernel never reads past them
+  sizei padded_count = ((spheres.count + CULL_LANES - 1) / CULL_LANES) * CULL_LANES;
+  
+  spheres.center_x.resize(padded_count, 0.0f);
+  spheres.center_y.resize(padded_count, 0.0f);
+  spheres.center_z.resize(padded_count, 0.0f);
+  spheres.radius.resize(padded_count, 0.0f);
+  
+  spheres.visible.resize(padded_count, 0);
+
+  CullJob job = {
+    .frustum = &frustum, 
+    .spheres = &spheres,
+  };
+  worker_pool_dispatch(cull_spheres_job, &job, padded_count, CULL_THREAD_MIN, threads_count);
+}
+
+/// Frustum culling functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// CullBounds
+struct CullBounds {
+  DynamicArray<f32> center_x, center_y, center_z;
+  DynamicArray<f32> extent_x, extent_y, extent_z;
+  
+  DynamicArray<u8> visible;
+  sizei count = 0;
+};
+/// CullBounds
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// CullSpheres
+struct CullSpheres {
+  DynamicArray<f32> center_x, center_y, center_z;
+  DynamicArray<f32> radius;
+  
+  DynamicArray<u8> visible;
+  sizei count = 0;
+};
+/// CullSpheres
+/// ----------------------------------------------------------------------
+
+void cull_bounds_clear(CullBounds& bounds);
+
+void cull_bounds_push(CullBounds& bounds, const Vec3& center, const Vec3& extents);
+
+void cull_spheres_clear(CullSpheres& spheres);
+
+void cull_spheres_push(CullSpheres& spheres, const Vec3& center, const f32 radius);
+
+void frustum_cull(const Mat4& view_projection, CullBounds& bounds, const u32 threads_count);
+
+void frustum_cull_spheres(const Mat4& view_projection, CullSpheres& spheres, const u32 threads_count);
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
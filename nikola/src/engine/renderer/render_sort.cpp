@@ -0,0 +1,142 @@
+#include "render_sort.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Sort key consts
+
+/// The order of each group of commands in the render queue. 
+/// Skyboxes write the farthest depth, so they go right after the opaque commands.
+const u64 SORT_PASS_OPAQUE      = 0;
+const u64 SORT_PASS_SKYBOX      = 1;
+const u64 SORT_PASS_TRANSPARENT = 2;
+
+/// The amount of bits each state gets in a sort key.
+const u32 SORT_STATE_BITS       = 12;
+
+/// The amount of bits the quantized depth gets in a sort key.
+const u32 SORT_DEPTH_BITS       = 24;
+const u64 SORT_DEPTH_MAX        = (1ull << SORT_DEPTH_BITS) - 1;
+
+/// Sort key consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static u64 fold_bits(const u64 value, const u32 bits) {
+  // Fibonacci hashing, so that similar handles still spread out
+  return (value * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Render sort functions
+
+const u64 sort_key_build(const SortKeyDesc& desc) {
+  // Skyboxes do not need any more than their pass
+  if(desc.is_skybox) {
+    return SORT_PASS_SKYBOX << 62;
+  }
+
+  f32 depth = clamp_float(desc.depth, 0.0f, 1.0f);
+
+  u64 depth_bits    = (u64)(depth * (f32)SORT_DEPTH_MAX);
+  u64 shader_bits   = fold_bits(desc.shader, SORT_STATE_BITS);
+  u64 material_bits = fold_bits(desc.material, SORT_STATE_BITS);
+  u64 mesh_bits     = fold_bits(desc.mesh, SORT_STATE_BITS);
+
+  // Transparent commands:
+  // [63-62: pass] [59-36: depth (far to near)] [35-24: shader] [23-12: material] [11-0: mesh]
+  if(desc.is_transparent) {
+    return (SORT_PASS_TRANSPARENT << 62)       | 
+           ((SORT_DEPTH_MAX - depth_bits) << 36) | 
+           (shader_bits << 24)                  | 
+           (material_bits << 12)                | 
+           mesh_bits;
+  }
+
+  // Opaque commands:
+  // [63-62: pass] [59-48: shader] [47-36: material] [35-24: mesh] [23-0: depth (near to far)]
+  return (SORT_PASS_OPAQUE << 62) | 
+         (shader_bits << 48)      | 
+         (material_bits << 36)    | 
+         (mesh_bits << 24)        | 
+         depth_bits;
+}
+
+void sort_items_radix(DynamicArray<SortItem>& items, DynamicArray<SortItem>& scratch) {
+  if(items.empty()) {
+    return;
+  }
+
+  scratch.resize(items.size());
+
+  SortItem* src = items.data();
+  SortItem* dst = scratch.data();
+  sizei count   = items.size();
+
+  // Least significant byte first. Each pass is stable, so equal 
+  // keys keep the order they were queued in.
+  for(u32 shift = 0; shift < 64; shift += 8) {
+    sizei offsets[256] = {};
+    for(sizei i = 0; i < count; i++) {
+      offsets[(src[i].key >> shift) & 0xff]++;
+    }
+
+    // Every key has the same byte here, so nothing would move
+    if(offsets[(src[0].key >> shift) & 0xff] == count) {
+      continue;
+    }
+
+    sizei total = 0;
+    for(sizei i = 0; i < 256; i++) {
+      sizei bucket_count = offsets[i];
+      offsets[i]         = total;
+      total             += bucket_count;
+    }
+
+    for(sizei i = 0; i < count; i++) {
+      dst[offsets[(src[i].key >> shift) & 0xff]++] = src[i];
+    }
+
+    SortItem* temp = src;
+    src            = dst;
+    dst            = temp;
+  }
+
+  // The sorted items might have ended up in the scratch buffer
+  if(src != items.data()) {
+    memory_copy(items.data(), src, sizeof(SortItem) * count);
+  }
+}
+
+void draw_runs_build(DynamicArray<DrawRun>& runs, const sizei first, const sizei last, const DrawMergeFn can_merge, void* user_data) {
+  sizei i = first;
+  while(i < last) {
+    DrawRun run = {(u32)i, 1};
+
+    // Sorting already put identical commands next to each other, 
+    // so a run only has to look at the commands right after it. 
+    while((i + run.count) < last && can_merge(user_data, run.first, (u32)(i + run.count))) {
+      run.count++;
+    }
+
+    runs.push_back(run);
+    i += run.count;
+  }
+}
+
+/// Render sort functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// SortItem
+struct SortItem {
+  u64 key; 
+  u32 index;
+};
+/// SortItem
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// SortKeyDesc
+struct SortKeyDesc {
+  /// The view depth of the command, normalized into the range of the camera.
+  f32 depth = 0.0f;
+
+  /// Any handles identifying the states of the command. 
+  u64 shader   = 0;
+  u64 material = 0;
+  u64 mesh     = 0;
+
+  bool is_skybox      = false;
+  bool is_transparent = false;
+};
+/// SortKeyDesc
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// DrawRun
+struct DrawRun {
+  /// The first sorted item of the run, which is also its first instance.
+  u32 first; 
+  u32 count;
+};
+/// DrawRun
+/// ----------------------------------------------------------------------
+
+using DrawMergeFn = bool(*)(void* user_data, const u32 first, const u32 other);
+
+const u64 sort_key_build(const SortKeyDesc& desc);
+
+void sort_items_radix(DynamicArray<SortItem>& items, DynamicArray<SortItem>& scratch);
+
+void draw_runs_build(DynamicArray<DrawRun>& runs, const sizei first, const sizei last, const DrawMergeFn can_merge, void* user_data);
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -1,22 +1,123 @@
+#include "frame_capture.hpp"
+#include "frustum_culling.hpp"
+#include "deferred_shading.hpp"
+#include "clustered_lights.hpp"
+#include "batch_renderer.hpp"
+#include "worker_pool.hpp"
+#include "render_sort.hpp"
+
 #include "nikola/nikola_core.hpp"
 #include "nikola/nikola_engine.hpp"
 
+#include <cmath>
+
 //////////////////////////////////////////////////////////////////////////
 
 namespace nikola { // Start of nikola
 
+/// ----------------------------------------------------------------------
+/// DrawData
+struct DrawData {
+  Mat4 model; 
+
+  Vec4 ambient_color; 
+  Vec4 diffuse_color; 
+  Vec4 specular_color;
+};
+/// DrawData
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// LightingData
+struct LightingData {
+  Mat4 inverse_view_projection;
+  
+  Vec4 camera_position; // w = near
+  Vec4 camera_front;    // w = far
+  Vec4 ambient_light;
+  IVec4 lights_count;   // x = all lights, y = directional lights
+
+  IVec4 cluster_grid;
+  Vec4 cluster_scale;
+};
+/// LightingData
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// LightData
+struct LightData {
+  Vec4 position_radius; 
+  Vec4 direction_type;
+  Vec4 color_intensity;
+  Vec4 cone;
+};
+/// LightData
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// LOD consts
+
+/// The projected diameter (as a fraction of the screen height) under which 
+/// a command switches to the next level of detail.
+const f32 LOD_SCREEN_SIZES[MESH_LODS_MAX - 1] = {0.4f, 0.2f, 0.1f};
+
+/// How far (as a fraction of the projected size) a command has to move past 
+/// a threshold before it leaves the level of detail of the last frame.
+const f32 LOD_HYSTERESIS                      = 0.1f;
+
+/// LOD consts
+/// ----------------------------------------------------------------------
+
 /// ----------------------------------------------------------------------
 /// Renderer
 struct Renderer {
   GfxContext* context = nullptr;
+  GfxCommandList* command_list = nullptr;
   GfxBuffer* matrices_buffer;
 
+  GfxBuffer* draw_buffer;
+  sizei draw_stride; 
+  DynamicArray<u8> draw_data;
+
+  GfxBuffer* instance_buffer;
+  DynamicArray<Mat4> instance_data;
+
+  GfxBuffer* lighting_buffer;
+  LightingData lighting_data;
+  Vec3 ambient_color = Vec3(0.1f);
+
+  /// Directional lights reach every pixel, so they are kept apart from the clustered ones.
+  GfxBuffer* lights_buffer;
+  DynamicArray<LightData> light_data;
+  DynamicArray<Light> directional_lights;
+  DynamicArray<Light> local_lights;
+
   Vec4 clear_color;
   Camera camera;
 
   u32 clear_flags = 0;
+  RenderPath path = RENDER_PATH_FORWARD;
 
   DynamicArray<RenderCommand> render_queue;
+  DynamicArray<SortItem> sort_items;
+  DynamicArray<SortItem> sort_scratch;
+  DynamicArray<DrawRun> draw_runs;
+
+  /// The sorted items and runs that go through the G-buffer come before any forward ones.
+  sizei geometry_items_count = 0;
+  sizei geometry_runs_count  = 0;
+
+  bool culling_enabled  = true;
+  u32 culling_threads   = 1;
+  CullBounds cull_bounds;
+  CullSpheres cull_spheres;
+  DynamicArray<u32> cull_indices;
+
+  f32 lod_bias = 1.0f;
+  HashMap<u64, u8> lod_history; 
+  HashMap<u64, u8> lod_history_previous; 
+
+  RendererStats stats;
 };
 
 static Renderer s_renderer;
@@ -26,7 +127,426 @@ static Renderer s_renderer;
 /// ----------------------------------------------------------------------
 /// Private functions
 
-static void render_mesh(const RenderCommand& command) {
+static u64 build_sort_key(const RenderCommand& command) {
+  Material* material = resource_storage_get_material(command.storage, command.material_id);
+  Camera& cam        = s_renderer.camera;
+
+  // The view depth of the command, which gets normalized into the range of the camera
+  Vec3 position = Vec3(command.transform.transform[3]);
+  f32 depth     = vec3_dot(position - cam.position, cam.front);
+
+  SortKeyDesc desc = {
+    .depth          = (depth - cam.near) / (cam.far - cam.near),
+    .shader         = (u64)material->shader, 
+    .material       = (u64)command.material_id, 
+    .mesh           = (u64)command.renderable_id ^ ((u64)command.lod << 56),
+    .is_skybox      = command.render_type == RENDERABLE_TYPE_SKYBOX,
+    .is_transparent = command.is_transparent,
+  };
+  return sort_key_build(desc);
+}
+
+static bool get_command_bounds(const RenderCommand& command, Vec3* min, Vec3* max) {
+  switch(command.render_type) {
+    case RENDERABLE_TYPE_MESH: {
+      Mesh* mesh = resource_storage_get_mesh(command.storage, command.renderable_id);
+      *min       = mesh->bounds_min;
+      *max       = mesh->bounds_max;
+      return mesh->has_bounds;
+    }
+    case RENDERABLE_TYPE_MODEL: {
+      Model* model = resource_storage_get_model(command.storage, command.renderable_id);
+      *min         = model->bounds_min;
+      *max         = model->bounds_max;
+      return model->has_bounds;
+    }
+    default: // Skyboxes are always visible
+      return false;
+  }
+}
+
+static u8 get_command_lods_count(const RenderCommand& command) {
+  switch(command.render_type) {
+    case RENDERABLE_TYPE_MESH:
+      return resource_storage_get_mesh(command.storage, command.renderable_id)->lods_count;
+    case RENDERABLE_TYPE_MODEL: {
+      Model* model = resource_storage_get_model(command.storage, command.renderable_id);
+      u8 count     = 0;
+
+      // Meshes with fewer levels just stay on their last one
+      for(auto& mesh : model->meshes) {
+        count = mesh->lods_count > count ? mesh->lods_count : count;
+      }
+
+      return count;
+    }
+    default:
+      return 0;
+  }
+}
+
+static u8 select_lod(const f32 screen_size, const u8 lods_count) {
+  u8 lod = 0;
+  while((lod + 1) < lods_count && screen_size < LOD_SCREEN_SIZES[lod]) {
+    lod++;
+  }
+
+  return lod;
+}
+
+static u8 pick_command_lod(const RenderCommand& command) {
+  u8 lods_count = get_command_lods_count(command);
+  if(lods_count <= 1) {
+    return 0;
+  }
+
+  Vec3 min, max; 
+  if(!get_command_bounds(command, &min, &max)) {
+    return 0;
+  }
+
+  // Bounding sphere of the command in world space
+  const Mat4& model = command.transform.transform;
+  Vec3 center       = Vec3(model * Vec4((min + max) * 0.5f, 1.0f)); 
+
+  f32 scale = 0.0f;
+  for(sizei i = 0; i < 3; i++) {
+    f32 column_scale = sqrtf(vec3_dot(Vec3(model[i]), Vec3(model[i])));
+    scale            = column_scale > scale ? column_scale : scale;
+  }
+
+  Vec3 extent  = (max - min) * 0.5f;
+  f32 radius   = sqrtf(vec3_dot(extent, extent)) * scale;
+  f32 distance = vec3_distance(center, s_renderer.camera.position);
+
+  // Too close to be anything but the full mesh
+  if(distance <= radius) {
+    return 0;
+  }
+
+  // The projected diameter as a fraction of the screen height
+  f32 screen_size = (radius * s_renderer.camera.projection[1][1] / distance) * s_renderer.lod_bias;
+  u8 lod          = select_lod(screen_size, lods_count);
+
+  // Objects without a stable id cannot be matched with the last frame
+  if(command.object_id == 0) {
+    return lod;
+  }
+
+  // Stay on the level of the last frame as long as it is still close enough
+  u64 key   = command.object_id;
+  auto prev = s_renderer.lod_history_previous.find(key);
+  
+  if(prev != s_renderer.lod_history_previous.end()) {
+    u8 finest   = select_lod(screen_size * (1.0f + LOD_HYSTERESIS), lods_count);
+    u8 coarsest = select_lod(screen_size * (1.0f - LOD_HYSTERESIS), lods_count);
+
+    if(prev->second >= finest && prev->second <= coarsest) {
+      lod = prev->second;
+    }
+  }
+
+  s_renderer.lod_history[key] = lod;
+  return lod;
+}
+
+static void cull_render_queue() {
+  CullBounds& bounds = s_renderer.cull_bounds;
+  
+  cull_bounds_clear(bounds);
+  s_renderer.cull_indices.clear();
+
+  // Transform the local bounds of every command into world-space boxes
+  for(sizei i = 0; i < s_renderer.render_queue.size(); i++) {
+    RenderCommand& command = s_renderer.render_queue[i];
+
+    Vec3 min, max; 
+    if(!get_command_bounds(command, &min, &max)) {
+      continue;
+    }
+
+    const Mat4& model = command.transform.transform;
+    Vec3 local_center = (min + max) * 0.5f;
+    Vec3 local_extent = (max - min) * 0.5f;
+
+    Vec3 center  = Vec3(model * Vec4(local_center, 1.0f)); 
+    Vec3 extents = Vec3(0.0f);
+    for(sizei j = 0; j < 3; j++) {
+      extents[j] = (fabsf(model[0][j]) * local_extent.x) + 
+                   (fabsf(model[1][j]) * local_extent.y) + 
+                   (fabsf(model[2][j]) * local_extent.z);
+    }
+
+    cull_bounds_push(bounds, center, extents);
+    s_renderer.cull_indices.push_back((u32)i);
+  }
+
+  frustum_cull(s_renderer.camera.view_projection, bounds, s_renderer.culling_threads);
+}
+
+static bool is_instanceable(const RenderCommand& command) {
+  Material* material = resource_storage_get_material(command.storage, command.material_id);
+  Mesh* mesh         = nullptr;
+
+  switch(command.render_type) {
+    case RENDERABLE_TYPE_MESH:
+      mesh = resource_storage_get_mesh(command.storage, command.renderable_id);
+      break;
+    case RENDERABLE_TYPE_MODEL: {
+      Model* model = resource_storage_get_model(command.storage, command.renderable_id);
+      mesh         = model->meshes.empty() ? nullptr : model->meshes[0];
+    } break;
+    default: 
+      break;
+  }
+
+  if(!mesh || !material->shader) {
+    return false;
+  }
+
+  // The instance attributes always come right after the attributes of the mesh
+  i32 location = gfx_glsl_get_attribute_location(material->shader, MATERIAL_ATTRIBUTE_INSTANCE_MODEL);
+  return location != -1 && location == (i32)mesh->pipe_desc.layout_count;
+}
+
+static bool is_same_draw(const RenderCommand& a, const RenderCommand& b) {
+  return a.render_type   == b.render_type   && 
+         a.renderable_id == b.renderable_id && 
+         a.material_id   == b.material_id   && 
+         a.storage       == b.storage       && 
+         a.lod           == b.lod;
+}
+
+static bool can_merge_draws(void* user_data, const u32 first, const u32 other) {
+  bool is_geometry = *(bool*)user_data;
+
+  RenderCommand& command       = s_renderer.render_queue[s_renderer.sort_items[first].index];
+  RenderCommand& other_command = s_renderer.render_queue[s_renderer.sort_items[other].index];
+
+  // The G-buffer shaders can always be instanced
+  return is_same_draw(command, other_command) && (is_geometry || is_instanceable(command));
+}
+
+static void build_draw_runs(const sizei first, const sizei last, bool is_geometry) {
+  draw_runs_build(s_renderer.draw_runs, first, last, can_merge_draws, &is_geometry);
+}
+
+static bool is_geometry_command(const RenderCommand& command) {
+  if(command.is_transparent) {
+    return false;
+  }
+
+  switch(command.render_type) {
+    case RENDERABLE_TYPE_MESH: 
+      return deferred_shading_supports_mesh(resource_storage_get_mesh(command.storage, command.renderable_id));
+    case RENDERABLE_TYPE_MODEL: {
+      Model* model = resource_storage_get_model(command.storage, command.renderable_id);
+
+      for(auto& mesh : model->meshes) {
+        if(!deferred_shading_supports_mesh(mesh)) {
+          return false;
+        }
+      }
+
+      return !model->meshes.empty();
+    }
+    default:
+      return false;
+  }
+}
+
+static sizei partition_geometry_items() {
+  DynamicArray<SortItem>& items   = s_renderer.sort_items;
+  DynamicArray<SortItem>& scratch = s_renderer.sort_scratch;
+  
+  scratch.clear();
+  
+  // Move the forward items out of the way while keeping both groups in sorted order
+  sizei geometry_count = 0;
+  for(sizei i = 0; i < items.size(); i++) {
+    if(is_geometry_command(s_renderer.render_queue[items[i].index])) {
+      items[geometry_count++] = items[i];
+    }
+    else {
+      scratch.push_back(items[i]);
+    }
+  }
+
+  for(sizei i = 0; i < scratch.size(); i++) {
+    items[geometry_count + i] = scratch[i];
+  }
+
+  return geometry_count;
+}
+
+static LightData pack_light(const Light& light) {
+  f32 type = 0.0f;
+  switch(light.type) {
+    case LIGHT_TYPE_POINT:
+      type = 0.0f;
+      break;
+    case LIGHT_TYPE_SPOT:
+      type = 1.0f;
+      break;
+    case LIGHT_TYPE_DIRECTIONAL:
+      type = 2.0f;
+      break;
+  }
+
+  LightData data; 
+  data.position_radius = Vec4(light.position, light.radius);
+  data.direction_type  = Vec4(vec3_normalize(light.direction), type);
+  data.color_intensity = Vec4(light.color, light.intensity);
+  data.cone            = Vec4(cosf(light.inner_cone), cosf(light.outer_cone), 0.0f, 0.0f);
+
+  return data;
+}
+
+static void clear_lights() {
+  s_renderer.directional_lights.clear();
+  s_renderer.local_lights.clear();
+}
+
+static void cull_local_lights() {
+  CullSpheres& spheres = s_renderer.cull_spheres;
+  cull_spheres_clear(spheres);
+
+  for(auto& light : s_renderer.local_lights) {
+    cull_spheres_push(spheres, light.position, light.radius);
+  }
+
+  frustum_cull_spheres(s_renderer.camera.view_projection, spheres, s_renderer.culling_threads);
+
+  // Lights that cannot reach anything on screen are not worth clustering or uploading
+  sizei visible_count = 0;
+  for(sizei i = 0; i < s_renderer.local_lights.size(); i++) {
+    if(spheres.visible[i]) {
+      s_renderer.local_lights[visible_count++] = s_renderer.local_lights[i];
+    }
+  }
+
+  s_renderer.local_lights.resize(visible_count);
+}
+
+static void upload_lighting() {
+  Camera& cam = s_renderer.camera;
+
+  if(s_renderer.culling_enabled) {
+    cull_local_lights();
+  }
+
+  // The directional lights come first, so the clusters only have to index the rest
+  sizei directional_count = s_renderer.directional_lights.size();
+  sizei lights_count      = directional_count + s_renderer.local_lights.size();
+
+  for(sizei i = 0; i < directional_count; i++) {
+    s_renderer.light_data[i] = pack_light(s_renderer.directional_lights[i]);
+  }
+
+  for(sizei i = 0; i < s_renderer.local_lights.size(); i++) {
+    s_renderer.light_data[directional_count + i] = pack_light(s_renderer.local_lights[i]);
+  }
+
+  // Ring buffers have to be written every frame, even when there is nothing in them
+  sizei lights_size = sizeof(LightData) * (lights_count > 0 ? lights_count : 1);
+  gfx_buffer_update(s_renderer.lights_buffer, 0, lights_size, s_renderer.light_data.data());
+
+  i32 width, height;
+  window_get_size(gfx_context_get_desc(s_renderer.context).window, &width, &height);
+
+  clustered_lights_build(cam, 
+                         IVec2(width, height),
+                         s_renderer.local_lights.data(), 
+                         s_renderer.local_lights.size(), 
+                         (u32)directional_count, 
+                         s_renderer.culling_threads);
+  
+  LightingData& data = s_renderer.lighting_data;
+
+  data.inverse_view_projection = mat4_inverse(cam.view_projection);
+  data.camera_position         = Vec4(cam.position, cam.near);
+  data.camera_front            = Vec4(cam.front, cam.far);
+  data.ambient_light           = Vec4(s_renderer.ambient_color, 1.0f);
+  data.lights_count            = IVec4((i32)lights_count, (i32)directional_count, 0, 0);
+  data.cluster_grid            = clustered_lights_get_grid();
+  data.cluster_scale           = clustered_lights_get_scale();
+
+  gfx_buffer_update(s_renderer.lighting_buffer, 0, sizeof(LightingData), &data);
+  s_renderer.stats.lights_count = lights_count;
+}
+
+static void set_instance_layout(Mesh* mesh) {
+  mesh->pipe_desc.instance_buffer       = s_renderer.instance_buffer;
+  mesh->pipe_desc.instance_layout[0]    = {"INSTANCE_MODEL", GFX_LAYOUT_MAT4, 1};
+  mesh->pipe_desc.instance_layout_count = 1;
+}
+
+static void set_mesh_lod(Mesh* mesh, const u8 lod, const DrawRun& run) {
+  if(!mesh->index_buffer || mesh->lods_count == 0) {
+    return;
+  }
+
+  // Every level lives in the same index buffer, so only the range changes
+  const Mesh::LOD& level         = mesh->lods[lod < mesh->lods_count ? lod : (mesh->lods_count - 1)];
+  mesh->pipe_desc.indices_offset = level.indices_offset;
+  mesh->pipe_desc.indices_count  = level.indices_count;
+
+  s_renderer.stats.triangles_count += (level.indices_count / 3) * run.count;
+}
+
+static void pack_draw_data(const RenderCommand& command, const sizei offset) {
+  Material* material = resource_storage_get_material(command.storage, command.material_id);
+  DrawData* data     = (DrawData*)&s_renderer.draw_data[offset];
+
+  data->model          = command.transform.transform;
+  data->ambient_color  = Vec4(material->ambient_color, 1.0f);
+  data->diffuse_color  = Vec4(material->diffuse_color, 1.0f);
+  data->specular_color = Vec4(material->specular_color, 1.0f);
+}
+
+static void render_geometry_mesh(Mesh* mesh, const u8 lod, GfxTexture* diffuse_map, const i32 diffuse_layer, const DrawRun& run) {
+  GfxTexture* texture = diffuse_map ? diffuse_map : deferred_shading_get_default_texture();
+  GfxShader* shader   = deferred_shading_get_geometry_shader(mesh, texture);
+
+  // Only the texture array variants have a layer to sample from
+  i32 layer_location = gfx_glsl_get_uniform_location(shader, MATERIAL_UNIFORM_DIFFUSE_LAYER);
+  if(layer_location != -1) {
+    gfx_command_list_upload_uniform(s_renderer.command_list, shader, layer_location, GFX_LAYOUT_INT1, &diffuse_layer);
+  }
+
+  // Setting up the pipeline
+  mesh->pipe_desc.shader         = shader;
+  mesh->pipe_desc.textures[0]    = texture;
+  mesh->pipe_desc.textures_count = 1;
+  set_instance_layout(mesh);
+  set_mesh_lod(mesh, lod, run);
+
+  // Render the mesh into the G-buffer
+  gfx_command_list_apply_pipeline(s_renderer.command_list, mesh->pipe, mesh->pipe_desc);
+  gfx_command_list_draw_index(s_renderer.command_list, mesh->pipe, run.count, run.first);
+}
+
+static void render_geometry(const RenderCommand& command, const sizei offset, const DrawRun& run) {
+  Material* material = resource_storage_get_material(command.storage, command.material_id);
+  
+  // The colors come from the material of the command, even for models
+  gfx_command_list_bind_range(s_renderer.command_list, s_renderer.draw_buffer, MATERIAL_DRAW_BUFFER_INDEX, offset, sizeof(DrawData));
+
+  if(command.render_type == RENDERABLE_TYPE_MESH) {
+    Mesh* mesh = resource_storage_get_mesh(command.storage, command.renderable_id);
+    render_geometry_mesh(mesh, command.lod, material->diffuse_map, material->diffuse_layer, run);
+    
+    return;
+  }
+
+  Model* model = resource_storage_get_model(command.storage, command.renderable_id);
+  for(sizei i = 0; i < model->meshes.size(); i++) {
+    Material* mesh_material = model->materials[model->material_indices[i]]; 
+    render_geometry_mesh(model->meshes[i], command.lod, mesh_material->diffuse_map, mesh_material->diffuse_layer, run);
+  }
+}
+
+static void render_mesh(const RenderCommand& command, const sizei offset, const DrawRun& run) {
   Mesh* mesh         = resource_storage_get_mesh(command.storage, command.renderable_id);
   Material* material = resource_storage_get_material(command.storage, command.material_id);
 
@@ -34,16 +554,19 @@ static void render_mesh(const RenderCommand& command) {
   material->model_matrix = command.transform.transform; 
 
   // Uploading the uniforms
-  material_use(material);  
+  material_use(material, s_renderer.command_list);  
+  gfx_command_list_bind_range(s_renderer.command_list, s_renderer.draw_buffer, MATERIAL_DRAW_BUFFER_INDEX, offset, sizeof(DrawData));
 
   // Setting up the pipeline
   mesh->pipe_desc.shader         = material->shader;
   mesh->pipe_desc.textures[0]    = material->diffuse_map;
   mesh->pipe_desc.textures_count = material->diffuse_map ? 1 : 0; // Only set a texutre if there's one in the material
+  set_instance_layout(mesh);
+  set_mesh_lod(mesh, command.lod, run);
 
   // Render the mesh
-  gfx_context_apply_pipeline(s_renderer.context, mesh->pipe, mesh->pipe_desc);
-  gfx_pipeline_draw_index(mesh->pipe);
+  gfx_command_list_apply_pipeline(s_renderer.command_list, mesh->pipe, mesh->pipe_desc);
+  gfx_command_list_draw_index(s_renderer.command_list, mesh->pipe, run.count, run.first);
 }
 
 static void render_skybox(const RenderCommand& command) {
@@ -54,17 +577,20 @@ static void render_skybox(const RenderCommand& command) {
   skybox->pipe_desc.shader = material->shader;
 
   // Render the skybox
-  gfx_context_apply_pipeline(s_renderer.context, skybox->pipe, skybox->pipe_desc);
-  gfx_pipeline_draw_vertex(skybox->pipe);
+  gfx_command_list_apply_pipeline(s_renderer.command_list, skybox->pipe, skybox->pipe_desc);
+  gfx_command_list_draw_vertex(s_renderer.command_list, skybox->pipe);
 }
 
-static void render_model(const RenderCommand& command) {
+static void render_model(const RenderCommand& command, const sizei offset, const DrawRun& run) {
   Model* model  = resource_storage_get_model(command.storage, command.renderable_id);
   Material* mat = resource_storage_get_material(command.storage, command.material_id);
 
   // Set our "parent" transform
   mat->model_matrix = command.transform.transform; 
 
+  // Every mesh in the model shares the same draw data
+  gfx_command_list_bind_range(s_renderer.command_list, s_renderer.draw_buffer, MATERIAL_DRAW_BUFFER_INDEX, offset, sizeof(DrawData));
+
   for(sizei i = 0; i < model->meshes.size(); i++) {
     Mesh* mesh              = model->meshes[i];
     Material* mesh_material = model->materials[model->material_indices[i]]; 
@@ -79,18 +605,116 @@ static void render_model(const RenderCommand& command) {
     mesh_material->diffuse_color  = mat->diffuse_color; 
     mesh_material->specular_color = mat->specular_color; 
 
+    // Each mesh might sample a different layer of a packed texture array
+    mat->diffuse_layer  = mesh_material->diffuse_layer;
+    mat->specular_layer = mesh_material->specular_layer;
+
     // Upload the uniforms 
-    material_use(mat);
+    material_use(mat, s_renderer.command_list);
 
     // Setting up the pipeline for each mesh
     mesh->pipe_desc.shader         = mesh_material->shader;
     mesh->pipe_desc.textures[0]    = mesh_material->diffuse_map;
     mesh->pipe_desc.textures_count = 1;
+    set_instance_layout(mesh);
+    set_mesh_lod(mesh, command.lod, run);
 
     // Render the mesh
-    gfx_context_apply_pipeline(s_renderer.context, mesh->pipe, mesh->pipe_desc);
-    gfx_pipeline_draw_index(mesh->pipe);
+    gfx_command_list_apply_pipeline(s_renderer.command_list, mesh->pipe, mesh->pipe_desc);
+    gfx_command_list_draw_index(s_renderer.command_list, mesh->pipe, run.count, run.first);
+  }
+}
+
+static void render_runs(const sizei first, const sizei last) {
+  for(sizei i = first; i < last; i++) {
+    DrawRun& run           = s_renderer.draw_runs[i];
+    RenderCommand& command = s_renderer.render_queue[s_renderer.sort_items[run.first].index];
+    sizei offset           = i * s_renderer.draw_stride;
+
+    switch(command.render_type) {
+      case RENDERABLE_TYPE_MESH:
+        render_mesh(command, offset, run);
+        break;
+      case RENDERABLE_TYPE_MODEL:
+        render_model(command, offset, run);
+        break;
+      case RENDERABLE_TYPE_SKYBOX:
+        render_skybox(command);
+        break;
+    }
+  }
+}
+
+static void bind_lighting() {
+  GfxCommandList* list = s_renderer.command_list;
+
+  gfx_command_list_bind_range(list, s_renderer.lighting_buffer, MATERIAL_LIGHTING_BUFFER_INDEX, 0, sizeof(LightingData));
+  gfx_command_list_bind_range(list, s_renderer.lights_buffer, MATERIAL_LIGHTS_BUFFER_INDEX, 0, sizeof(LightData) * LIGHTS_MAX);
+  clustered_lights_bind(list);
+}
+
+static void render_forward() {
+  gfx_command_list_reset(s_renderer.command_list);
+  bind_lighting();
+
+  render_runs(0, s_renderer.draw_runs.size());
+  gfx_context_submit(s_renderer.context, s_renderer.command_list);
+}
+
+static void render_deferred() {
+  GfxContext* gfx      = s_renderer.context;
+  GfxCommandList* list = s_renderer.command_list;
+  
+  GBuffer gbuffer;
+  deferred_shading_acquire_targets(gfx, gbuffer);
+
+  // Geometry pass
+  //
+  // @NOTE: Each pass is submitted on its own since the targets 
+  // are switched on the context rather than on the command list.
+  gfx_context_set_targets(gfx, gbuffer.targets, GBUFFER_TARGETS_COUNT, gbuffer.depth_stencil);
+  gfx_command_list_reset(list);
+  gfx_command_list_clear(list, 0.0f, 0.0f, 0.0f, 1.0f, GFX_CONTEXT_FLAGS_CUSTOM_RENDER_TARGET | 
+                                                       GFX_CONTEXT_FLAGS_CLEAR_COLOR_BUFFER   | 
+                                                       GFX_CONTEXT_FLAGS_CLEAR_DEPTH_BUFFER   | 
+                                                       GFX_CONTEXT_FLAGS_CLEAR_STENCIL_BUFFER);
+
+  gfx_command_list_bind_range(list, s_renderer.matrices_buffer, MATERIAL_MATRICES_BUFFER_INDEX, 0, sizeof(Mat4) * 2);
+  bind_lighting();
+
+  for(sizei i = 0; i < s_renderer.geometry_runs_count; i++) {
+    DrawRun& run           = s_renderer.draw_runs[i];
+    RenderCommand& command = s_renderer.render_queue[s_renderer.sort_items[run.first].index];
+    
+    render_geometry(command, i * s_renderer.draw_stride, run);
   }
+  gfx_context_submit(gfx, list);
+
+  // Lighting pass
+  Vec4 col = s_renderer.clear_color;
+  
+  gfx_context_set_targets(gfx, &gbuffer.lit, 1, nullptr);
+  gfx_command_list_reset(list);
+  gfx_command_list_clear(list, col.r, col.g, col.b, col.a, GFX_CONTEXT_FLAGS_CUSTOM_RENDER_TARGET | GFX_CONTEXT_FLAGS_CLEAR_COLOR_BUFFER);
+  
+  bind_lighting();
+  deferred_shading_light(list, gbuffer);
+  gfx_context_submit(gfx, list);
+
+  // Forward pass on top of the lit scene, tested against the depth of the geometry pass
+  gfx_context_set_targets(gfx, &gbuffer.lit, 1, gbuffer.depth_stencil);
+  gfx_command_list_reset(list);
+  
+  bind_lighting();
+  render_runs(s_renderer.geometry_runs_count, s_renderer.draw_runs.size());
+  gfx_context_submit(gfx, list);
+
+  // Back to the window
+  gfx_context_set_targets(gfx, nullptr, 0, nullptr);
+  gfx_command_list_reset(list);
+  
+  deferred_shading_composite(list, gbuffer);
+  gfx_context_submit(gfx, list);
 }
 
 /// Private functions
@@ -101,22 +725,81 @@ static void render_model(const RenderCommand& command) {
 
 void renderer_init(Window* window, const Vec4& clear_clear) {
   GfxContextDesc gfx_desc = {
-    .window       = window,
-    .states       = GFX_STATE_DEPTH | GFX_STATE_STENCIL,
-    .pixel_format = GFX_TEXTURE_FORMAT_RGBA8,
+    .window           = window,
+    .states           = GFX_STATE_DEPTH | GFX_STATE_STENCIL,
+    .pixel_format     = GFX_TEXTURE_FORMAT_RGBA8,
+    .shader_cache_dir = "shader_cache",
   };
+
+  // Only used by whatever enables blending (like the batch renderer)
+  gfx_desc.blend_desc.src_color_blend  = GFX_BLEND_SRC_ALPHA;
+  gfx_desc.blend_desc.dest_color_blend = GFX_BLEND_INV_SRC_ALPHA;
   
   s_renderer.context = gfx_context_init(gfx_desc);
   NIKOLA_ASSERT(s_renderer.context, "Failed to initialize the graphics context");
 
+  s_renderer.command_list = gfx_command_list_create(s_renderer.context);
+
+  // The workers are kept around for the whole run so the culling never has to spawn any threads
+  worker_pool_init(0);
+
   GfxBufferDesc buff_desc = {
     .data  = nullptr, 
     .size  = sizeof(Mat4) * 2,
     .type  = GFX_BUFFER_UNIFORM,
-    .usage = GFX_BUFFER_USAGE_DYNAMIC_DRAW,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
   };
   s_renderer.matrices_buffer = gfx_buffer_create(s_renderer.context, buff_desc);
 
+  // Each draw gets its own aligned region in the draw buffer
+  sizei alignment        = gfx_context_get_uniform_alignment(s_renderer.context);
+  s_renderer.draw_stride = ((sizeof(DrawData) + alignment - 1) / alignment) * alignment;
+  s_renderer.draw_data.resize(s_renderer.draw_stride * RENDER_QUEUE_MAX);
+
+  GfxBufferDesc draw_desc = {
+    .data  = nullptr, 
+    .size  = s_renderer.draw_data.size(),
+    .type  = GFX_BUFFER_UNIFORM,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+  s_renderer.draw_buffer = gfx_buffer_create(s_renderer.context, draw_desc);
+
+  // Every queued command can end up as an instance of some draw
+  s_renderer.instance_data.resize(RENDER_QUEUE_MAX);
+
+  GfxBufferDesc instance_desc = {
+    .data  = nullptr, 
+    .size  = sizeof(Mat4) * RENDER_QUEUE_MAX,
+    .type  = GFX_BUFFER_VERTEX,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+  s_renderer.instance_buffer = gfx_buffer_create(s_renderer.context, instance_desc);
+
+  GfxBufferDesc lighting_desc = {
+    .data  = nullptr, 
+    .size  = sizeof(LightingData),
+    .type  = GFX_BUFFER_UNIFORM,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+  s_renderer.lighting_buffer = gfx_buffer_create(s_renderer.context, lighting_desc);
+
+  s_renderer.light_data.resize(LIGHTS_MAX);
+  s_renderer.directional_lights.reserve(LIGHTS_MAX);
+  s_renderer.local_lights.reserve(LIGHTS_MAX);
+
+  GfxBufferDesc lights_desc = {
+    .data  = nullptr, 
+    .size  = sizeof(LightData) * LIGHTS_MAX,
+    .type  = GFX_BUFFER_SHADER_STORAGE,
+    .usage = GFX_BUFFER_USAGE_STREAM_RING,
+  };
+  s_renderer.lights_buffer = gfx_buffer_create(s_renderer.context, lights_desc);
+  clustered_lights_init(s_renderer.context);
+
+  // The deferred path is always ready so it can be switched to at any point
+  deferred_shading_init(s_renderer.context);
+  batch_renderer_init(s_renderer.context);
+
   s_renderer.clear_color = clear_clear;
   s_renderer.clear_flags = GFX_CONTEXT_FLAGS_CLEAR_COLOR_BUFFER |  
                            GFX_CONTEXT_FLAGS_CLEAR_STENCIL_BUFFER | 
@@ -126,7 +809,20 @@ void renderer_init(Window* window, const Vec4& clear_clear) {
 }
 
 void renderer_shutdown() {
+  frame_capture_end();
+
+  batch_renderer_shutdown();
+  deferred_shading_shutdown();
+  clustered_lights_shutdown();
+
+  gfx_buffer_destroy(s_renderer.lights_buffer);
+  gfx_buffer_destroy(s_renderer.lighting_buffer);
+  gfx_buffer_destroy(s_renderer.instance_buffer);
+  gfx_buffer_destroy(s_renderer.draw_buffer);
+  gfx_command_list_destroy(s_renderer.command_list);
   gfx_context_shutdown(s_renderer.context);
+
+  worker_pool_shutdown();
   NIKOLA_LOG_INFO("Successfully shutdown the renderer context");
 }
 
@@ -138,6 +834,31 @@ void renderer_set_clear_color(const Vec4& clear_color) {
   s_renderer.clear_color = clear_color;
 }
 
+void renderer_set_ambient_color(const Vec3& color) {
+  s_renderer.ambient_color = color;
+}
+
+void renderer_set_path(const RenderPath path) {
+  s_renderer.path = path;
+}
+
+const RenderPath renderer_get_path() {
+  return s_renderer.path;
+}
+
+void renderer_set_culling(const bool enabled, const u32 threads_count) {
+  s_renderer.culling_enabled = enabled;
+  s_renderer.culling_threads = threads_count > 0 ? threads_count : 1;
+}
+
+void renderer_set_lod_bias(const f32 bias) {
+  s_renderer.lod_bias = bias > 0.0f ? bias : 0.0f;
+}
+
+const RendererStats renderer_get_stats() {
+  return s_renderer.stats;
+}
+
 const GfxBuffer* renderer_default_matrices_buffer() {
   return s_renderer.matrices_buffer;
 }
@@ -156,29 +877,140 @@ void renderer_begin_pass() {
 }
 
 void renderer_end_pass() {
-  for(auto& command : s_renderer.render_queue) {
-    switch(command.render_type) {
-      case RENDERABLE_TYPE_MESH:
-        render_mesh(command);
-        break;
-      case RENDERABLE_TYPE_MODEL:
-        render_model(command);
-        break;
-      case RENDERABLE_TYPE_SKYBOX:
-        render_skybox(command);
-        break;
+  s_renderer.stats = RendererStats{};
+
+  // The levels picked this frame are what the next frame compares against
+  s_renderer.lod_history.swap(s_renderer.lod_history_previous);
+  s_renderer.lod_history.clear();
+
+  if(s_renderer.render_queue.empty()) {
+    clear_lights();
+    return;
+  }
+
+  s_renderer.stats.commands_count = s_renderer.render_queue.size();
+
+  // Sort the queue by the keys of the commands
+  s_renderer.sort_items.resize(s_renderer.render_queue.size());
+  for(sizei i = 0; i < s_renderer.render_queue.size(); i++) {
+    s_renderer.sort_items[i] = SortItem{s_renderer.render_queue[i].sort_key, (u32)i};
+  }
+
+  // Throw away any commands outside the view of the camera
+  if(s_renderer.culling_enabled) {
+    cull_render_queue();
+    
+    // Culled commands get marked by an invalid index in their item
+    for(sizei i = 0; i < s_renderer.cull_indices.size(); i++) {
+      if(!s_renderer.cull_bounds.visible[i]) {
+        s_renderer.sort_items[s_renderer.cull_indices[i]].index = UINT32_MAX;
+      }
+    }
+
+    sizei visible_count = 0;
+    for(sizei i = 0; i < s_renderer.sort_items.size(); i++) {
+      if(s_renderer.sort_items[i].index != UINT32_MAX) {
+        s_renderer.sort_items[visible_count++] = s_renderer.sort_items[i];
+      }
+    }
+
+    s_renderer.stats.culled_count = s_renderer.sort_items.size() - visible_count;
+    s_renderer.sort_items.resize(visible_count);
+  }
+
+  if(s_renderer.sort_items.empty()) {
+    s_renderer.render_queue.clear();
+    clear_lights();
+    return;
+  }
+
+  sort_items_radix(s_renderer.sort_items, s_renderer.sort_scratch);
+
+  // Split off the commands that go through the G-buffer
+  bool is_deferred = (s_renderer.path == RENDER_PATH_DEFERRED);
+  s_renderer.geometry_items_count = is_deferred ? partition_geometry_items() : 0;
+
+  // Merge identical commands into instanced draws
+  s_renderer.draw_runs.clear();
+  build_draw_runs(0, s_renderer.geometry_items_count, true);
+  s_renderer.geometry_runs_count = s_renderer.draw_runs.size();
+
+  build_draw_runs(s_renderer.geometry_items_count, s_renderer.sort_items.size(), false);
+  s_renderer.stats.draws_count = s_renderer.draw_runs.size();
+
+  // Pack the data of every draw and upload it all at once
+  for(sizei i = 0; i < s_renderer.draw_runs.size(); i++) {
+    RenderCommand& command = s_renderer.render_queue[s_renderer.sort_items[s_renderer.draw_runs[i].first].index];
+    
+    if(command.render_type != RENDERABLE_TYPE_SKYBOX) {
+      pack_draw_data(command, i * s_renderer.draw_stride);
     }
   }
 
+  sizei data_size = s_renderer.draw_runs.size() * s_renderer.draw_stride;
+  gfx_buffer_update(s_renderer.draw_buffer, 0, data_size, s_renderer.draw_data.data());
+
+  // Each command is an instance in sorted order, so every run reads its own slice
+  for(sizei i = 0; i < s_renderer.sort_items.size(); i++) {
+    s_renderer.instance_data[i] = s_renderer.render_queue[s_renderer.sort_items[i].index].transform.transform;
+  }
+
+  sizei instances_size = s_renderer.sort_items.size() * sizeof(Mat4);
+  gfx_buffer_update(s_renderer.instance_buffer, 0, instances_size, s_renderer.instance_data.data());
+
+  upload_lighting();
+
+  // Record the whole pass first and only then submit it to the context
+  if(is_deferred) {
+    render_deferred();
+  }
+  else {
+    render_forward();
+  }
+
   s_renderer.render_queue.clear();
+  clear_lights();
 }
 
 void renderer_post_pass() {
+  // The frame has to be read before it gets swapped out
+  frame_capture_update();
+
   gfx_context_present(s_renderer.context);
+  batch_renderer_next_frame();
 }
 
 void renderer_queue_command(const RenderCommand& command) {
+  NIKOLA_ASSERT((s_renderer.render_queue.size() < RENDER_QUEUE_MAX), "Too many commands in the render queue");
+  
   s_renderer.render_queue.push_back(command);
+  
+  RenderCommand& queued = s_renderer.render_queue.back();
+  queued.lod            = pick_command_lod(queued);
+  queued.sort_key       = build_sort_key(queued);
+}
+
+void renderer_queue_light(const Light& light) {
+  NIKOLA_ASSERT(((s_renderer.directional_lights.size() + s_renderer.local_lights.size()) < LIGHTS_MAX), "Too many lights in the current pass");
+
+  if(light.type == LIGHT_TYPE_DIRECTIONAL) {
+    s_renderer.directional_lights.push_back(light);
+  }
+  else {
+    s_renderer.local_lights.push_back(light);
+  }
+}
+
+void renderer_begin_capture(const CaptureDesc& desc) {
+  frame_capture_begin(s_renderer.context, desc);
+}
+
+void renderer_end_capture() {
+  frame_capture_end();
+}
+
+const bool renderer_is_capturing() {
+  return frame_capture_is_active();
 }
 
 /// Renderer functions
@@ -0,0 +1,179 @@
+#include "worker_pool.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// The maximum amount of workers in the pool, not counting the calling thread.
+const u32 WORKER_THREADS_MAX = 15;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// WorkerPool
+struct WorkerPool {
+  DynamicArray<std::thread> workers;
+  
+  std::mutex mutex;
+  std::condition_variable start_condition;
+  std::condition_variable done_condition;
+
+  /// The job of the current dispatch, split into `ranges_count` ranges of `range` items each. 
+  /// The calling thread always takes the first range.
+  WorkerJobFn job = nullptr;
+  void* user_data = nullptr;
+  sizei count        = 0;
+  sizei range        = 0;
+  u32 ranges_count   = 0;
+  
+  u32 pending_count  = 0;
+  u64 generation     = 0;
+  bool is_stopping   = false;
+};
+
+static WorkerPool s_pool;
+/// WorkerPool
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void pool_worker(const u32 index) {
+  u64 generation = 0;
+
+  while(true) {
+    WorkerJobFn job;
+    void* user_data;
+    sizei first, last;
+
+    // Sleep until there is a new dispatch
+    {
+      std::unique_lock<std::mutex> lock(s_pool.mutex);
+      s_pool.start_condition.wait(lock, [&]() { return s_pool.generation != generation || s_pool.is_stopping; });
+
+      if(s_pool.is_stopping) {
+        return;
+      }
+
+      generation = s_pool.generation;
+
+      // Not every worker takes part in every dispatch
+      u32 range_index = index + 1;
+      if(range_index >= s_pool.ranges_count) {
+        continue;
+      }
+
+      job       = s_pool.job;
+      user_data = s_pool.user_data;
+      first     = range_index * s_pool.range;
+      last      = (range_index == s_pool.ranges_count - 1) ? s_pool.count : (first + s_pool.range);
+    }
+
+    job(user_data, first, last);
+
+    {
+      std::lock_guard<std::mutex> lock(s_pool.mutex);
+      s_pool.pending_count--;
+    }
+
+    s_pool.done_condition.notify_one();
+  }
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Worker pool functions
+
+void worker_pool_init(const u32 threads_count) {
+  // Use every hardware thread unless told otherwise
+  u32 threads = threads_count > 0 ? threads_count : std::thread::hardware_concurrency();
+
+  // The calling thread always does some of the work as well
+  u32 workers_count = threads > 1 ? (threads - 1) : 0;
+  workers_count     = workers_count < WORKER_THREADS_MAX ? workers_count : WORKER_THREADS_MAX;
+
+  s_pool.is_stopping = false;
+  s_pool.generation  = 0;
+  s_pool.workers.reserve(workers_count);
+
+  for(u32 i = 0; i < workers_count; i++) {
+    s_pool.workers.emplace_back(pool_worker, i);
+  }
+
+  NIKOLA_LOG_INFO("Started a worker pool with %u worker threads", workers_count);
+}
+
+void worker_pool_shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(s_pool.mutex);
+    s_pool.is_stopping = true;
+  }
+  
+  s_pool.start_condition.notify_all();
+
+  for(auto& worker : s_pool.workers) {
+    worker.join();
+  }
+
+  s_pool.workers.clear();
+}
+
+void worker_pool_dispatch(WorkerJobFn job, void* user_data, const sizei count, const sizei granularity, const u32 threads_count) {
+  NIKOLA_ASSERT(job, "Invalid job passed to the worker pool");
+  NIKOLA_ASSERT(granularity > 0, "Cannot dispatch a job with a granularity of zero");
+
+  // Every range has to have at least a whole `granularity` of items
+  sizei ranges_count = threads_count < worker_pool_get_threads_count() ? threads_count : worker_pool_get_threads_count();
+  sizei max_ranges   = count / granularity;
+  ranges_count       = ranges_count < max_ranges ? ranges_count : max_ranges;
+
+  if(ranges_count <= 1) {
+    job(user_data, 0, count);
+    return;
+  }
+
+  sizei range = ((count / ranges_count) / granularity) * granularity;
+
+  {
+    std::lock_guard<std::mutex> lock(s_pool.mutex);
+
+    s_pool.job           = job;
+    s_pool.user_data     = user_data;
+    s_pool.count         = count;
+    s_pool.range         = range;
+    s_pool.ranges_count  = (u32)ranges_count;
+    s_pool.pending_count = (u32)ranges_count - 1;
+    s_pool.generation++;
+  }
+
+  s_pool.start_condition.notify_all();
+  job(user_data, 0, range);
+
+  // Wait for the rest of the ranges to be done
+  std::unique_lock<std::mutex> lock(s_pool.mutex);
+  s_pool.done_condition.wait(lock, []() { return s_pool.pending_count == 0; });
+}
+
+const u32 worker_pool_get_threads_count() {
+  return (u32)s_pool.workers.size() + 1;
+}
+
+/// Worker pool functions
+/// ----------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+/// A job that works on the items in the range of `[first, last)`.
+using WorkerJobFn = void(*)(void* user_data, const sizei first, const sizei last);
+
+void worker_pool_init(const u32 threads_count);
+
+void worker_pool_shutdown();
+
+void worker_pool_dispatch(WorkerJobFn job, void* user_data, const sizei count, const sizei granularity, const u32 threads_count);
+
+const u32 worker_pool_get_threads_count();
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
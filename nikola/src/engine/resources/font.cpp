@@ -0,0 +1,94 @@
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola {
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Private functions
+
+static const Font::Glyph* find_glyph(const Font* font, const i32 codepoint) {
+  // The glyphs are a contiguous range of codepoints, so they can be indexed directly
+  i32 index = codepoint - font->glyphs[0].unicode;
+  if(index < 0 || index >= (i32)font->glyphs.size()) {
+    return nullptr;
+  }
+
+  return &font->glyphs[index];
+}
+
+/// Private functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Font functions
+
+const Font::Glyph& font_get_glyph(const Font* font, const i32 codepoint) {
+  NIKOLA_ASSERT(font, "Cannot retrieve a glyph from an invalid font");
+
+  const Font::Glyph* glyph = find_glyph(font, codepoint);
+  if(glyph) {
+    return *glyph;
+  }
+
+  glyph = find_glyph(font, '?');
+  return glyph ? *glyph : font->glyphs[0];
+}
+
+const bool font_has_glyph(const Font* font, const i32 codepoint) {
+  NIKOLA_ASSERT(font, "Cannot look for a glyph in an invalid font");
+
+  return find_glyph(font, codepoint) != nullptr;
+}
+
+const f32 font_get_kerning(const Font* font, const i32 left, const i32 right) {
+  NIKOLA_ASSERT(font, "Cannot retrieve the kerning of an invalid font");
+
+  u64 key = ((u64)(u32)left << 32) | (u64)(u32)right;
+  auto it = font->kernings.find(key);
+
+  return (it != font->kernings.end()) ? it->second : 0.0f;
+}
+
+const Vec2 font_measure_text(const Font* font, const String& text, const f32 size) {
+  NIKOLA_ASSERT(font, "Cannot measure text with an invalid font");
+
+  f32 scale       = size / font->base_size;
+  f32 line_height = (font->ascent - font->descent + font->line_gap) * scale;
+
+  f32 max_width  = 0.0f;
+  f32 line_width = 0.0f;
+  f32 height     = line_height;
+  i32 previous   = 0;
+
+  for(auto& ch : text) {
+    i32 codepoint = (u8)ch;
+
+    if(codepoint == '\n') {
+      max_width  = line_width > max_width ? line_width : max_width;
+      line_width = 0.0f;
+      height    += line_height;
+      previous   = 0;
+      continue;
+    }
+
+    // Has to skip the same bytes as `batch_renderer_text`
+    if(!font_has_glyph(font, codepoint)) {
+      continue;
+    }
+
+    line_width += (font_get_glyph(font, codepoint).advance_x + font_get_kerning(font, previous, codepoint)) * scale;
+    previous    = codepoint;
+  }
+
+  max_width = line_width > max_width ? line_width : max_width;
+  return Vec2(max_width, height);
+}
+
+/// Font functions
+///---------------------------------------------------------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,92 @@
+#include "font_loader.hpp"
+
+#include "nikola/nikola_core.hpp"
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola {
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Private functions
+
+static void load_atlas(ResourceStorage* storage, Font* font, const NBRFont* nbr_font) {
+  // The texture takes ownership of its pixels, so they have to be copied
+  sizei atlas_size = nbr_font->atlas_width * nbr_font->atlas_height;
+
+  GfxTextureDesc tex_desc = {};
+  tex_desc.width          = nbr_font->atlas_width;
+  tex_desc.height         = nbr_font->atlas_height;
+  tex_desc.mips           = 1;
+  tex_desc.type           = GFX_TEXTURE_2D;
+  tex_desc.format         = GFX_TEXTURE_FORMAT_R8;
+  tex_desc.filter         = GFX_TEXTURE_FILTER_MIN_MAG_LINEAR;
+  tex_desc.wrap_mode      = GFX_TEXTURE_WRAP_CLAMP;
+  tex_desc.data           = memory_allocate(atlas_size);
+  memory_copy(tex_desc.data, nbr_font->atlas_pixels, atlas_size);
+
+  ResourceID atlas_id = resource_storage_push_texture(storage, tex_desc);
+  font->atlas         = resource_storage_get_texture(storage, atlas_id);
+}
+
+static void load_glyphs(Font* font, const NBRFont* nbr_font) {
+  f32 atlas_width  = (f32)nbr_font->atlas_width;
+  f32 atlas_height = (f32)nbr_font->atlas_height;
+
+  font->glyphs.resize(nbr_font->glyphs_count);
+  for(sizei i = 0; i < nbr_font->glyphs_count; i++) {
+    const NBRGlyph& nbr_glyph = nbr_font->glyphs[i];
+    Font::Glyph& glyph        = font->glyphs[i];
+
+    glyph.unicode      = nbr_glyph.unicode;
+    glyph.texture_rect = Vec4(nbr_glyph.atlas_x / atlas_width, 
+                              nbr_glyph.atlas_y / atlas_height, 
+                              nbr_glyph.width / atlas_width, 
+                              nbr_glyph.height / atlas_height);
+    glyph.size         = Vec2(nbr_glyph.width, nbr_glyph.height);
+    glyph.offset       = Vec2(nbr_glyph.offset_x, nbr_glyph.offset_y);
+    glyph.advance_x    = nbr_glyph.advance_x;
+  }
+}
+
+static void load_kernings(Font* font, const NBRFont* nbr_font) {
+  font->kernings.reserve(nbr_font->kernings_count);
+
+  for(sizei i = 0; i < nbr_font->kernings_count; i++) {
+    const NBRKerning& kerning = nbr_font->kernings[i];
+
+    u64 key             = ((u64)(u32)kerning.left << 32) | (u64)(u32)kerning.right;
+    font->kernings[key] = kerning.amount;
+  }
+}
+
+/// Private functions
+///---------------------------------------------------------------------------------------------------------------------
+
+///---------------------------------------------------------------------------------------------------------------------
+/// Font loader functions
+
+void font_loader_load(ResourceStorage* storage, Font* font, const NBRFont* nbr_font) {
+  NIKOLA_ASSERT(storage, "Cannot load with an invalid ResourceStorage");
+  NIKOLA_ASSERT(font, "Invalid Font passed into font loader function");
+  NIKOLA_ASSERT(nbr_font, "Invalid NBRFont passed into font loader function");
+  NIKOLA_ASSERT((nbr_font->glyphs_count > 0), "Cannot load a font without any glyphs");
+
+  // Metrics init
+  font->base_size      = nbr_font->base_size;
+  font->ascent         = nbr_font->ascent;
+  font->descent        = nbr_font->descent;
+  font->line_gap       = nbr_font->line_gap;
+  font->distance_range = nbr_font->distance_range;
+
+  load_atlas(storage, font, nbr_font);
+  load_glyphs(font, nbr_font);
+  load_kernings(font, nbr_font);
+}
+
+/// Font loader functions
+///---------------------------------------------------------------------------------------------------------------------
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "nikola/nikola_engine.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace nikola { // Start of nikola
+
+void font_loader_load(ResourceStorage* storage, Font* font, const NBRFont* nbr_font);
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////
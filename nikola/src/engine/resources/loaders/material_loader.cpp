@@ -33,6 +33,11 @@ void material_loader_load(ResourceStorage* storage,
   mat->specular_color = Vec3(1.0f); 
   mat->model_matrix   = Mat4(1.0f);
 
+  // No uniforms are used until the shader says otherwise
+  for(sizei i = 0; i < MATERIAL_UNIFORMS_MAX; i++) {
+    mat->uniform_locations[i] = -1;
+  }
+
   // The values below can only be set if the shader is active
   if(shader_id == INVALID_RESOURCE) {
     return;
@@ -46,28 +51,19 @@ void material_loader_load(ResourceStorage* storage,
   GfxBuffer* matrix_buffer = (GfxBuffer*)renderer_default_matrices_buffer();
   material_set_uniform_buffer(mat, MATERIAL_MATRICES_BUFFER_INDEX, matrix_buffer);
   
-  // Reserve some space for the map
-  mat->uniform_locations.reserve(MATERIAL_UNIFORMS_MAX);
-
-  // All the current valid uniform names
+  // All the current valid uniform names, in the order of `MaterialSlot`
   const i8* uniform_names[MATERIAL_UNIFORMS_MAX] = {
     MATERIAL_UNIFORM_AMBIENT_COLOR, 
     MATERIAL_UNIFORM_DIFFUSE_COLOR,
     MATERIAL_UNIFORM_SPECULAR_COLOR,
     MATERIAL_UNIFORM_MODEL_MATRIX,
+    MATERIAL_UNIFORM_DIFFUSE_LAYER,
+    MATERIAL_UNIFORM_SPECULAR_LAYER,
   };
   
-  // Adding only the valid uniforms in the shader
+  // Resolve every slot once. Uniforms the shader does not have will stay at `-1`.
   for(sizei i = 0; i < MATERIAL_UNIFORMS_MAX; i++) {
-    i32 location = gfx_glsl_get_uniform_location(mat->shader, uniform_names[i]);
-    
-    // The uniform does not exist
-    if(location == -1) {
-      continue;
-    } 
-
-    // Otherwise, add it to the cached list of locations
-    mat->uniform_locations[uniform_names[i]] = location;
+    mat->uniform_locations[i] = gfx_glsl_get_uniform_location(mat->shader, uniform_names[i]);
   }
 }
 
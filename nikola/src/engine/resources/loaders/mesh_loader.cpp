@@ -132,6 +132,7 @@ static void create_cube_mesh(ResourceStorage* storage, Mesh* mesh) {
   ResourceID index_id = resource_storage_push_buffer(storage, index_buff);
 
   mesh_loader_load(storage, mesh, vert_id, VERTEX_TYPE_PNUV, index_id, indices.size());
+  mesh_loader_compute_bounds(mesh, VERTEX_TYPE_PNUV, vertices.data(), vertices.size());
 }
 
 /// Private functions  
@@ -147,6 +148,26 @@ void mesh_loader_load(ResourceStorage* storage,
                       const ResourceID& index_buffer_id, 
                       const sizei indices_count) {
   NIKOLA_ASSERT(storage, "Cannot load with an invalid ResourceStorage");
+  NIKOLA_ASSERT((vertex_buffer_id != INVALID_RESOURCE), "Cannot load a mesh with an invalid vertex buffer ID");
+
+  // Calculate the number of vertices in the vertex buffer
+  GfxBuffer* vertex_buffer = resource_storage_get_buffer(storage, vertex_buffer_id);
+  sizei vertices_count     = (gfx_buffer_get_desc(vertex_buffer).size / get_vertex_type_size(vertex_type));  
+
+  // The mesh owns the whole buffers
+  mesh_loader_load(storage, mesh, vertex_buffer_id, vertex_type, 0, vertices_count, index_buffer_id, 0, indices_count);
+}
+
+void mesh_loader_load(ResourceStorage* storage, 
+                      Mesh* mesh, 
+                      const ResourceID& vertex_buffer_id, 
+                      const VertexType vertex_type, 
+                      const sizei vertices_offset, 
+                      const sizei vertices_count, 
+                      const ResourceID& index_buffer_id, 
+                      const sizei indices_offset, 
+                      const sizei indices_count) {
+  NIKOLA_ASSERT(storage, "Cannot load with an invalid ResourceStorage");
   NIKOLA_ASSERT(mesh, "Invalid Mesh passed to mesh loader function");
   NIKOLA_ASSERT((vertex_buffer_id != INVALID_RESOURCE), "Cannot load a mesh with an invalid vertex buffer ID");
   
@@ -155,20 +176,23 @@ void mesh_loader_load(ResourceStorage* storage,
   mesh->pipe_desc = {}; 
 
   // Vertex buffer init 
-  mesh->vertex_buffer            = resource_storage_get_buffer(storage, vertex_buffer_id);
-  mesh->pipe_desc.vertex_buffer  = mesh->vertex_buffer;
-
-  // Calculate the number of vertices in the vertex buffer
-  sizei vert_buff_size           = gfx_buffer_get_desc(mesh->pipe_desc.vertex_buffer).size;
-  mesh->pipe_desc.vertices_count = (vert_buff_size / get_vertex_type_size(vertex_type));  
+  mesh->vertex_buffer             = resource_storage_get_buffer(storage, vertex_buffer_id);
+  mesh->pipe_desc.vertex_buffer   = mesh->vertex_buffer;
+  mesh->pipe_desc.vertices_offset = vertices_offset;
+  mesh->pipe_desc.vertices_count  = vertices_count;
   
   // Index buffer init (only if available)
   if(index_buffer_id != INVALID_RESOURCE) {
-    mesh->index_buffer            = resource_storage_get_buffer(storage, index_buffer_id);
-    mesh->pipe_desc.index_buffer  = mesh->index_buffer;
-    mesh->pipe_desc.indices_count = indices_count;  
+    mesh->index_buffer             = resource_storage_get_buffer(storage, index_buffer_id);
+    mesh->pipe_desc.index_buffer   = mesh->index_buffer;
+    mesh->pipe_desc.indices_offset = indices_offset;  
+    mesh->pipe_desc.indices_count  = indices_count;  
   }
 
+  // The full mesh is always the first level of detail
+  mesh->lods[0]    = Mesh::LOD{indices_offset, indices_count};
+  mesh->lods_count = 1;
+
   // Layout init
   get_layout_from_vertex_type(vertex_type, mesh->pipe_desc);
   
@@ -190,6 +214,37 @@ void mesh_loader_load(ResourceStorage* storage, Mesh* mesh, const MeshType type)
   }
 }
 
+const sizei mesh_loader_get_vertex_size(const VertexType type) {
+  return get_vertex_type_size(type);
+}
+
+void mesh_loader_compute_bounds(Mesh* mesh, const VertexType vertex_type, const void* vertices, const sizei vertices_count) {
+  NIKOLA_ASSERT(mesh, "Invalid Mesh passed to mesh loader function");
+
+  if(!vertices || vertices_count == 0) {
+    mesh->has_bounds = false;
+    return;
+  }
+  
+  // Every vertex type starts with the position
+  sizei stride    = get_vertex_type_size(vertex_type);
+  const u8* bytes = (const u8*)vertices;
+
+  Vec3 min = *(const Vec3*)bytes; 
+  Vec3 max = min;
+
+  for(sizei i = 1; i < vertices_count; i++) {
+    const Vec3& pos = *(const Vec3*)(bytes + (i * stride));
+
+    min = Vec3(pos.x < min.x ? pos.x : min.x, pos.y < min.y ? pos.y : min.y, pos.z < min.z ? pos.z : min.z);
+    max = Vec3(pos.x > max.x ? pos.x : max.x, pos.y > max.y ? pos.y : max.y, pos.z > max.z ? pos.z : max.z);
+  }
+
+  mesh->bounds_min = min;
+  mesh->bounds_max = max;
+  mesh->has_bounds = true;
+}
+
 /// Mesh loader functions
 /// ----------------------------------------------------------------------
 
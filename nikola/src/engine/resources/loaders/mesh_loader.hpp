@@ -15,6 +15,20 @@ void mesh_loader_load(ResourceStorage* storage,
 
 void mesh_loader_load(ResourceStorage* storage, Mesh* mesh, const MeshType type);
 
+void mesh_loader_load(ResourceStorage* storage, 
+                      Mesh* mesh, 
+                      const ResourceID& vertex_buffer_id, 
+                      const VertexType vertex_type, 
+                      const sizei vertices_offset, 
+                      const sizei vertices_count, 
+                      const ResourceID& index_buffer_id, 
+                      const sizei indices_offset, 
+                      const sizei indices_count);
+
+const sizei mesh_loader_get_vertex_size(const VertexType type);
+
+void mesh_loader_compute_bounds(Mesh* mesh, const VertexType vertex_type, const void* vertices, const sizei vertices_count);
+
 } // End of nikola
 
 //////////////////////////////////////////////////////////////////////////
@@ -9,25 +9,32 @@ namespace nikola {
 /// Private functions
 
 static void check_and_send_uniform(Material* mat, const i8* name, GfxLayoutType type, const void* data) {
-  // Send the uniform (only if it is valid)
-  if(mat->uniform_locations.find(name) != mat->uniform_locations.end()) {
-    gfx_glsl_upload_uniform(mat->shader, mat->uniform_locations[name], type, data);
-    return;
-  }
- 
-  // Get the new uniform location
+  // The shader already knows all of its uniforms, so this is just a lookup
   i32 location = gfx_glsl_get_uniform_location(mat->shader, name);
   
   // The uniform just does not exist in the shader at all 
-  if(location != -1) {
+  if(location == -1) {
     NIKOLA_LOG_WARN("Could not find uniform \'%s\' in material", name);
     return;
   }
   
-  // Uniform does not exist. Cache it instead.
-  mat->uniform_locations[name] = location; 
   gfx_glsl_upload_uniform(mat->shader, location, type, data);
-  NIKOLA_LOG_DEBUG("Cache uniform \'%s\' in material...", name);
+}
+
+static void send_slot_uniform(Material* mat, GfxCommandList* list, const MaterialSlot slot, GfxLayoutType type, const void* data) {
+  i32 location = mat->uniform_locations[slot];
+
+  // The shader does not use this uniform (or has it in a uniform block)
+  if(location == -1) {
+    return;
+  }
+
+  if(list) {
+    gfx_command_list_upload_uniform(list, mat->shader, location, type, data);
+    return;
+  }
+
+  gfx_glsl_upload_uniform(mat->shader, location, type, data);
 }
 
 /// Private functions
@@ -86,15 +93,17 @@ void material_set_uniform_buffer(Material* mat, const sizei index, GfxBuffer* bu
   gfx_shader_attach_uniform(mat->shader, GFX_SHADER_VERTEX, mat->uniform_buffers[index], index);
 }
 
-void material_use(Material* mat) {
+void material_use(Material* mat, GfxCommandList* list) {
   NIKOLA_ASSERT(mat, "Invalid Material passed");
   NIKOLA_ASSERT(mat->shader, "Invalid Material's shader");
 
   // Send all of the available uniforms
-  check_and_send_uniform(mat, MATERIAL_UNIFORM_AMBIENT_COLOR, GFX_LAYOUT_FLOAT3, &mat->ambient_color[0]);
-  check_and_send_uniform(mat, MATERIAL_UNIFORM_DIFFUSE_COLOR, GFX_LAYOUT_FLOAT3, &mat->diffuse_color[0]);
-  check_and_send_uniform(mat, MATERIAL_UNIFORM_SPECULAR_COLOR, GFX_LAYOUT_FLOAT3, &mat->specular_color[0]);
-  check_and_send_uniform(mat, MATERIAL_UNIFORM_MODEL_MATRIX, GFX_LAYOUT_MAT4, mat4_raw_data(mat->model_matrix));
+  send_slot_uniform(mat, list, MATERIAL_SLOT_AMBIENT_COLOR, GFX_LAYOUT_FLOAT3, &mat->ambient_color[0]);
+  send_slot_uniform(mat, list, MATERIAL_SLOT_DIFFUSE_COLOR, GFX_LAYOUT_FLOAT3, &mat->diffuse_color[0]);
+  send_slot_uniform(mat, list, MATERIAL_SLOT_SPECULAR_COLOR, GFX_LAYOUT_FLOAT3, &mat->specular_color[0]);
+  send_slot_uniform(mat, list, MATERIAL_SLOT_MODEL_MATRIX, GFX_LAYOUT_MAT4, mat4_raw_data(mat->model_matrix));
+  send_slot_uniform(mat, list, MATERIAL_SLOT_DIFFUSE_LAYER, GFX_LAYOUT_INT1, &mat->diffuse_layer);
+  send_slot_uniform(mat, list, MATERIAL_SLOT_SPECULAR_LAYER, GFX_LAYOUT_INT1, &mat->specular_layer);
 }
 
 /// Material functions
@@ -16,7 +16,7 @@ static bool check_nbr_validity(NBRFile& file, const FilePath& path) {
   }  
 
   // Check for the validity of the versions
-  bool is_valid_version = ((file.major_version == NBR_VALID_MAJOR_VERSION) || (file.minor_version == NBR_VALID_MINOR_VERSION));
+  bool is_valid_version = ((file.major_version == NBR_VALID_MAJOR_VERSION) && (file.minor_version == NBR_VALID_MINOR_VERSION));
   if(!is_valid_version) {
     NIKOLA_LOG_ERROR("Invalid version found in NBR file at \'%s\'", path.c_str());
     return false;
@@ -50,10 +50,14 @@ static void write_texture(NBRFile& nbr, const NBRTexture& texture) {
   
   // Save the channels
   file_write_bytes(nbr.file_handle, &texture.channels, sizeof(texture.channels));
+  
+  // Save the format and the mip levels
+  file_write_bytes(nbr.file_handle, &texture.format, sizeof(texture.format));
+  file_write_bytes(nbr.file_handle, &texture.mips, sizeof(texture.mips));
  
   // Save the pixels
-  sizei data_size = (texture.width * texture.height) * texture.channels;
-  file_write_bytes(nbr.file_handle, texture.pixels, data_size);
+  file_write_bytes(nbr.file_handle, &texture.data_size, sizeof(texture.data_size));
+  file_write_bytes(nbr.file_handle, texture.pixels, texture.data_size);
 }
 
 static void write_cubemap(NBRFile& nbr, const NBRCubemap& cubemap) {
@@ -117,6 +121,10 @@ static void write_mesh(NBRFile& nbr, const NBRMesh& mesh) {
 
   // Save the material index
   file_write_bytes(nbr.file_handle, &mesh.material_index, sizeof(u8));
+
+  // Save the levels of detail
+  file_write_bytes(nbr.file_handle, &mesh.lods_count, sizeof(u8));
+  file_write_bytes(nbr.file_handle, mesh.lod_indices_counts, sizeof(u32) * mesh.lods_count);
 }
 
 static void write_model(NBRFile& nbr, const NBRModel& model) {
@@ -139,6 +147,30 @@ static void write_model(NBRFile& nbr, const NBRModel& model) {
   }
 }
 
+static void write_font(NBRFile& nbr, const NBRFont& font) {
+  // Save the metrics
+  file_write_bytes(nbr.file_handle, &font.base_size, sizeof(f32));
+  file_write_bytes(nbr.file_handle, &font.ascent, sizeof(f32));
+  file_write_bytes(nbr.file_handle, &font.descent, sizeof(f32));
+  file_write_bytes(nbr.file_handle, &font.line_gap, sizeof(f32));
+  file_write_bytes(nbr.file_handle, &font.distance_range, sizeof(f32));
+
+  // Save the glyphs
+  file_write_bytes(nbr.file_handle, &font.glyphs_count, sizeof(u16));
+  file_write_bytes(nbr.file_handle, font.glyphs, sizeof(NBRGlyph) * font.glyphs_count);
+
+  // Save the kerning pairs
+  file_write_bytes(nbr.file_handle, &font.kernings_count, sizeof(u32));
+  if(font.kernings_count > 0) {
+    file_write_bytes(nbr.file_handle, font.kernings, sizeof(NBRKerning) * font.kernings_count);
+  }
+
+  // Save the atlas
+  file_write_bytes(nbr.file_handle, &font.atlas_width, sizeof(u32));
+  file_write_bytes(nbr.file_handle, &font.atlas_height, sizeof(u32));
+  file_write_bytes(nbr.file_handle, font.atlas_pixels, font.atlas_width * font.atlas_height);
+}
+
 static void read_texture(NBRFile& nbr, NBRTexture* texture) {
   // Load the width and height 
   file_read_bytes(nbr.file_handle, &texture->width, sizeof(texture->width));  
@@ -146,11 +178,15 @@ static void read_texture(NBRFile& nbr, NBRTexture* texture) {
   
   // Load the channels
   file_read_bytes(nbr.file_handle, &texture->channels, sizeof(texture->channels));  
+  
+  // Load the format and the mip levels
+  file_read_bytes(nbr.file_handle, &texture->format, sizeof(texture->format));  
+  file_read_bytes(nbr.file_handle, &texture->mips, sizeof(texture->mips));  
 
   // Load the pixels
-  sizei data_size = (texture->width * texture->height) * texture->channels;
-  texture->pixels  = memory_allocate(data_size);
-  file_read_bytes(nbr.file_handle, texture->pixels, data_size);
+  file_read_bytes(nbr.file_handle, &texture->data_size, sizeof(texture->data_size));  
+  texture->pixels = memory_allocate(texture->data_size);
+  file_read_bytes(nbr.file_handle, texture->pixels, texture->data_size);
 }
 
 static void read_cubemap(NBRFile& nbr, NBRCubemap* cubemap) {
@@ -223,6 +259,11 @@ static void read_mesh(NBRFile& nbr, NBRMesh* mesh) {
 
   // Load the material index
   file_read_bytes(nbr.file_handle, &mesh->material_index, sizeof(u8));
+
+  // Load the levels of detail
+  file_read_bytes(nbr.file_handle, &mesh->lods_count, sizeof(u8));
+  mesh->lod_indices_counts = (u32*)memory_allocate(sizeof(u32) * mesh->lods_count); 
+  file_read_bytes(nbr.file_handle, mesh->lod_indices_counts, sizeof(u32) * mesh->lods_count);
 }
 
 static void read_model(NBRFile& nbr, NBRModel* model) {
@@ -248,6 +289,37 @@ static void read_model(NBRFile& nbr, NBRModel* model) {
   }
 }
 
+static void read_font(NBRFile& nbr, NBRFont* font) {
+  // Load the metrics
+  file_read_bytes(nbr.file_handle, &font->base_size, sizeof(f32));
+  file_read_bytes(nbr.file_handle, &font->ascent, sizeof(f32));
+  file_read_bytes(nbr.file_handle, &font->descent, sizeof(f32));
+  file_read_bytes(nbr.file_handle, &font->line_gap, sizeof(f32));
+  file_read_bytes(nbr.file_handle, &font->distance_range, sizeof(f32));
+
+  // Load the glyphs
+  file_read_bytes(nbr.file_handle, &font->glyphs_count, sizeof(u16));
+  font->glyphs = (NBRGlyph*)memory_allocate(sizeof(NBRGlyph) * font->glyphs_count);
+  file_read_bytes(nbr.file_handle, font->glyphs, sizeof(NBRGlyph) * font->glyphs_count);
+
+  // Load the kerning pairs
+  file_read_bytes(nbr.file_handle, &font->kernings_count, sizeof(u32));
+  font->kernings = nullptr;
+
+  if(font->kernings_count > 0) {
+    font->kernings = (NBRKerning*)memory_allocate(sizeof(NBRKerning) * font->kernings_count);
+    file_read_bytes(nbr.file_handle, font->kernings, sizeof(NBRKerning) * font->kernings_count);
+  }
+
+  // Load the atlas
+  file_read_bytes(nbr.file_handle, &font->atlas_width, sizeof(u32));
+  file_read_bytes(nbr.file_handle, &font->atlas_height, sizeof(u32));
+
+  sizei atlas_size   = font->atlas_width * font->atlas_height;
+  font->atlas_pixels = (u8*)memory_allocate(atlas_size);
+  file_read_bytes(nbr.file_handle, font->atlas_pixels, atlas_size);
+}
+
 static void load_texture(NBRFile& nbr) {
   // Read the resource from the file 
   NBRTexture texture; 
@@ -288,6 +360,16 @@ static void load_model(NBRFile& nbr) {
   memory_copy(nbr.body_data, &model, sizeof(model)); 
 }
 
+static void load_font(NBRFile& nbr) {
+  // Read the resource from the file 
+  NBRFont font; 
+  read_font(nbr, &font);
+
+  // Allocate some space for the resource and assign it
+  nbr.body_data = memory_allocate(sizeof(font));
+  memory_copy(nbr.body_data, &font, sizeof(font)); 
+}
+
 static void unload_texture(NBRFile& nbr) {
   NBRTexture* tex = (NBRTexture*)nbr.body_data;
   memory_free(tex->pixels);
@@ -314,6 +396,7 @@ static void unload_model(NBRFile& nbr) {
   for(sizei i = 0; i < model->meshes_count; i++) {
     memory_free(model->meshes[i].vertices);
     memory_free(model->meshes[i].indices);
+    memory_free(model->meshes[i].lod_indices_counts);
   }
 
   for(sizei i = 0; i < model->textures_count; i++) {
@@ -325,6 +408,16 @@ static void unload_model(NBRFile& nbr) {
   memory_free(model->textures);
 }
 
+static void unload_font(NBRFile& nbr) {
+  NBRFont* font = (NBRFont*)nbr.body_data;
+
+  memory_free(font->glyphs);
+  if(font->kernings) {
+    memory_free(font->kernings);
+  }
+  memory_free(font->atlas_pixels);
+}
+
 static void load_by_type(NBRFile& nbr, const FilePath& path) {
   switch(nbr.resource_type) {
     case RESOURCE_TYPE_TEXTURE:
@@ -340,6 +433,7 @@ static void load_by_type(NBRFile& nbr, const FilePath& path) {
       load_model(nbr);
       break;
     case RESOURCE_TYPE_FONT:
+      load_font(nbr);
       break;
     default:
       NIKOLA_LOG_ERROR("Cannot load specified resource type at NBR file \'%s\'", path.c_str());
@@ -362,6 +456,7 @@ static void unload_by_type(NBRFile& nbr) {
       unload_model(nbr);
       break;
     case RESOURCE_TYPE_FONT:
+      unload_font(nbr);
       break;
     default:
       break;
@@ -397,6 +492,14 @@ static i32 get_texture_channels(GfxTextureFormat format) {
       return 4;
     case GFX_TEXTURE_FORMAT_DEPTH_STENCIL_24_8:
       return 2;
+    case GFX_TEXTURE_FORMAT_BC4:
+      return 1;
+    case GFX_TEXTURE_FORMAT_BC5:
+      return 2;
+    case GFX_TEXTURE_FORMAT_BC1:
+    case GFX_TEXTURE_FORMAT_BC3:
+    case GFX_TEXTURE_FORMAT_BC7:
+      return 4;
   } 
 }
 
@@ -515,6 +618,23 @@ void nbr_file_save(NBRFile& nbr, const NBRModel& model, const FilePath& path) {
   file_close(nbr.file_handle);
 }
 
+void nbr_file_save(NBRFile& nbr, const NBRFont& font, const FilePath& path) {
+  // Must open the file
+  if(!open_for_save(nbr, path)) {
+    return;
+  }
+
+  // Save the header first
+  nbr.resource_type = (i16)RESOURCE_TYPE_FONT; 
+  save_header(nbr);
+
+  // Write the font 
+  write_font(nbr, font);
+
+  // Always remember to close the file
+  file_close(nbr.file_handle);
+}
+
 /// NBR (Nikola Binary Resource) functions
 ///---------------------------------------------------------------------------------------------------------------------
 
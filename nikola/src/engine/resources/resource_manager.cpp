@@ -4,6 +4,7 @@
 #include "loaders/mesh_loader.hpp"
 #include "loaders/material_loader.hpp"
 #include "loaders/skybox_loader.hpp"
+#include "loaders/font_loader.hpp"
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -24,6 +25,23 @@ static StorageManager s_manager;
 /// StorageManager 
 /// ----------------------------------------------------------------------
 
+/// ----------------------------------------------------------------------
+/// GeometryPage 
+struct GeometryPage {
+  VertexType vertex_type;
+
+  ResourceID vertex_buffer_id;
+  ResourceID index_buffer_id;
+
+  sizei vertices_used = 0;
+  sizei vertices_max  = 0;
+  
+  sizei indices_used  = 0;
+  sizei indices_max   = 0;
+};
+/// GeometryPage 
+/// ----------------------------------------------------------------------
+
 /// ----------------------------------------------------------------------
 /// ResourceStorage 
 struct ResourceStorage {
@@ -40,6 +58,8 @@ struct ResourceStorage {
   HashMap<ResourceID, Skybox*> skyboxes;
   HashMap<ResourceID, Model*> models;
   HashMap<ResourceID, Font*> fonts;
+
+  DynamicArray<GeometryPage> geometry_pages;
 };
 /// ResourceStorage 
 /// ----------------------------------------------------------------------
@@ -90,6 +110,8 @@ static const char* texture_type_str(const GfxTextureType type) {
       return "GFX_TEXTURE_RENDER_TARGET";
     case GFX_TEXTURE_DEPTH_STENCIL_TARGET:
       return "GFX_TEXTURE_DEPTH_STENCIL_TARGET";
+    case GFX_TEXTURE_2D_ARRAY:
+      return "GFX_TEXTURE_2D_ARRAY";
     default:
       return "INVALID TEXTURE TYPE";
   }
@@ -141,11 +163,19 @@ static void convert_from_nbr(const NBRTexture* nbr, GfxTextureDesc* desc) {
   desc->width  = nbr->width; 
   desc->height = nbr->height; 
   desc->depth  = 0; 
-  desc->mips   = 1; 
   desc->type   = GFX_TEXTURE_2D; 
-  desc->data   = memory_allocate(nbr->width * nbr->height * nbr->channels);
+  desc->data   = memory_allocate(nbr->data_size);
+
+  // Use the baked mips if there are any. Otherwise, generate a full mip chain.
+  desc->mips          = nbr->mips > 1 ? nbr->mips : 0;
+  desc->data_has_mips = nbr->mips > 1;
 
-  memory_copy(desc->data, nbr->pixels, nbr->width * nbr->height * nbr->channels);
+  // Pre-compressed blocks can only be read as their own format
+  if(nbr->format != GFX_TEXTURE_FORMAT_RGBA8) {
+    desc->format = nbr->format;
+  }
+
+  memory_copy(desc->data, nbr->pixels, nbr->data_size);
 }
 
 static void convert_from_nbr(const NBRCubemap* nbr, GfxCubemapDesc* desc) {
@@ -159,23 +189,125 @@ static void convert_from_nbr(const NBRCubemap* nbr, GfxCubemapDesc* desc) {
   }
 }
 
-static void convert_from_nbr(ResourceStorage* storage, const NBRModel* nbr, Model* model) {
+static void pack_model_textures(ResourceStorage* storage, const NBRModel* nbr, DynamicArray<ResourceID>& texture_ids, DynamicArray<i32>& texture_layers) {
+  for(sizei i = 0; i < nbr->textures_count; i++) {
+    const NBRTexture& first = nbr->textures[i];
+
+    // Already packed, or has baked mips which cannot be uploaded per layer
+    if(texture_ids[i] != INVALID_RESOURCE || first.mips > 1) {
+      continue;
+    }
+
+    // Gather every texture that can share the same array
+    DynamicArray<sizei> layers;
+    for(sizei j = i; j < nbr->textures_count; j++) {
+      const NBRTexture& other = nbr->textures[j];
+
+      if(texture_ids[j] == INVALID_RESOURCE && other.mips <= 1 && 
+         other.width == first.width && other.height == first.height && other.format == first.format) {
+        layers.push_back(j);
+      }
+    }
+
+    // Not worth an array
+    if(layers.size() < 2) {
+      continue;
+    }
+
+    GfxTextureDesc desc = {
+      .width     = first.width, 
+      .height    = first.height,
+      .depth     = (u32)layers.size(),
+      .mips      = 0,
+      .type      = GFX_TEXTURE_2D_ARRAY,
+      .format    = first.format, 
+      .filter    = GFX_TEXTURE_FILTER_MIN_TRILINEAR_MAG_NEAREST, 
+      .wrap_mode = GFX_TEXTURE_WRAP_MIRROR,
+      .data      = nullptr,
+    };
+    ResourceID array_id = resource_storage_push_texture(storage, desc);
+    GfxTexture* array   = resource_storage_get_texture(storage, array_id);
+
+    for(sizei layer = 0; layer < layers.size(); layer++) {
+      gfx_texture_update(array, (u32)layer, nbr->textures[layers[layer]].pixels);
+
+      texture_ids[layers[layer]]    = array_id;
+      texture_layers[layers[layer]] = (i32)layer;
+    }
+  }
+}
+
+static sizei acquire_geometry_page(ResourceStorage* storage, const VertexType type, const sizei vertices_count, const sizei indices_count) {
+  // Find a page with enough room left
+  for(sizei i = 0; i < storage->geometry_pages.size(); i++) {
+    GeometryPage& page = storage->geometry_pages[i];
+    
+    if(page.vertex_type != type) {
+      continue;
+    }
+
+    if(((page.vertices_used + vertices_count) <= page.vertices_max) && ((page.indices_used + indices_count) <= page.indices_max)) {
+      return i;
+    }
+  }
+
+  // Start a new page. 
+  // Meshes too big for a regular page get a page of their own.
+  GeometryPage page; 
+  page.vertex_type  = type;
+  page.vertices_max = GEOMETRY_VERTEX_BUFFER_SIZE / mesh_loader_get_vertex_size(type);
+  page.indices_max  = GEOMETRY_INDEX_BUFFER_SIZE / sizeof(u32);
+
+  page.vertices_max = vertices_count > page.vertices_max ? vertices_count : page.vertices_max;
+  page.indices_max  = indices_count > page.indices_max ? indices_count : page.indices_max;
+
+  GfxBufferDesc buff_desc = {
+    .data  = nullptr,
+    .size  = page.vertices_max * mesh_loader_get_vertex_size(type), 
+    .type  = GFX_BUFFER_VERTEX, 
+    .usage = GFX_BUFFER_USAGE_STATIC_DRAW,
+  };
+  page.vertex_buffer_id = resource_storage_push_buffer(storage, buff_desc);
+  
+  buff_desc = {
+    .data  = nullptr,
+    .size  = page.indices_max * sizeof(u32), 
+    .type  = GFX_BUFFER_INDEX, 
+    .usage = GFX_BUFFER_USAGE_STATIC_DRAW,
+  };
+  page.index_buffer_id = resource_storage_push_buffer(storage, buff_desc);
+
+  storage->geometry_pages.push_back(page);
+  return storage->geometry_pages.size() - 1;
+}
+
+static void convert_from_nbr(ResourceStorage* storage, const NBRModel* nbr, Model* model, const bool pack_textures) {
   // Make some space for the arrays for some better performance  
   model->meshes.reserve(nbr->meshes_count);
   model->materials.reserve(nbr->materials_count);
   model->material_indices.reserve(nbr->meshes_count);
   
-  nikola::DynamicArray<ResourceID> texture_ids; // @FIX (Resource): This is bad. Don't do this!
+  nikola::DynamicArray<ResourceID> texture_ids(nbr->textures_count, INVALID_RESOURCE); // @FIX (Resource): This is bad. Don't do this!
+  nikola::DynamicArray<i32> texture_layers(nbr->textures_count, 0);
+
+  // Pack what we can into arrays first
+  if(pack_textures) {
+    pack_model_textures(storage, nbr, texture_ids, texture_layers);
+  }
 
-  // Convert the textures
+  // Convert the rest of the textures
   for(sizei i = 0; i < nbr->textures_count; i++) {
+    if(texture_ids[i] != INVALID_RESOURCE) {
+      continue;
+    }
+
     GfxTextureDesc desc; 
     desc.format    = GFX_TEXTURE_FORMAT_RGBA8; 
-    desc.filter    = GFX_TEXTURE_FILTER_MIN_MAG_NEAREST; 
+    desc.filter    = GFX_TEXTURE_FILTER_MIN_TRILINEAR_MAG_NEAREST; 
     desc.wrap_mode = GFX_TEXTURE_WRAP_MIRROR;
     convert_from_nbr(&nbr->textures[i], &desc);
   
-    texture_ids.push_back(resource_storage_push_texture(storage, desc));
+    texture_ids[i] = resource_storage_push_texture(storage, desc);
   }
 
   // Convert the material 
@@ -191,6 +323,10 @@ static void convert_from_nbr(ResourceStorage* storage, const NBRModel* nbr, Mode
     ResourceID mat_id = resource_storage_push_material(storage, diffuse_id, specular_id);
     Material* mat     = resource_storage_get_material(storage, mat_id);
 
+    // Where the maps live if they were packed into arrays
+    mat->diffuse_layer  = texture_layers[nbr->materials[i].diffuse_index];
+    mat->specular_layer = nbr->materials[i].specular_index == 0 ? 0 : texture_layers[nbr->materials[i].specular_index];
+
     // Set the colors of the new material
     mat->ambient_color  = Vec4(nbr->materials[i].ambient[0], nbr->materials[i].ambient[1], nbr->materials[i].ambient[2], 1.0f); 
     mat->diffuse_color  = Vec4(nbr->materials[i].diffuse[0], nbr->materials[i].diffuse[1], nbr->materials[i].diffuse[2], 1.0f); 
@@ -202,30 +338,37 @@ static void convert_from_nbr(ResourceStorage* storage, const NBRModel* nbr, Mode
 
   // Convert the vertices 
   for(sizei i = 0; i < nbr->meshes_count; i++) {
-    // Create a vertex buffer
-    GfxBufferDesc buff_desc = {
-      .data  = (void*)nbr->meshes[i].vertices,
-      .size  = nbr->meshes[i].vertices_count * sizeof(f32), 
-      .type  = GFX_BUFFER_VERTEX, 
-      .usage = GFX_BUFFER_USAGE_STATIC_DRAW,
-    };
-    ResourceID vert_buff_id = resource_storage_push_buffer(storage, buff_desc);
-    
-    // Create a index buffer
-    buff_desc = {
-      .data  = (void*)nbr->meshes[i].indices,
-      .size  = nbr->meshes[i].indices_count * sizeof(u32), 
-      .type  = GFX_BUFFER_INDEX, 
-      .usage = GFX_BUFFER_USAGE_STATIC_DRAW,
-    };
-    ResourceID idx_buff_id = resource_storage_push_buffer(storage, buff_desc);
-    
-    // Create a new mesh 
-    ResourceID mesh_id = resource_storage_push_mesh(storage, vert_buff_id, (VertexType)nbr->meshes[i].vertex_type, idx_buff_id, nbr->meshes[i].indices_count);
-    model->meshes.push_back(storage->meshes[mesh_id]);
+    // Pack the mesh into the shared geometry buffers
+    ResourceID mesh_id = resource_storage_push_mesh(storage, 
+                                                    (VertexType)nbr->meshes[i].vertex_type, 
+                                                    nbr->meshes[i].vertices, 
+                                                    nbr->meshes[i].vertices_count * sizeof(f32), 
+                                                    nbr->meshes[i].indices, 
+                                                    nbr->meshes[i].indices_count, 
+                                                    nbr->meshes[i].lod_indices_counts, 
+                                                    nbr->meshes[i].lods_count);
+    Mesh* mesh         = storage->meshes[mesh_id];
+    model->meshes.push_back(mesh);
     
     // Add a new index
     model->material_indices.push_back(nbr->meshes[i].material_index);
+
+    // Grow the bounds of the model to fit the new mesh
+    if(!mesh->has_bounds) {
+      continue;
+    }
+
+    if(!model->has_bounds) {
+      model->bounds_min = mesh->bounds_min;
+      model->bounds_max = mesh->bounds_max;
+      model->has_bounds = true;
+      continue;
+    }
+
+    for(sizei j = 0; j < 3; j++) {
+      model->bounds_min[j] = mesh->bounds_min[j] < model->bounds_min[j] ? mesh->bounds_min[j] : model->bounds_min[j];
+      model->bounds_max[j] = mesh->bounds_max[j] > model->bounds_max[j] ? mesh->bounds_max[j] : model->bounds_max[j];
+    }
   }
 }
 
@@ -296,6 +439,8 @@ void resource_storage_clear(ResourceStorage* storage) {
   storage->skyboxes.clear();
   storage->models.clear();
   storage->fonts.clear();
+
+  storage->geometry_pages.clear();
   
   NIKOLA_LOG_INFO("Resource storage \'%s\' was successfully cleared", storage->name.c_str());
 }
@@ -313,6 +458,15 @@ void resource_storage_destroy(ResourceStorage* storage) {
   DESTROY_CORE_RESOURCE_MAP(storage, cubemaps, gfx_cubemap_destroy);
   DESTROY_CORE_RESOURCE_MAP(storage, shaders, gfx_shader_destroy);
 
+  // Let go of the vertex arrays the pipelines hold on to
+  for(auto& [key, value] : storage->meshes) {
+    gfx_pipeline_destroy(value->pipe);
+  }
+  
+  for(auto& [key, value] : storage->skyboxes) {
+    gfx_pipeline_destroy(value->pipe);
+  }
+
   // Destroy compound resources
   DESTROY_COMP_RESOURCE_MAP(storage, meshes);
   DESTROY_COMP_RESOURCE_MAP(storage, materials);
@@ -534,6 +688,92 @@ ResourceID resource_storage_push_mesh(ResourceStorage* storage, const MeshType t
   return id;
 }
 
+ResourceID resource_storage_push_mesh(ResourceStorage* storage, 
+                                      const VertexType vertex_type, 
+                                      const void* vertices, 
+                                      const sizei vertices_size, 
+                                      const u32* indices, 
+                                      const sizei indices_count, 
+                                      const u32* lod_indices_counts, 
+                                      const sizei lods_count) {
+  NIKOLA_ASSERT(storage, "Cannot push a resource to an invalid storage");
+  NIKOLA_ASSERT(vertices, "Cannot push a mesh with invalid vertices");
+  NIKOLA_ASSERT((lods_count == 0 || lod_indices_counts), "Cannot push a mesh with invalid levels of detail");
+
+  sizei vertex_size    = mesh_loader_get_vertex_size(vertex_type);
+  sizei vertices_count = vertices_size / vertex_size;
+
+  // Find some room for the mesh
+  sizei page_index   = acquire_geometry_page(storage, vertex_type, vertices_count, indices_count);
+  GeometryPage& page = storage->geometry_pages[page_index];
+
+  // Upload the geometry right after the last mesh in the page
+  GfxBuffer* vertex_buffer = resource_storage_get_buffer(storage, page.vertex_buffer_id);
+  gfx_buffer_update(vertex_buffer, page.vertices_used * vertex_size, vertices_size, vertices);
+
+  if(indices_count > 0) {
+    GfxBuffer* index_buffer = resource_storage_get_buffer(storage, page.index_buffer_id);
+    gfx_buffer_update(index_buffer, page.indices_used * sizeof(u32), indices_count * sizeof(u32), indices);
+  }
+
+  // Allocate the mesh
+  Mesh* mesh = new Mesh{};
+
+  // Use the loader to set up the mesh
+  //
+  // @NOTE: The indices stay relative to the mesh itself. The offset of 
+  // the vertices gets added as the base vertex of every draw.
+  mesh_loader_load(storage, 
+                   mesh, 
+                   page.vertex_buffer_id, 
+                   vertex_type, 
+                   page.vertices_used, 
+                   vertices_count, 
+                   indices_count > 0 ? page.index_buffer_id : INVALID_RESOURCE, 
+                   page.indices_used, 
+                   indices_count);
+
+  // Split the indices into the levels of detail
+  if(indices_count > 0 && lods_count > 0) {
+    sizei offset     = page.indices_used;
+    mesh->lods_count = 0;
+
+    for(sizei i = 0; i < lods_count && i < MESH_LODS_MAX; i++) {
+      NIKOLA_ASSERT(((offset - page.indices_used) + lod_indices_counts[i] <= indices_count), "Levels of detail outside the indices of the mesh");
+
+      mesh->lods[i] = Mesh::LOD{offset, lod_indices_counts[i]};
+      offset       += lod_indices_counts[i];
+
+      mesh->lods_count++;
+    }
+
+    // Only the full mesh gets drawn by default
+    mesh->pipe_desc.indices_count = mesh->lods[0].indices_count;
+  }
+
+  mesh_loader_compute_bounds(mesh, vertex_type, vertices, vertices_count);
+
+  page.vertices_used += vertices_count;
+  page.indices_used  += indices_count;
+
+  // Create the pipeline
+  mesh->pipe = gfx_pipeline_create(s_manager.gfx_context, mesh->pipe_desc);
+
+  // Create the mesh
+  mesh->storage_ref   = storage; 
+  ResourceID id       = generate_id();
+  storage->meshes[id] = mesh;
+
+  // New mesh added!
+  NIKOLA_LOG_INFO("Storage \'%s\' pushed mesh:", storage->name.c_str());
+  NIKOLA_LOG_INFO("     Vertex type  = %s", vertex_type_str(vertex_type));
+  NIKOLA_LOG_INFO("     Vertices     = %zu", vertices_count);
+  NIKOLA_LOG_INFO("     Indices      = %zu", indices_count);
+  NIKOLA_LOG_INFO("     LODs         = %i", mesh->lods_count);
+  NIKOLA_LOG_INFO("     Page         = %zu", page_index);
+  return id;
+}
+
 ResourceID resource_storage_push_material(ResourceStorage* storage,
                                           const ResourceID& diffuse_id, 
                                           const ResourceID& specular_id, 
@@ -551,9 +791,15 @@ ResourceID resource_storage_push_material(ResourceStorage* storage,
   ResourceID id          = generate_id();
   storage->materials[id] = material;
 
+  // Count the preset uniforms the shader actually uses
+  sizei uniforms_count = 0;
+  for(sizei i = 0; i < MATERIAL_UNIFORMS_MAX; i++) {
+    uniforms_count += material->uniform_locations[i] != -1 ? 1 : 0;
+  }
+
   // New material added
   NIKOLA_LOG_INFO("Storage \'%s\' pushed material:", storage->name.c_str());
-  NIKOLA_LOG_INFO("     Uniforms count = \'%zu\'", material->uniform_locations.size());
+  NIKOLA_LOG_INFO("     Uniforms count = \'%zu\'", uniforms_count);
   NIKOLA_LOG_INFO("     Ambient color  = \'%s\'", vec3_to_string(material->ambient_color).c_str());
   NIKOLA_LOG_INFO("     Diffuse color  = \'%s\'", vec3_to_string(material->diffuse_color).c_str());
   NIKOLA_LOG_INFO("     Specular color = \'%s\'", vec3_to_string(material->specular_color).c_str());
@@ -584,7 +830,7 @@ ResourceID resource_storage_push_skybox(ResourceStorage* storage, const Resource
   return id;
 }
 
-ResourceID resource_storage_push_model(ResourceStorage* storage, const FilePath& nbr_path) {
+ResourceID resource_storage_push_model(ResourceStorage* storage, const FilePath& nbr_path, const bool pack_textures) {
   NIKOLA_ASSERT(storage, "Cannot push a resource to an invalid storage");
   
   // Load the NBR file
@@ -596,7 +842,7 @@ ResourceID resource_storage_push_model(ResourceStorage* storage, const FilePath&
   
   // Convert the NBR format to a valid model
   NBRModel* nbr_model = (NBRModel*)nbr.body_data; 
-  convert_from_nbr(storage, nbr_model, model);
+  convert_from_nbr(storage, nbr_model, model, pack_textures);
 
   // New model added!
   model->storage_ref  = storage; 
@@ -614,6 +860,39 @@ ResourceID resource_storage_push_model(ResourceStorage* storage, const FilePath&
   return id;
 }
 
+ResourceID resource_storage_push_font(ResourceStorage* storage, const FilePath& nbr_path) {
+  NIKOLA_ASSERT(storage, "Cannot push a resource to an invalid storage");
+  
+  // Load the NBR file
+  NBRFile nbr;
+  nbr_file_load(&nbr, filepath_append(storage->parent_dir, nbr_path));
+
+  // Make sure it is the correct resource type
+  NIKOLA_ASSERT((nbr.resource_type == RESOURCE_TYPE_FONT), "Expected RESOURCE_TYPE_FONT");
+
+  // Allocate the font
+  Font* font = new Font{};
+  
+  // Convert the NBR format to a valid font
+  NBRFont* nbr_font = (NBRFont*)nbr.body_data; 
+  font_loader_load(storage, font, nbr_font);
+
+  // New font added!
+  font->storage_ref  = storage; 
+  ResourceID id      = generate_id();
+  storage->fonts[id] = font;
+
+  NIKOLA_LOG_INFO("Storage \'%s\' pushed font:", storage->name.c_str());
+  NIKOLA_LOG_INFO("     Glyphs   = %zu", font->glyphs.size());
+  NIKOLA_LOG_INFO("     Kernings = %zu", font->kernings.size());
+  NIKOLA_LOG_INFO("     Atlas    = %i X %i", nbr_font->atlas_width, nbr_font->atlas_height);
+  NIKOLA_LOG_INFO("     Path     = %s", nbr_path.c_str());
+
+  // Remember to close the NBR
+  nbr_file_unload(nbr);
+  return id;
+}
+
 GfxBuffer* resource_storage_get_buffer(ResourceStorage* storage, const ResourceID& id) {
   NIKOLA_ASSERT(storage, "Cannot push a resource to an invalid storage");
   NIKOLA_ASSERT((id != INVALID_RESOURCE), "Cannot retrieve an invalid resource");
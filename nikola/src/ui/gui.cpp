@@ -20,6 +20,7 @@ struct GUIState {
   ImGuiIO io_config;
 
   Vec4 render_clear_color = Vec4(0.1f, 0.1f, 0.1f, 1.0f);
+  f32 render_lod_bias     = 1.0f;
   
   f64 fps              = 0.0;
   IVec2 window_size    = IVec2(0); 
@@ -53,6 +54,13 @@ bool gui_init(Window* window) {
   // Dark mode WOOOOOOOAH! 
   ImGui::StyleColorsDark();
 
+#if defined(NIKOLA_GFX_CONTEXT_NULL)
+  // Headless runs have neither a window nor a GL context for the backends. 
+  // ImGui still gets to lay out every frame, it just never draws any of it.
+  ImGui::GetIO().Fonts->Build();
+  return true;
+#endif
+
   // Setting up the glfw backend
   if(!ImGui_ImplGlfw_InitForOpenGL((GLFWwindow*)window_get_handle(window), true)) {
     NIKOLA_LOG_ERROR("Failed to initialize GLFW for ImGui");
@@ -69,20 +77,38 @@ bool gui_init(Window* window) {
 }
 
 void gui_shutdown() {
+#ifndef NIKOLA_GFX_CONTEXT_NULL
   ImGui_ImplGlfw_Shutdown();
   ImGui_ImplOpenGL3_Shutdown();
+#endif
   ImGui::DestroyContext();
 }
 
 void gui_begin() {
+#if defined(NIKOLA_GFX_CONTEXT_NULL)
+  // What the backends would have filled in
+  ImGuiIO& io = ImGui::GetIO();
+  
+  i32 width, height;
+  window_get_size(s_gui.window, &width, &height);
+
+  f32 delta_time = (f32)niclock_get_delta_time();
+  io.DisplaySize = ImVec2((f32)width, (f32)height);
+  io.DeltaTime   = delta_time > 0.0f ? delta_time : (1.0f / 60.0f);
+#else
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplGlfw_NewFrame();
+#endif
+
   ImGui::NewFrame();
 }
 
 void gui_end() {
   ImGui::Render();
+
+#ifndef NIKOLA_GFX_CONTEXT_NULL
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+#endif
 }
 
 void gui_begin_panel(const char* name) {
@@ -162,6 +188,14 @@ void gui_settings_renderer() {
   // Stats
   // -------------------------------------------------------------------
   ImGui::SeparatorText("Stats");
+  ImGui::Text("Saved calls: %zu", gfx_context_get_saved_calls((GfxContext*)renderer_get_context()));
+  
+  RendererStats stats = renderer_get_stats();
+  ImGui::Text("Commands: %zu", stats.commands_count);
+  ImGui::Text("Culled: %zu", stats.culled_count);
+  ImGui::Text("Draws: %zu", stats.draws_count);
+  ImGui::Text("Lights: %zu", stats.lights_count);
+  ImGui::Text("Triangles: %zu", stats.triangles_count);
   // -------------------------------------------------------------------
  
   // Editables
@@ -169,6 +203,15 @@ void gui_settings_renderer() {
   ImGui::SeparatorText("##xx");
   ImGui::ColorPicker4("Clear color", &s_gui.render_clear_color[0], ImGuiColorEditFlags_NoSidePreview | ImGuiColorEditFlags_NoSmallPreview);
   renderer_set_clear_color(s_gui.render_clear_color);
+
+  bool is_deferred = (renderer_get_path() == RENDER_PATH_DEFERRED);
+  if(ImGui::Checkbox("Deferred shading", &is_deferred)) {
+    renderer_set_path(is_deferred ? RENDER_PATH_DEFERRED : RENDER_PATH_FORWARD);
+  }
+
+  if(ImGui::SliderFloat("LOD bias", &s_gui.render_lod_bias, 0.1f, 4.0f)) {
+    renderer_set_lod_bias(s_gui.render_lod_bias);
+  }
   // -------------------------------------------------------------------
 }
 
@@ -180,12 +180,14 @@ void app_render(nikola::App* app) {
   // Render the model
   rnd_cmd.render_type   = nikola::RENDERABLE_TYPE_MODEL; 
   rnd_cmd.renderable_id = app->model_id; 
+  rnd_cmd.object_id     = 1; // Only one model, so any stable id works
   nikola::renderer_queue_command(rnd_cmd);
   
   // Render the skybox 
   rnd_cmd.render_type   = nikola::RENDERABLE_TYPE_SKYBOX; 
   rnd_cmd.renderable_id = app->skybox_id; 
   rnd_cmd.material_id   = app->skybox_material_id; 
+  rnd_cmd.object_id     = 0;
   nikola::renderer_queue_command(rnd_cmd);
 
   // Render the objects
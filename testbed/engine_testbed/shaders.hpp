@@ -8,6 +8,7 @@ inline const char* default3d_shader() {
     "layout (location = 0) in vec3 aPos;\n"
     "layout (location = 1) in vec3 aNormal;\n"
     "layout (location = 2) in vec2 aTextureCoords;\n"
+    "layout (location = 3) in mat4 aInstanceModel;\n"
     "\n"
     "// Outputs\n"
     "out VS_OUT {\n"
@@ -17,12 +18,11 @@ inline const char* default3d_shader() {
     "layout (std140, binding = 0) uniform Matrices {\n"
     "  mat4 u_view_projection;\n"
     "};\n"
-    "uniform mat4 u_model;"
     "\n"
     "void main() {\n"
     "  vs_out.tex_coords = aTextureCoords;\n"
     "\n"
-    "  gl_Position = u_view_projection * u_model * vec4(aPos, 1.0f);\n"
+    "  gl_Position = u_view_projection * aInstanceModel * vec4(aPos, 1.0f);\n"
     "}"
     "\n"
     "#version 460 core\n"
@@ -0,0 +1,162 @@
+#include "test_common.hpp"
+
+#include "engine/renderer/batch_renderer.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// BatchDraws
+struct BatchDraws {
+  sizei draws_count     = 0;
+  sizei buffers_created = 0;
+
+  /// The amount of textures bound by the last applied pipeline.
+  u64 last_textures_count = 0;
+};
+/// BatchDraws
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static BatchDraws collect_draws(GfxContext* gfx) {
+  BatchDraws draws;
+
+  sizei count;
+  const GfxCallRecord* calls = gfx_context_get_call_log(gfx, &count);
+
+  for(sizei i = 0; i < count; i++) {
+    switch(calls[i].type) {
+      case GFX_CALL_CONTEXT_APPLY_PIPELINE:
+        draws.last_textures_count = calls[i].args[0];
+        break;
+      case GFX_CALL_PIPELINE_DRAW_INDEX:
+        draws.draws_count++;
+        break;
+      case GFX_CALL_BUFFER_CREATE:
+        draws.buffers_created++;
+        break;
+      default:
+        break;
+    }
+  }
+
+  gfx_context_clear_call_log(gfx);
+  return draws;
+}
+
+static GfxTexture* create_texture(GfxContext* gfx) {
+  GfxTextureDesc desc = {};
+  desc.width          = 4;
+  desc.height         = 4;
+  desc.mips           = 1;
+  desc.type           = GFX_TEXTURE_2D;
+  desc.format         = GFX_TEXTURE_FORMAT_RGBA8;
+
+  return gfx_texture_create(gfx, desc);
+}
+
+static void push_quads(const sizei count) {
+  for(sizei i = 0; i < count; i++) {
+    batch_renderer_quad(Vec2(0.0f), Vec2(1.0f), Vec4(1.0f));
+  }
+}
+
+static void test_textured_boundary(GfxContext* gfx, GfxTexture* texture) {
+  batch_renderer_begin(Mat4(1.0f));
+
+  // The textured quad does not fit in the full batch, so it must land in
+  // the next one along with its texture, and not in a slot that was just reset
+  push_quads(BATCH_QUADS_MAX);
+  batch_renderer_textured_quad(Vec2(0.0f), Vec2(1.0f), texture);
+  batch_renderer_flush();
+  batch_renderer_next_frame();
+
+  BatchDraws draws = collect_draws(gfx);
+  TEST_CHECK(draws.draws_count == 2);
+  TEST_CHECK(draws.last_textures_count == 2);
+}
+
+static void test_text_boundary(GfxContext* gfx, GfxTexture* atlas) {
+  Font font      = {};
+  font.base_size = 16.0f;
+  font.ascent    = 12.0f;
+  font.descent   = -4.0f;
+  font.atlas     = atlas;
+
+  for(i32 codepoint = 32; codepoint <= 126; codepoint++) {
+    Font::Glyph glyph  = {};
+    glyph.unicode      = codepoint;
+    glyph.texture_rect = Vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    glyph.size         = Vec2(8.0f);
+    glyph.advance_x    = 8.0f;
+
+    font.glyphs.push_back(glyph);
+  }
+
+  batch_renderer_begin(Mat4(1.0f));
+
+  // The batch fills up halfway through the string, so the rest of 
+  // the glyphs have to bind the atlas again in the next batch
+  push_quads(BATCH_QUADS_MAX - 2);
+  batch_renderer_text(&font, "abcd", Vec2(0.0f), 16.0f);
+  batch_renderer_flush();
+  batch_renderer_next_frame();
+
+  BatchDraws draws = collect_draws(gfx);
+  TEST_CHECK(draws.draws_count == 2);
+  TEST_CHECK(draws.last_textures_count == 2);
+}
+
+static void test_frame_pages(GfxContext* gfx) {
+  // More quads than one page holds spill over into new pages...
+  batch_renderer_begin(Mat4(1.0f));
+  push_quads((BATCH_QUADS_MAX * 5) / 2);
+  batch_renderer_flush();
+  batch_renderer_next_frame();
+
+  BatchDraws draws = collect_draws(gfx);
+  TEST_CHECK(draws.draws_count == 3);
+  TEST_CHECK(draws.buffers_created == 2);
+
+  // ...which are reused by any later frame
+  batch_renderer_begin(Mat4(1.0f));
+  push_quads((BATCH_QUADS_MAX * 5) / 2);
+  batch_renderer_flush();
+  batch_renderer_next_frame();
+
+  draws = collect_draws(gfx);
+  TEST_CHECK(draws.draws_count == 3);
+  TEST_CHECK(draws.buffers_created == 0);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  GfxContextDesc gfx_desc = {};
+  GfxContext* gfx         = gfx_context_init(gfx_desc);
+
+  batch_renderer_init(gfx);
+  GfxTexture* texture = create_texture(gfx);
+
+  gfx_context_set_recording(gfx, true);
+
+  // Has to go first, while only the first page exists
+  test_frame_pages(gfx);
+  test_textured_boundary(gfx, texture);
+  test_text_boundary(gfx, texture);
+
+  gfx_texture_destroy(texture);
+  batch_renderer_shutdown();
+  gfx_context_shutdown(gfx);
+
+  return test_report("batch_renderer_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,210 @@
+#include "test_common.hpp"
+
+#include "engine/renderer/clustered_lights.hpp"
+#include "engine/renderer/worker_pool.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <cmath>
+#include <random>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+const IVec2 VIEWPORT       = IVec2(1280, 720);
+const u32 INDEX_OFFSET     = 5;
+const sizei LIGHTS_COUNT   = 96;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static Camera create_camera() {
+  Camera cam = {};
+  cam.near   = 0.1f;
+  cam.far    = 100.0f;
+
+  cam.position        = Vec3(0.0f);
+  cam.view            = mat4_look_at(cam.position, Vec3(0.0f, 0.0f, -1.0f), Vec3(0.0f, 1.0f, 0.0f));
+  cam.projection      = mat4_perspective(0.9f, (f32)VIEWPORT.x / (f32)VIEWPORT.y, cam.near, cam.far);
+  cam.view_projection = cam.projection * cam.view;
+
+  return cam;
+}
+
+static bool get_cell(const Camera& cam, const Vec3& position, IVec3* cell) {
+  // The same mapping the shaders go through, starting from the fragment coordinates
+  Vec4 clip = cam.view_projection * Vec4(position, 1.0f);
+  if(clip.w <= cam.near) {
+    return false;
+  }
+
+  f32 ndc_x = clip.x / clip.w;
+  f32 ndc_y = clip.y / clip.w;
+  if(fabsf(ndc_x) >= 1.0f || fabsf(ndc_y) >= 1.0f || clip.w >= cam.far) {
+    return false;
+  }
+
+  f32 frag_x     = ((ndc_x * 0.5f) + 0.5f) * VIEWPORT.x;
+  f32 frag_y     = ((ndc_y * 0.5f) + 0.5f) * VIEWPORT.y;
+  f32 view_depth = -(cam.view * Vec4(position, 1.0f)).z;
+
+  Vec4 scale  = clustered_lights_get_scale();
+  IVec4 grid  = clustered_lights_get_grid();
+  
+  *cell = IVec3((i32)(frag_x * scale.x), (i32)(frag_y * scale.y), (i32)((logf(view_depth) * scale.z) + scale.w));
+  *cell = IVec3(clamp_int(cell->x, 0, grid.x - 1), clamp_int(cell->y, 0, grid.y - 1), clamp_int(cell->z, 0, grid.z - 1));
+
+  return true;
+}
+
+static bool has_light(const IVec3& cell, const u32 index) {
+  u32 count;
+  const u32* indices = clustered_lights_get_cluster(cell, &count);
+
+  for(u32 i = 0; i < count; i++) {
+    if(indices[i] == index) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static sizei count_light(const u32 index) {
+  IVec4 grid  = clustered_lights_get_grid();
+  sizei count = 0;
+
+  for(i32 z = 0; z < grid.z; z++) {
+    for(i32 y = 0; y < grid.y; y++) {
+      for(i32 x = 0; x < grid.x; x++) {
+        count += has_light(IVec3(x, y, z), index);
+      }
+    }
+  }
+
+  return count;
+}
+
+static DynamicArray<Light> create_lights() {
+  DynamicArray<Light> lights(LIGHTS_COUNT);
+
+  // Right in front of the camera
+  lights[0].position = Vec3(0.0f, 0.0f, -10.0f);
+  lights[0].radius   = 0.5f;
+
+  // Behind the camera
+  lights[1].position = Vec3(0.0f, 0.0f, 20.0f);
+  lights[1].radius   = 1.0f;
+
+  // Big enough to touch every cluster
+  lights[2].position = Vec3(0.0f, 0.0f, -50.0f);
+  lights[2].radius   = 1000.0f;
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<f32> side(-40.0f, 40.0f);
+  std::uniform_real_distribution<f32> depth(-90.0f, -1.0f);
+  std::uniform_real_distribution<f32> radius(0.1f, 4.0f);
+
+  for(sizei i = 3; i < LIGHTS_COUNT; i++) {
+    lights[i].position = Vec3(side(rng), side(rng), depth(rng));
+    lights[i].radius   = radius(rng);
+  }
+
+  return lights;
+}
+
+static void test_assignment(const Camera& cam, const DynamicArray<Light>& lights) {
+  IVec3 cell;
+
+  TEST_CHECK(get_cell(cam, lights[0].position, &cell));
+  TEST_CHECK(has_light(cell, INDEX_OFFSET + 0));
+
+  IVec4 grid = clustered_lights_get_grid();
+  TEST_CHECK(count_light(INDEX_OFFSET + 1) == 0);
+  TEST_CHECK(count_light(INDEX_OFFSET + 2) == (sizei)(grid.x * grid.y * grid.z));
+
+  // Every light has to at least be in the cluster its own center falls into
+  sizei missing_count = 0;
+  for(sizei i = 3; i < lights.size(); i++) {
+    if(get_cell(cam, lights[i].position, &cell)) {
+      missing_count += !has_light(cell, INDEX_OFFSET + (u32)i);
+    }
+  }
+  TEST_CHECK(missing_count == 0);
+}
+
+static void test_threads(const Camera& cam, const DynamicArray<Light>& lights) {
+  IVec4 grid = clustered_lights_get_grid();
+  
+  // Save the clusters built on a single thread
+  DynamicArray<u32> expected;
+  clustered_lights_build(cam, VIEWPORT, lights.data(), lights.size(), INDEX_OFFSET, 1);
+  
+  for(i32 z = 0; z < grid.z; z++) {
+    for(i32 y = 0; y < grid.y; y++) {
+      for(i32 x = 0; x < grid.x; x++) {
+        u32 count;
+        const u32* indices = clustered_lights_get_cluster(IVec3(x, y, z), &count);
+
+        expected.push_back(count);
+        expected.insert(expected.end(), indices, indices + count);
+      }
+    }
+  }
+
+  // The same clusters have to come out of the workers, in the same order
+  clustered_lights_build(cam, VIEWPORT, lights.data(), lights.size(), INDEX_OFFSET, 4);
+  
+  sizei offset = 0;
+  bool is_same = true;
+  
+  for(i32 z = 0; z < grid.z; z++) {
+    for(i32 y = 0; y < grid.y; y++) {
+      for(i32 x = 0; x < grid.x; x++) {
+        u32 count;
+        const u32* indices = clustered_lights_get_cluster(IVec3(x, y, z), &count);
+
+        is_same = is_same && (expected[offset++] == count);
+        for(u32 i = 0; i < count && is_same; i++) {
+          is_same = expected[offset++] == indices[i];
+        }
+      }
+    }
+  }
+
+  TEST_CHECK(is_same);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  worker_pool_init(4);
+
+  GfxContextDesc gfx_desc = {};
+  GfxContext* gfx         = gfx_context_init(gfx_desc);
+  clustered_lights_init(gfx);
+
+  Camera cam                 = create_camera();
+  DynamicArray<Light> lights = create_lights();
+
+  clustered_lights_build(cam, VIEWPORT, lights.data(), lights.size(), INDEX_OFFSET, 1);
+  test_assignment(cam, lights);
+  test_threads(cam, lights);
+
+  clustered_lights_shutdown();
+  gfx_context_shutdown(gfx);
+  worker_pool_shutdown();
+
+  return test_report("clustered_lights_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
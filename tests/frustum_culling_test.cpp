@@ -0,0 +1,152 @@
+#include "test_common.hpp"
+
+#include "engine/renderer/frustum_culling.hpp"
+#include "engine/renderer/worker_pool.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <cmath>
+#include <random>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void get_plane(const Mat4& view_projection, const sizei index, f32* plane) {
+  sizei row = index / 2;
+  f32 sign  = (index % 2) == 0 ? 1.0f : -1.0f;
+
+  for(sizei i = 0; i < 4; i++) {
+    plane[i] = view_projection[i][3] + (sign * view_projection[i][row]);
+  }
+}
+
+static bool reference_box(const Mat4& view_projection, const Vec3& center, const Vec3& extents) {
+  for(sizei i = 0; i < 6; i++) {
+    f32 plane[4];
+    get_plane(view_projection, i, plane);
+
+    // Summed up in the same order as the kernels, so the results match bit for bit
+    f32 dist   = (plane[0] * center.x) + plane[3];
+    dist      += plane[1] * center.y;
+    dist      += plane[2] * center.z;
+
+    f32 radius = fabsf(plane[0]) * extents.x;
+    radius    += fabsf(plane[1]) * extents.y;
+    radius    += fabsf(plane[2]) * extents.z;
+
+    if((dist + radius) < 0.0f) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool reference_sphere(const Mat4& view_projection, const Vec3& center, const f32 radius) {
+  for(sizei i = 0; i < 6; i++) {
+    f32 plane[4];
+    get_plane(view_projection, i, plane);
+
+    f32 length = sqrtf((plane[0] * plane[0]) + (plane[1] * plane[1]) + (plane[2] * plane[2]));
+    
+    f32 dist  = (plane[0] * center.x) + plane[3];
+    dist     += plane[1] * center.y;
+    dist     += plane[2] * center.z;
+
+    if((dist + (radius * length)) < 0.0f) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static Mat4 get_view_projection() {
+  Mat4 view       = mat4_look_at(Vec3(0.0f, 2.0f, 10.0f), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+  Mat4 projection = mat4_perspective(0.8f, 16.0f / 9.0f, 0.1f, 100.0f);
+
+  return projection * view;
+}
+
+static void test_known_bounds() {
+  Mat4 view_projection = get_view_projection();
+
+  CullBounds bounds;
+  cull_bounds_push(bounds, Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f));     // Right in front
+  cull_bounds_push(bounds, Vec3(0.0f, 0.0f, 30.0f), Vec3(1.0f));    // Behind the camera
+  cull_bounds_push(bounds, Vec3(500.0f, 0.0f, 0.0f), Vec3(1.0f));   // Far off to the side
+  cull_bounds_push(bounds, Vec3(0.0f, 0.0f, -200.0f), Vec3(1.0f));  // Past the far plane
+  cull_bounds_push(bounds, Vec3(0.0f, 0.0f, 30.0f), Vec3(25.0f));   // Behind, but big enough to reach in
+
+  frustum_cull(view_projection, bounds, 1);
+
+  TEST_CHECK(bounds.visible[0] == 1);
+  TEST_CHECK(bounds.visible[1] == 0);
+  TEST_CHECK(bounds.visible[2] == 0);
+  TEST_CHECK(bounds.visible[3] == 0);
+  TEST_CHECK(bounds.visible[4] == 1);
+}
+
+static void test_against_reference() {
+  Mat4 view_projection = get_view_projection();
+  
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<f32> position(-120.0f, 120.0f);
+  std::uniform_real_distribution<f32> extent(0.0f, 8.0f);
+
+  // Enough bounds to be split over the workers, with a count that does not fill the last lanes
+  const sizei counts[] = {1, 7, 4099, 20003};
+  const u32 threads[]  = {1, 4};
+
+  for(auto count : counts) {
+    for(auto threads_count : threads) {
+      CullBounds bounds;
+      CullSpheres spheres;
+
+      for(sizei i = 0; i < count; i++) {
+        Vec3 center(position(rng), position(rng), position(rng));
+        Vec3 extents(extent(rng), extent(rng), extent(rng));
+
+        cull_bounds_push(bounds, center, extents);
+        cull_spheres_push(spheres, center, extents.x);
+      }
+
+      frustum_cull(view_projection, bounds, threads_count);
+      frustum_cull_spheres(view_projection, spheres, threads_count);
+
+      sizei box_mismatches    = 0;
+      sizei sphere_mismatches = 0;
+
+      for(sizei i = 0; i < count; i++) {
+        Vec3 center(bounds.center_x[i], bounds.center_y[i], bounds.center_z[i]);
+        Vec3 extents(bounds.extent_x[i], bounds.extent_y[i], bounds.extent_z[i]);
+
+        box_mismatches    += reference_box(view_projection, center, extents) != (bool)bounds.visible[i];
+        sphere_mismatches += reference_sphere(view_projection, center, spheres.radius[i]) != (bool)spheres.visible[i];
+      }
+
+      TEST_CHECK(box_mismatches == 0);
+      TEST_CHECK(sphere_mismatches == 0);
+    }
+  }
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  worker_pool_init(4);
+
+  test_known_bounds();
+  test_against_reference();
+
+  worker_pool_shutdown();
+  return test_report("frustum_culling_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+#include "test_common.hpp"
+
+#include <nikola/nikola_core.hpp>
+
+#include <thread>
+#include <chrono>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+const sizei VALUES_COUNT = 1024;
+const u32 GROUP_SIZE     = 64;
+
+const sizei POLLS_MAX    = 5000;
+
+const i8* COMPUTE_SOURCE = R"(
+  #version 450 core
+
+  layout(local_size_x = 64) in;
+
+  layout(std430, binding = 0) readonly buffer Input {
+    uint values[];
+  };
+
+  layout(std430, binding = 1) writeonly buffer Output {
+    uint results[];
+  };
+
+  void main() {
+    uint index     = gl_GlobalInvocationID.x;
+    results[index] = values[index] * 2u + 1u;
+  }
+)";
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static GfxBuffer* create_storage_buffer(GfxContext* gfx, void* data, const GfxBufferUsage usage) {
+  GfxBufferDesc desc = {
+    .data  = data,
+    .size  = sizeof(u32) * VALUES_COUNT,
+    .type  = GFX_BUFFER_SHADER_STORAGE,
+    .usage = usage,
+  };
+
+  return gfx_buffer_create(gfx, desc);
+}
+
+static GfxComputePipeline* create_pipeline(GfxContext* gfx, GfxShader* shader, GfxBuffer* input, GfxBuffer* output) {
+  GfxComputePipelineDesc desc = {};
+  desc.shader                 = shader;
+  desc.storage_buffers[0]     = input;
+  desc.storage_buffers[1]     = output;
+  desc.storage_buffers_count  = 2;
+
+  return gfx_compute_pipeline_create(gfx, desc);
+}
+
+static void check_results(GfxContext* gfx, GfxBuffer* output, const u32* values) {
+  // The shader writes have to be visible to the copy into the readback
+  gfx_context_memory_barrier(gfx, GFX_MEMORY_BARRIER_BUFFER_UPDATE);
+
+  GfxReadback* readback = gfx_readback_create(gfx);
+  gfx_buffer_read_async(output, readback);
+
+  TEST_CHECK(gfx_readback_get_desc(readback).size == (sizeof(u32) * VALUES_COUNT));
+
+  // Software drivers can take a while, so keep polling for a bit
+  u32 results[VALUES_COUNT] = {};
+  bool is_done              = false;
+
+  for(sizei i = 0; i < POLLS_MAX && !is_done; i++) {
+    is_done = gfx_readback_poll(readback, results);
+
+    if(!is_done) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  TEST_CHECK(is_done);
+  gfx_readback_destroy(readback);
+
+  sizei mismatch_count = 0;
+  for(sizei i = 0; i < VALUES_COUNT; i++) {
+    mismatch_count += (results[i] != (values[i] * 2 + 1));
+  }
+
+  TEST_CHECK(mismatch_count == 0);
+}
+
+static void test_dispatch(GfxContext* gfx, GfxShader* shader, u32* values) {
+  GfxBuffer* input  = create_storage_buffer(gfx, values, GFX_BUFFER_USAGE_STATIC_DRAW);
+  GfxBuffer* output = create_storage_buffer(gfx, nullptr, GFX_BUFFER_USAGE_DYNAMIC_READ);
+
+  GfxComputePipeline* pipeline = create_pipeline(gfx, shader, input, output);
+
+  gfx_compute_dispatch(pipeline, VALUES_COUNT / GROUP_SIZE);
+  check_results(gfx, output, values);
+
+  // The same pipeline again should not rebind the program or any of the storage buffers
+  u64 saved_calls = gfx_context_get_saved_calls(gfx);
+  gfx_compute_dispatch(pipeline, VALUES_COUNT / GROUP_SIZE);
+  TEST_CHECK((gfx_context_get_saved_calls(gfx) - saved_calls) >= 3);
+
+  check_results(gfx, output, values);
+
+  // Destroying a buffer clears its cached binding, so a new
+  // buffer in the same slot has to be bound all over again
+  gfx_compute_pipeline_destroy(pipeline);
+  gfx_buffer_destroy(output);
+
+  output   = create_storage_buffer(gfx, nullptr, GFX_BUFFER_USAGE_DYNAMIC_READ);
+  pipeline = create_pipeline(gfx, shader, input, output);
+
+  gfx_compute_dispatch(pipeline, VALUES_COUNT / GROUP_SIZE);
+  check_results(gfx, output, values);
+
+  gfx_compute_pipeline_destroy(pipeline);
+  gfx_buffer_destroy(output);
+  gfx_buffer_destroy(input);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  nikola::init();
+
+  // Machines without a display or an OpenGL 4.6 driver cannot run this test
+  Window* window = window_open("gl_compute_test", 64, 64, WINDOW_FLAGS_GFX_HARDWARE | WINDOW_FLAGS_HIDDEN);
+  if(!window) {
+    NIKOLA_LOG_WARN("gl_compute_test: Could not open a window. Skipping...");
+    return TEST_SKIPPED;
+  }
+
+  GfxContextDesc gfx_desc = {.window = window};
+  GfxContext* gfx         = gfx_context_init(gfx_desc);
+  if(!gfx) {
+    NIKOLA_LOG_WARN("gl_compute_test: Could not create an OpenGL context. Skipping...");
+
+    window_close(window);
+    return TEST_SKIPPED;
+  }
+
+  u32 values[VALUES_COUNT];
+  for(sizei i = 0; i < VALUES_COUNT; i++) {
+    values[i] = (u32)(i * 7 + 3);
+  }
+
+  GfxShaderDesc shader_desc = {.compute_source = COMPUTE_SOURCE};
+  GfxShader* shader         = gfx_shader_create(gfx, shader_desc);
+
+  test_dispatch(gfx, shader, values);
+
+  gfx_shader_destroy(shader);
+  gfx_context_shutdown(gfx);
+  window_close(window);
+  nikola::shutdown();
+
+  return test_report("gl_compute_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
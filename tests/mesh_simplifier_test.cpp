@@ -0,0 +1,235 @@
+#include "test_common.hpp"
+
+#include "nbr.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// Consts
+
+/// Position, normal, and texture coordinates.
+const sizei VERTEX_STRIDE = 8;
+
+/// Consts
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// TestMesh
+struct TestMesh {
+  DynamicArray<f32> vertices;
+  DynamicArray<u32> indices;
+};
+/// TestMesh
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void push_vertex(TestMesh& mesh, const f32 x, const f32 y, const f32 z) {
+  f32 vertex[VERTEX_STRIDE] = {x, y, z, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + VERTEX_STRIDE);
+}
+
+static void push_triangle(TestMesh& mesh, const u32 a, const u32 b, const u32 c) {
+  mesh.indices.push_back(a);
+  mesh.indices.push_back(b);
+  mesh.indices.push_back(c);
+}
+
+static TestMesh create_sphere(const u32 rings, const u32 sectors) {
+  TestMesh mesh;
+
+  // A closed sphere with every position shared, so there are no seams or borders anywhere
+  push_vertex(mesh, 0.0f, 1.0f, 0.0f);
+  for(u32 r = 1; r < rings; r++) {
+    for(u32 s = 0; s < sectors; s++) {
+      f32 theta = (PI * r) / rings;
+      f32 phi   = (2.0f * PI * s) / sectors;
+
+      push_vertex(mesh, sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+    }
+  }
+  push_vertex(mesh, 0.0f, -1.0f, 0.0f);
+
+  u32 bottom    = (u32)(mesh.vertices.size() / VERTEX_STRIDE) - 1;
+  auto ring_vtx = [&](const u32 r, const u32 s) { return 1 + ((r - 1) * sectors) + (s % sectors); };
+
+  for(u32 s = 0; s < sectors; s++) {
+    push_triangle(mesh, 0, ring_vtx(1, s + 1), ring_vtx(1, s));
+    push_triangle(mesh, bottom, ring_vtx(rings - 1, s), ring_vtx(rings - 1, s + 1));
+  }
+
+  for(u32 r = 1; r < (rings - 1); r++) {
+    for(u32 s = 0; s < sectors; s++) {
+      push_triangle(mesh, ring_vtx(r, s), ring_vtx(r, s + 1), ring_vtx(r + 1, s));
+      push_triangle(mesh, ring_vtx(r, s + 1), ring_vtx(r + 1, s + 1), ring_vtx(r + 1, s));
+    }
+  }
+
+  return mesh;
+}
+
+static TestMesh create_grid(const u32 size) {
+  TestMesh mesh;
+
+  for(u32 y = 0; y <= size; y++) {
+    for(u32 x = 0; x <= size; x++) {
+      push_vertex(mesh, (f32)x, (f32)y, 0.0f);
+    }
+  }
+
+  for(u32 y = 0; y < size; y++) {
+    for(u32 x = 0; x < size; x++) {
+      u32 a = (y * (size + 1)) + x;
+      u32 c = a + size + 1;
+
+      push_triangle(mesh, a, a + 1, c);
+      push_triangle(mesh, a + 1, c + 1, c);
+    }
+  }
+
+  return mesh;
+}
+
+static const f32* get_position(const TestMesh& mesh, const u32 index) {
+  return &mesh.vertices[index * VERTEX_STRIDE];
+}
+
+static bool is_closed_manifold(const DynamicArray<u32>& indices) {
+  // Every directed edge of a closed and consistently wound mesh shows up exactly once, and so does its twin
+  HashMap<u64, i32> edges;
+  for(sizei i = 0; i < indices.size(); i += 3) {
+    for(sizei j = 0; j < 3; j++) {
+      u64 from = indices[i + j];
+      u64 to   = indices[i + ((j + 1) % 3)];
+
+      edges[(from << 32) | to]++;
+    }
+  }
+
+  for(auto& [edge, count] : edges) {
+    u64 twin = (edge << 32) | (edge >> 32);
+    if(count != 1 || edges.find(twin) == edges.end()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void test_sphere() {
+  TestMesh mesh = create_sphere(32, 64);
+  
+  sizei vertices_count  = mesh.vertices.size() / VERTEX_STRIDE;
+  sizei triangles_count = mesh.indices.size() / 3;
+  
+  const f32 ratios[] = {0.5f, 0.25f, 0.125f};
+  for(auto ratio : ratios) {
+    DynamicArray<u32> out_indices;
+    TEST_CHECK(nbr::mesh_simplifier_simplify(mesh.vertices.data(), 
+                                             vertices_count, 
+                                             VERTEX_STRIDE, 
+                                             mesh.indices.data(), 
+                                             mesh.indices.size(), 
+                                             ratio, 
+                                             out_indices));
+
+    // Nothing blocks the sphere from collapsing, so the target should be reached
+    sizei target_count = (sizei)(triangles_count * ratio);
+    TEST_CHECK((out_indices.size() % 3) == 0);
+    TEST_CHECK((out_indices.size() / 3) <= target_count);
+    TEST_CHECK((out_indices.size() / 3) >= (target_count / 2));
+
+    // No degenerate triangles and no indices outside of the vertices
+    bool is_valid = true;
+    for(sizei i = 0; i < out_indices.size(); i += 3) {
+      u32 a = out_indices[i + 0], b = out_indices[i + 1], c = out_indices[i + 2];
+      is_valid = is_valid && (a != b) && (b != c) && (a != c) && (a < vertices_count) && (b < vertices_count) && (c < vertices_count);
+    }
+    TEST_CHECK(is_valid);
+
+    // The collapses keep the surface closed and stay close to the original shape 
+    TEST_CHECK(is_closed_manifold(out_indices));
+
+    f32 deviation = 0.0f;
+    for(sizei i = 0; i < out_indices.size(); i += 3) {
+      f32 center[3] = {0.0f, 0.0f, 0.0f};
+      for(sizei j = 0; j < 3; j++) {
+        const f32* position = get_position(mesh, out_indices[i + j]);
+        
+        center[0] += position[0] / 3.0f;
+        center[1] += position[1] / 3.0f;
+        center[2] += position[2] / 3.0f;
+      }
+
+      f32 length = sqrtf((center[0] * center[0]) + (center[1] * center[1]) + (center[2] * center[2]));
+      deviation  = fmaxf(deviation, 1.0f - length);
+    }
+    TEST_CHECK(deviation < 0.1f);
+  }
+}
+
+static void test_grid() {
+  TestMesh mesh = create_grid(16);
+  
+  DynamicArray<u32> out_indices;
+  TEST_CHECK(nbr::mesh_simplifier_simplify(mesh.vertices.data(), 
+                                           mesh.vertices.size() / VERTEX_STRIDE, 
+                                           VERTEX_STRIDE, 
+                                           mesh.indices.data(), 
+                                           mesh.indices.size(), 
+                                           0.25f, 
+                                           out_indices));
+
+  TEST_CHECK((out_indices.size() / 3) < (mesh.indices.size() / 3));
+
+  // The border is locked, so the grid has to cover the exact same area without flipping anything
+  f32 area         = 0.0f;
+  bool has_flipped = false;
+
+  for(sizei i = 0; i < out_indices.size(); i += 3) {
+    const f32* p0 = get_position(mesh, out_indices[i + 0]);
+    const f32* p1 = get_position(mesh, out_indices[i + 1]);
+    const f32* p2 = get_position(mesh, out_indices[i + 2]);
+
+    f32 signed_area = (((p1[0] - p0[0]) * (p2[1] - p0[1])) - ((p1[1] - p0[1]) * (p2[0] - p0[0]))) * 0.5f;
+    has_flipped     = has_flipped || (signed_area <= 0.0f);
+    area           += signed_area;
+  }
+
+  TEST_CHECK(!has_flipped);
+  TEST_CHECK(fabsf(area - (16.0f * 16.0f)) < 0.001f);
+}
+
+static void test_nothing_to_simplify() {
+  TestMesh mesh;
+  push_vertex(mesh, 0.0f, 0.0f, 0.0f);
+  push_vertex(mesh, 1.0f, 0.0f, 0.0f);
+  push_vertex(mesh, 0.0f, 1.0f, 0.0f);
+  push_triangle(mesh, 0, 1, 2);
+
+  // A single triangle is all border, so it gets handed back as is
+  DynamicArray<u32> out_indices;
+  TEST_CHECK(!nbr::mesh_simplifier_simplify(mesh.vertices.data(), 3, VERTEX_STRIDE, mesh.indices.data(), 3, 0.5f, out_indices));
+  TEST_CHECK(out_indices == mesh.indices);
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  test_sphere();
+  test_grid();
+  test_nothing_to_simplify();
+
+  return test_report("mesh_simplifier_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
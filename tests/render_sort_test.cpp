@@ -0,0 +1,190 @@
+#include "test_common.hpp"
+
+#include "engine/renderer/render_sort.hpp"
+
+#include <nikola/nikola_core.hpp>
+#include <nikola/nikola_engine.hpp>
+
+#include <algorithm>
+#include <random>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// DrawQueue
+struct DrawQueue {
+  /// The draw of each sorted item. Items of the same draw can be instanced together.
+  DynamicArray<u32> draws;
+
+  /// Whether the shader of each draw declares the instance attributes.
+  bool is_instanceable[3];
+};
+/// DrawQueue
+/// ----------------------------------------------------------------------
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static bool can_merge_draws(void* user_data, const u32 first, const u32 other) {
+  DrawQueue* queue = (DrawQueue*)user_data;
+  u32 draw         = queue->draws[first];
+
+  return draw == queue->draws[other] && queue->is_instanceable[draw];
+}
+
+static void test_pass_order() {
+  SortKeyDesc opaque = {
+    .depth    = 0.9f,
+    .shader   = 0xffff, 
+    .material = 0xffff, 
+    .mesh     = 0xffff,
+  };
+
+  SortKeyDesc skybox = {
+    .is_skybox = true,
+  };
+
+  SortKeyDesc transparent = {
+    .depth          = 0.0f,
+    .is_transparent = true,
+  };
+
+  // Opaque commands first, then the skybox, then transparent ones, no matter the rest of the key 
+  TEST_CHECK(sort_key_build(opaque) < sort_key_build(skybox));
+  TEST_CHECK(sort_key_build(skybox) < sort_key_build(transparent));
+}
+
+static void test_opaque_order() {
+  SortKeyDesc near = {
+    .depth    = 0.1f,
+    .shader   = 1, 
+    .material = 2, 
+    .mesh     = 3,
+  };
+
+  SortKeyDesc far = near;
+  far.depth       = 0.8f;
+
+  // The same state sorts front to back
+  TEST_CHECK(sort_key_build(near) < sort_key_build(far));
+
+  // The state always comes before the depth
+  SortKeyDesc other_mesh = far;
+  other_mesh.mesh        = 4;
+  
+  u64 near_key  = sort_key_build(near);
+  u64 other_key = sort_key_build(other_mesh);
+  TEST_CHECK((near_key >> 24) != (other_key >> 24));
+  TEST_CHECK((near_key >> 24) == (sort_key_build(far) >> 24));
+
+  // Depths outside the camera range are clamped
+  SortKeyDesc behind = near;
+  behind.depth       = -5.0f;
+  
+  SortKeyDesc front = near;
+  front.depth       = 0.0f;
+  TEST_CHECK(sort_key_build(behind) == sort_key_build(front));
+}
+
+static void test_transparent_order() {
+  SortKeyDesc near = {
+    .depth          = 0.1f,
+    .shader         = 7, 
+    .is_transparent = true,
+  };
+
+  SortKeyDesc far = near;
+  far.depth       = 0.8f;
+  far.shader      = 1;
+
+  // Back to front, no matter the state
+  TEST_CHECK(sort_key_build(far) < sort_key_build(near));
+}
+
+static void test_radix_sort() {
+  std::mt19937_64 rng(1234);
+  
+  DynamicArray<SortItem> items, scratch, expected;
+
+  // Nothing to sort should be fine as well
+  sort_items_radix(items, scratch);
+  TEST_CHECK(items.empty());
+
+  const sizei counts[] = {1, 2, 255, 4096, 10000};
+  for(auto count : counts) {
+    items.resize(count);
+
+    // Plenty of repeated keys, so the stability of the sort gets tested as well
+    for(sizei i = 0; i < count; i++) {
+      u64 key  = rng();
+      items[i] = SortItem{(i % 3) == 0 ? (key & 0xff00ff) : key, (u32)i};
+    }
+
+    expected = items;
+    std::stable_sort(expected.begin(), expected.end(), [](const SortItem& a, const SortItem& b) {
+      return a.key < b.key;
+    });
+
+    sort_items_radix(items, scratch);
+    
+    bool is_same = true;
+    for(sizei i = 0; i < count; i++) {
+      is_same = is_same && (items[i].key == expected[i].key) && (items[i].index == expected[i].index);
+    }
+    TEST_CHECK(is_same);
+  }
+
+  // Keys that only differ in the top byte
+  items = {SortItem{3ull << 56, 0}, SortItem{1ull << 56, 1}, SortItem{2ull << 56, 2}};
+  sort_items_radix(items, scratch);
+  TEST_CHECK(items[0].index == 1 && items[1].index == 2 && items[2].index == 0);
+}
+
+static void test_draw_runs() {
+  DrawQueue queue = {
+    .draws           = {0, 0, 0, 1, 1, 2, 2, 2},
+    .is_instanceable = {true, false, true},
+  };
+
+  // Runs of the same instanceable draw get merged, while the rest get a draw per command
+  DynamicArray<DrawRun> runs;
+  draw_runs_build(runs, 0, queue.draws.size(), can_merge_draws, &queue);
+
+  TEST_CHECK(runs.size() == 4);
+  TEST_CHECK(runs[0].first == 0 && runs[0].count == 3);
+  TEST_CHECK(runs[1].first == 3 && runs[1].count == 1);
+  TEST_CHECK(runs[2].first == 4 && runs[2].count == 1);
+  TEST_CHECK(runs[3].first == 5 && runs[3].count == 3);
+
+  // A run never crosses the end of its range, even if the next command is the same draw
+  runs.clear();
+  draw_runs_build(runs, 0, 2, can_merge_draws, &queue);
+  draw_runs_build(runs, 2, queue.draws.size(), can_merge_draws, &queue);
+
+  TEST_CHECK(runs.size() == 5);
+  TEST_CHECK(runs[0].first == 0 && runs[0].count == 2);
+  TEST_CHECK(runs[1].first == 2 && runs[1].count == 1);
+  TEST_CHECK(runs[4].first == 5 && runs[4].count == 3);
+
+  // Nothing to build should be fine as well
+  runs.clear();
+  draw_runs_build(runs, 3, 3, can_merge_draws, &queue);
+  TEST_CHECK(runs.empty());
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  test_pass_order();
+  test_opaque_order();
+  test_transparent_order();
+  test_radix_sort();
+  test_draw_runs();
+
+  return test_report("render_sort_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
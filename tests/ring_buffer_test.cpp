@@ -0,0 +1,98 @@
+#include "test_common.hpp"
+
+#include "core/gfx/ring_buffer.hpp"
+
+#include <nikola/nikola_core.hpp>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace nikola;
+
+/// ----------------------------------------------------------------------
+/// Private functions
+
+static void test_stride() {
+  RingPartitions ring;
+
+  // Every partition has to start at an aligned offset
+  ring_partitions_init(ring, 100, 256);
+  TEST_CHECK(ring.stride == 256);
+
+  ring_partitions_init(ring, 256, 256);
+  TEST_CHECK(ring.stride == 256);
+  
+  ring_partitions_init(ring, 257, 64);
+  TEST_CHECK(ring.stride == 320);
+
+  TEST_CHECK(ring_partitions_get_offset(ring) == 0);
+}
+
+static void test_advance() {
+  RingPartitions ring;
+  ring_partitions_init(ring, 64, 256);
+
+  // Writes within the same frame stay on the same partition
+  sizei wait_frame = 0;
+  TEST_CHECK(!ring_partitions_advance(ring, 0, &wait_frame));
+  TEST_CHECK(!ring_partitions_advance(ring, 0, &wait_frame));
+  TEST_CHECK(ring_partitions_get_offset(ring) == 0);
+
+  // Every new frame moves on to the next partition, wrapping back to the first one
+  for(sizei frame = 1; frame <= (RING_BUFFER_FRAMES * 4); frame++) {
+    TEST_CHECK(ring_partitions_advance(ring, frame, &wait_frame));
+    TEST_CHECK(!ring_partitions_advance(ring, frame, &wait_frame));
+
+    sizei partition = frame % RING_BUFFER_FRAMES;
+    TEST_CHECK(ring_partitions_get_offset(ring) == (partition * ring.stride));
+  }
+}
+
+static void test_wait_frames() {
+  RingPartitions ring;
+  ring_partitions_init(ring, 64, 256);
+
+  // The last frame that could have read each partition, tracked separately from the ring
+  sizei last_read[RING_BUFFER_FRAMES] = {};
+  sizei current = 0;
+
+  // Only write every so often, so partitions stay current for a varying amount of frames
+  for(sizei frame = 1; frame < 64; frame++) {
+    if((frame % 3) == 2 || (frame % 5) == 0) {
+      continue;
+    }
+
+    sizei wait_frame = 0;
+    TEST_CHECK(ring_partitions_advance(ring, frame, &wait_frame));
+
+    last_read[current] = frame;
+    current            = (current + 1) % RING_BUFFER_FRAMES;
+
+    // The write has to wait for exactly the last frame that read the new partition
+    TEST_CHECK(wait_frame == last_read[current]);
+    TEST_CHECK(ring_partitions_get_offset(ring) == (current * ring.stride));
+  }
+}
+
+static void test_retired_frames() {
+  // Only the frames older than the ones in flight are done
+  TEST_CHECK(ring_frame_is_retired(0, RING_BUFFER_FRAMES));
+  TEST_CHECK(ring_frame_is_retired(4, 4 + RING_BUFFER_FRAMES + 1));
+  
+  TEST_CHECK(!ring_frame_is_retired(0, RING_BUFFER_FRAMES - 1));
+  TEST_CHECK(!ring_frame_is_retired(10, 10));
+  TEST_CHECK(!ring_frame_is_retired(10, 11));
+}
+
+/// Private functions
+/// ----------------------------------------------------------------------
+
+int main() {
+  test_stride();
+  test_advance();
+  test_wait_frames();
+  test_retired_frames();
+
+  return test_report("ring_buffer_test");
+}
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "nikola/nikola_core.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+
+/// ----------------------------------------------------------------------
+/// Macros
+
+/// Check `expr` and log it as a failure if it does not hold, without stopping the test.
+#define TEST_CHECK(expr)                                                  \
+        {                                                                 \
+          if(!(expr)) {                                                   \
+            NIKOLA_LOG_ERROR("%s:%i: Check failed: %s", __FILE__, __LINE__, #expr); \
+            nikola::g_test_failures++;                                    \
+          }                                                               \
+        }
+
+/// Macros
+/// ----------------------------------------------------------------------
+
+namespace nikola { // Start of nikola
+
+/// The exit code of a test that could not run on the current machine. 
+/// CTest reports it as skipped instead of failed.
+const int TEST_SKIPPED = 77;
+
+/// The amount of failed checks so far in the current test.
+inline sizei g_test_failures = 0;
+
+/// Log the result of the test called `name` and return its exit code.
+inline int test_report(const i8* name) {
+  if(g_test_failures > 0) {
+    NIKOLA_LOG_ERROR("%s: %zu checks failed", name, g_test_failures);
+    return 1;
+  }
+
+  NIKOLA_LOG_INFO("%s: All checks passed", name);
+  return 0;
+}
+
+} // End of nikola
+
+//////////////////////////////////////////////////////////////////////////